@@ -10,6 +10,7 @@
 #include "fence_int.h"
 #include "kernel_int.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/debug.h"
 #include "core/common/device.h"
 #include "core/common/thread.h"
@@ -21,8 +22,11 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cassert>
+#include <cstddef>
 #include <chrono>
 #include <condition_variable>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -79,11 +83,114 @@ notify_host(xrt_core::command* cmd)
   notify_host(cmd, get_command_state(cmd));
 }
 
+// class submission_ring - bounded lock-free multi-producer ring
+//
+// @m_slots: Ring storage, capacity is a power of 2
+// @m_head: Next slot to be claimed by a producer
+// @m_tail: Next slot to be consumed, owned by the single consumer
+//
+// Commands launched for managed execution are pushed to this ring by
+// any number of submitting threads and drained by the one monitor
+// thread owning the ring.  Each slot carries a sequence number that
+// tells producers and consumer if the slot is free or filled.
+// Producers claim a slot with a CAS on m_head, the consumer owns
+// m_tail exclusively, so drain is wait-free.
+class submission_ring
+{
+  static constexpr size_t capacity = 4096;
+  static constexpr size_t mask = capacity - 1;
+  static_assert((capacity & mask) == 0, "capacity must be a power of 2");
+
+  struct slot
+  {
+    std::atomic<size_t> sequence;
+    xrt_core::command* cmd;
+  };
+
+  std::unique_ptr<slot[]> m_slots;
+  alignas(64) std::atomic<size_t> m_head {0};
+  alignas(64) size_t m_tail {0};
+
+public:
+  submission_ring()
+    : m_slots(std::make_unique<slot[]>(capacity))
+  {
+    for (size_t idx = 0; idx < capacity; ++idx)
+      m_slots[idx].sequence.store(idx, std::memory_order_relaxed);
+  }
+
+  // push() - Add a command to the ring, called by any thread
+  //
+  // Returns false if the ring is full, in which case the
+  // caller should retry after the consumer has made progress.
+  bool
+  push(xrt_core::command* cmd)
+  {
+    auto pos = m_head.load(std::memory_order_relaxed);
+    while (true) {
+      auto& s = m_slots[pos & mask];
+      auto seq = s.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        // seq_cst such that the claim is ordered with the load of
+        // the monitor idle state in command_manager::wake_monitor()
+        if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          s.cmd = cmd;
+          s.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+        return false; // full
+      else
+        pos = m_head.load(std::memory_order_relaxed);
+    }
+  }
+
+  // drain() - Move all published commands to argument vector
+  //
+  // Called only by the consumer thread.  Commands are appended in
+  // the order in which slots were claimed.
+  size_t
+  drain(std::vector<xrt_core::command*>& out)
+  {
+    size_t count = 0;
+    while (true) {
+      auto& s = m_slots[m_tail & mask];
+      if (s.sequence.load(std::memory_order_acquire) != m_tail + 1)
+        return count;
+      out.push_back(s.cmd);
+      s.sequence.store(m_tail + capacity, std::memory_order_release);
+      ++m_tail;
+      ++count;
+    }
+  }
+
+  // empty() - Check if any commands are published or being published
+  //
+  // A slot claimed by a producer that has not yet been published
+  // counts as non-empty, so the consumer will not go to sleep while a
+  // producer is in the middle of push().
+  bool
+  empty() const
+  {
+    return m_head.load(std::memory_order_seq_cst) == m_tail;
+  }
+};
+
 // class command_manager - managed command executuon
 //
-// @m_qimpl: The hw queue used for command submission
-// @work_mutex: Syncrhonize monitor thread with launched commands
-// @work_cond: Kick off monitor thread when there are new commands
+// @m_impl: The hw queue used for command submission
+// @m_ring: Lock-free ring of launched commands not yet monitored
+// @m_idle_mutex: Synchronize monitor thread sleep with launch()
+// @m_idle_cond: Kick off monitor thread when there are new commands
+// @m_idle: Monitor thread is sleeping or about to sleep
+// @m_abort_mutex: Synchronize commands that failed submission
+// @m_abort_cond: Notify launching threads that aborted commands are purged
+// @m_aborted: Commands that failed submission after being queued
+// @m_abort_requests: Count of commands recorded as aborted
+// @m_abort_purged: Value of m_abort_requests at last purge
+// @m_monitor_exited: Monitor thread is no longer running
 // @monitor_thread: Thread for asynchronous monitoring of command execution
 // @stop: Stop the monitor thread
 //
@@ -93,6 +200,11 @@ notify_host(xrt_core::command* cmd)
 // completion.  This is the OpenCL model but is also supported by
 // native XRT APIs.
 //
+// Launching a command is lock-free in the common case.  The command
+// is pushed to a multi-producer / single-consumer ring that is
+// drained by the monitor thread.  The idle mutex is taken by a
+// launching thread only when the monitor thread is asleep.
+//
 // The command manager requires submission and wait APIs to be implemented
 // by which ever object (hw queue) uses the manager.
 class command_manager
@@ -112,18 +224,89 @@ public:
 
     virtual void
     submit(xrt_core::command* cmd) = 0;
+
+    virtual void
+    submit(const command_queue_type& cmds, size_t& submitted) = 0;
   };
 
 private:
+  // Upper bound on how long the monitor waits in the device before
+  // checking for commands that failed submission
+  static constexpr size_t monitor_poll_ms = 1000;
+
   executor* m_impl;
-  std::mutex work_mutex;
-  std::condition_variable work_cond;
-  command_queue_type submitted_cmds;
-  bool stop = false;
+  submission_ring m_ring;
+  std::mutex m_idle_mutex;
+  std::condition_variable m_idle_cond;
+  std::atomic<bool> m_idle {false};
+  std::mutex m_abort_mutex;
+  std::condition_variable m_abort_cond;
+  command_queue_type m_aborted;
+  uint64_t m_abort_requests {0};
+  uint64_t m_abort_purged {0};
+  bool m_monitor_exited {false};
+  std::atomic<bool> m_has_aborted {false};
+  std::atomic<bool> stop {false};
 
   // thread can be constructed only after data members are initialized
   std::thread monitor_thread;
 
+  // Wait for work, returns false if monitor should stop
+  bool
+  wait_for_work()
+  {
+    std::unique_lock lk(m_idle_mutex);
+    m_idle.store(true);  // seq_cst, see launch()
+    while (!stop && m_ring.empty())
+      m_idle_cond.wait(lk);
+    m_idle.store(false, std::memory_order_relaxed);
+    return !stop;
+  }
+
+  // Remove commands that failed submission from running commands
+  // and release the threads waiting in abort() for the purge.
+  void
+  purge_aborted(command_queue_type& running_cmds)
+  {
+    {
+      std::lock_guard lk(m_abort_mutex);
+      for (auto cmd : m_aborted) {
+        auto itr = std::find(running_cmds.begin(), running_cmds.end(), cmd);
+        if (itr != running_cmds.end())
+          running_cmds.erase(itr);
+      }
+      m_aborted.clear();
+      m_has_aborted = false;
+      m_abort_purged = m_abort_requests;
+    }
+    m_abort_cond.notify_all();
+  }
+
+  // Stop tracking commands that failed submission.
+  //
+  // The commands are published to the monitor thread, but the
+  // caller owns them and may delete them as soon as the failed
+  // launch returns.  Block until the monitor has dropped all
+  // references.  The monitor polls the device with a bounded
+  // timeout, so it gets to the purge even if the aborted commands
+  // are the only ones it is tracking.
+  template <typename Iterator>
+  void
+  abort(Iterator first, Iterator last)
+  {
+    std::unique_lock lk(m_abort_mutex);
+    m_aborted.insert(m_aborted.end(), first, last);
+    m_abort_requests += std::distance(first, last);
+    auto ticket = m_abort_requests;
+    m_has_aborted.store(true, std::memory_order_release);
+    lk.unlock();
+
+    wake_monitor();
+
+    lk.lock();
+    m_abort_cond.wait(lk, [this, ticket] { return m_monitor_exited || m_abort_purged >= ticket; });
+  }
+
   // monitor_loop() - Manage running commands and notify on completion
   //
   // The monitor thread services managed command and asynchronously
@@ -134,57 +317,61 @@ private:
   void
   monitor_loop()
   {
-    std::vector<xrt_core::command*> busy_cmds;
-    std::vector<xrt_core::command*> running_cmds;
+    command_queue_type running_cmds;
 
     while (true) {
 
       // Larger wait synchronized with launch()
-      {
-        std::unique_lock<std::mutex> lk(work_mutex);
-        while (!stop && running_cmds.empty() && submitted_cmds.empty())
-          work_cond.wait(lk);
-      }
+      if (running_cmds.empty() && m_ring.empty() && !wait_for_work())
+        return;
 
       if (stop)
         return;
 
-      // Finer wait
-      m_impl->wait(0);
-
-      // Drain submitted commands.  It is important that this comes
-      // after exec_wait and is synchronized with launch() that added
-      // to submitted_cmds.
+      // Pick up new commands before waiting.  If every pending
+      // command failed submission there is nothing to wait for.
+      m_ring.drain(running_cmds);
+      if (m_has_aborted.load(std::memory_order_acquire))
+        purge_aborted(running_cmds);
+      if (running_cmds.empty())
+        continue;
+
+      // Finer wait.  The wait is bounded such that commands that
+      // failed submission are purged even if the device has no
+      // completions to report.
+      m_impl->wait(monitor_poll_ms);
+
+      // Drain submitted commands again.  It is important that this
+      // comes after exec_wait.
       //
-      // Scenario if before exec_wait is that a new command was added
-      // to submitted_cmds and exec_buf immediately after the critical
-      // section above and that the command completion happens in the
-      // exec_wait call. If submitted_cmds was drained, in for example
-      // above critical section, before the call to exec_wait it would
-      // not be in running_cmds and would not be notified of
+      // Scenario if before exec_wait is that a new command was pushed
+      // to the ring and exec_buf immediately after the drain and that
+      // the command completion happens in the exec_wait call. If the
+      // ring was drained before the call to exec_wait the command
+      // would not be in running_cmds and would not be notified of
       // completion.
       //
       // The sequence is very important.  It must be guaranteed that
       // exec_wait will never return for a command that is not yet
-      // in either running_cmds or submitted_cmds.
-      {
-        std::lock_guard<std::mutex> lk(work_mutex);
-        std::copy(submitted_cmds.begin(), submitted_cmds.end(), std::back_inserter(running_cmds));
-        submitted_cmds.clear();
-      }
+      // in either running_cmds or the ring.  launch() guarantees this
+      // by publishing the command to the ring before exec_buf.
+      m_ring.drain(running_cmds);
+      if (m_has_aborted.load(std::memory_order_acquire))
+        purge_aborted(running_cmds);
+
       // At this point running_cmds is guaranteed to contain the
       // command(s) for which exec_wait returned.
 
-      // Preserve order of processing
+      // Notify completed commands and compact the still running
+      // commands in place, preserving order of processing.
+      auto busy = running_cmds.begin();
       for (auto cmd : running_cmds) {
         if (completed(cmd))
           notify_host(cmd);
         else
-          busy_cmds.push_back(cmd);
+          *busy++ = cmd;
       }
-
-      running_cmds.swap(busy_cmds);
-      busy_cmds.clear();
+      running_cmds.erase(busy, running_cmds.end());
     } // while (1)
   }
 
@@ -204,6 +391,31 @@ private:
       xrt_core::send_exception_message("kds command monitor died unexpectedly");
       s_exception = std::current_exception();
     }
+
+    // Release threads waiting for aborted commands to be purged,
+    // the monitor no longer references any commands.
+    {
+      std::lock_guard lk(m_abort_mutex);
+      m_monitor_exited = true;
+    }
+    m_abort_cond.notify_all();
+  }
+
+  // Wake up monitor thread if it is sleeping
+  void
+  wake_monitor()
+  {
+    // The ring push is sequentially consistent with the load of
+    // m_idle and with the store of m_idle in wait_for_work.  Either
+    // this thread sees the monitor idle and notifies it under the
+    // lock, or the monitor sees the pushed command before it sleeps.
+    // The fence orders the load after all prior writes of this
+    // thread, also when called without a preceding push.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_idle.load()) {
+      std::lock_guard lk(m_idle_mutex);
+      m_idle_cond.notify_one();
+    }
   }
 
 public:
@@ -220,11 +432,10 @@ public:
     XRT_DEBUGF("command_manager::~command_manager() executor(0x%x)\n", m_impl);
     {
       // Modify stop while keeping the lock so that the multi
-      // conditional wait in monitor_loop is atomic.  E.g., a
-      // std::atomic stop is not sufficient.
-      std::lock_guard lk(work_mutex);
+      // conditional wait in wait_for_work is atomic.
+      std::lock_guard lk(m_idle_mutex);
       stop = true;
-      work_cond.notify_one();
+      m_idle_cond.notify_one();
     }
     monitor_thread.join();
   }
@@ -260,10 +471,11 @@ public:
 
     // Store command so completion can be tracked.  Make sure this is
     // done prior to exec_buf as exec_wait can otherwise be missed.
-    // See detailed explanation in monitor loop.
-    {
-      std::lock_guard<std::mutex> lk(work_mutex);
-      submitted_cmds.push_back(cmd);
+    // See detailed explanation in monitor loop.  If the ring is full,
+    // then make sure the monitor is awake to drain it.
+    while (!m_ring.push(cmd)) {
+      wake_monitor();
+      std::this_thread::yield();
     }
 
     // Submit the command
@@ -271,17 +483,47 @@ public:
       m_impl->submit(cmd);
     }
     catch (...) {
-      // Remove the pending command
-      std::lock_guard<std::mutex> lk(work_mutex);
+      // The command is already published to the monitor thread,
+      // make sure the monitor stops tracking it before returning
       assert(get_command_state(cmd)==ERT_CMD_STATE_NEW);
-      if (!submitted_cmds.empty())
-        submitted_cmds.pop_back();
+      abort(&cmd, &cmd + 1);
       throw;
     }
 
     // This is somewhat expensive, it is better to have this after the
     // exec_buf call so that actual execution doesn't have to wait.
-    work_cond.notify_one();
+    wake_monitor();
+  }
+
+  // launch() - Submit a list of commands for managed execution
+  //
+  // All commands are published to the monitor thread before the
+  // list is submitted as one batch.  @submitted is the number of
+  // leading commands already submitted, it is advanced as commands
+  // are submitted and is valid also when the function throws.
+  void
+  launch(const command_queue_type& cmds, size_t& submitted)
+  {
+    for (auto itr = cmds.begin() + submitted; itr != cmds.end(); ++itr) {
+      auto cmd = *itr;
+      XRT_DEBUGF("xrt_core::kds::command(%d) [new->submitted->running]\n", cmd->get_uid());
+      while (!m_ring.push(cmd)) {
+        wake_monitor();
+        std::this_thread::yield();
+      }
+    }
+
+    try {
+      m_impl->submit(cmds, submitted);
+    }
+    catch (...) {
+      // Stop tracking the commands that were not submitted, the
+      // submitted commands are monitored as usual
+      abort(cmds.begin() + submitted, cmds.end());
+      throw;
+    }
+
+    wake_monitor();
   }
 };
 
@@ -386,6 +628,20 @@ public:
   virtual void
   submit(xrt_core::command* cmd) = 0;  // NOLINT override from base
 
+  // Submit list of independent commands for execution.  Default
+  // submits the commands one by one, derived queues submit the list
+  // with as few shim calls as possible.
+  //
+  // @submitted is the number of leading commands already submitted.
+  // It is advanced as commands are submitted, such that it is valid
+  // also when the function throws.
+  void
+  submit(const command_queue_type& cmds, size_t& submitted) override
+  {
+    for (; submitted < cmds.size(); ++submitted)
+      submit(cmds[submitted]);
+  }
+
   // Wait for some command to finish
   virtual std::cv_status
   wait(size_t timeout_ms) = 0;         // NOLINT override from base
@@ -398,6 +654,60 @@ public:
   virtual int
   poll(const xrt_core::command* cmd) const = 0;
 
+  // Number of commands that can be in flight, 0 if unknown
+  virtual size_t
+  get_queue_depth() const
+  {
+    return 0;
+  }
+
+  // Maximum number of commands in a chained command, 0 if unknown
+  virtual size_t
+  get_max_chain_size() const
+  {
+    return 0;
+  }
+
+  // Spin and yield for command completion per policy.  Returns true
+  // if the command completed, false if policy expired.
+  bool
+  spin_wait(const xrt_core::command* cmd, const wait_policy& policy) const
+  {
+    auto pkt = static_cast<volatile ert_packet*>(cmd->get_ert_packet());
+    auto done = [this, cmd, pkt] {
+      return poll(cmd) && pkt->state >= ERT_CMD_STATE_COMPLETED;
+    };
+
+    auto spin_end = std::chrono::steady_clock::now() + policy.spin_us * 1us;
+    auto yield_end = spin_end + policy.yield_us * 1us;
+    while (std::chrono::steady_clock::now() < spin_end)
+      if (done())
+        return true;
+
+    while (std::chrono::steady_clock::now() < yield_end) {
+      if (done())
+        return true;
+      std::this_thread::yield();
+    }
+
+    return done();
+  }
+
+  // Wait for specified command to finish per wait policy.  The
+  // policy delays blocking in the driver, the spin period is not
+  // accounted for in the timeout.
+  std::cv_status
+  wait(const xrt_core::command* cmd, size_t timeout_ms, const wait_policy& policy)
+  {
+    if (!policy.blocking() && spin_wait(cmd, policy)) {
+      auto pkt = cmd->get_ert_packet();
+      notify_host(const_cast<xrt_core::command*>(cmd), static_cast<ert_cmd_state>(pkt->state)); // NOLINT
+      return std::cv_status::no_timeout;
+    }
+
+    return wait(cmd, timeout_ms);
+  }
+
   // Poll for command completion
   virtual int
   poll(xrt_core::buffer_handle* cmd) const = 0;
@@ -426,6 +736,19 @@ public:
     submit(cmd);
   }
 
+  // Managed start of a list of commands
+  void
+  managed_start(const command_queue_type& cmds, size_t& submitted)
+  {
+    get_cmd_manager()->launch(cmds, submitted);
+  }
+
+  // Unmanaged start of a list of commands
+  void
+  unmanaged_start(const command_queue_type& cmds, size_t& submitted)
+  {
+    submit(cmds, submitted);
+  }
 };
 
 // class qds_device - queue implementation for shim queue support
@@ -480,6 +803,26 @@ public:
     m_qhdl->submit_command(cmd->get_exec_bo());
   }
 
+  // Submit all commands with one call to the shim hw queue.  The
+  // shim returns early if a command fails submission after other
+  // commands were submitted, in which case the remaining commands
+  // are resubmitted to either progress or get the error.
+  void
+  submit(const command_queue_type& cmds, size_t& submitted) override
+  {
+    std::vector<xrt_core::buffer_handle*> bos;
+    bos.reserve(cmds.size() - submitted);
+    std::transform(cmds.begin() + submitted, cmds.end(), std::back_inserter(bos),
+                   [](auto cmd) { return cmd->get_exec_bo(); });
+    while (!bos.empty()) {
+      auto count = m_qhdl->submit_command(bos);
+      if (!count)
+        throw std::runtime_error("hw queue failed to submit commands");
+      submitted += count;
+      bos.erase(bos.begin(), bos.begin() + count);
+    }
+  }
+
   void
   submit(xrt_core::buffer_handle* cmd) override
   {
@@ -510,6 +853,18 @@ public:
     return m_qhdl->poll_command(cmd);
   }
 
+  size_t
+  get_queue_depth() const override
+  {
+    return m_qhdl->get_queue_depth();
+  }
+
+  size_t
+  get_max_chain_size() const override
+  {
+    return m_qhdl->get_max_chain_size();
+  }
+
   void
   submit_wait(const xrt::fence& fence) override
   {
@@ -526,14 +881,84 @@ public:
 // class kds_device - queue implementation for legacy shim support
 //
 // @exec_wait_mutex: Synchronize access to exec_wait
+// @work: Wake up threads waiting in exec_wait() for some completion
 // @exec_wait_call_count:  Count of number of calls to exec wait
+// @exec_wait_active: A thread is currently calling device exec_wait
+// @exec_wait_waiters: Number of threads waiting in exec_wait() on m_work
+// @cmd_waiters: Threads waiting for a specific command to complete
 class kds_device : public hw_queue_impl
 {
+  // struct cmd_waiter - a thread waiting for specific command
+  //
+  // @cmd: The command the thread waits for
+  // @cv: Condition variable on which thread sleeps
+  // @woken: Set when thread is woken by the thread polling the device
+  //
+  // The waiter is allocated on the stack of the waiting thread and
+  // registered with the kds_device while the thread waits.
+  struct cmd_waiter
+  {
+    const xrt_core::command* cmd;
+    std::condition_variable cv;
+    bool woken = false;
+
+    explicit cmd_waiter(const xrt_core::command* c)
+      : cmd(c)
+    {}
+
+    bool
+    completed() const
+    {
+      auto pkt = static_cast<volatile ert_packet*>(cmd->get_ert_packet());
+      return pkt->state >= ERT_CMD_STATE_COMPLETED;
+    }
+
+    void
+    wake()
+    {
+      woken = true;
+      cv.notify_one();
+    }
+  };
+
   xrt_core::device* m_device;
   std::mutex m_exec_wait_mutex;
   std::condition_variable m_work;
   uint64_t m_exec_wait_call_count {0};
   uint32_t m_exec_wait_active {0};
+  uint32_t m_exec_wait_waiters {0};
+  std::vector<cmd_waiter*> m_cmd_waiters;
+
+  // Called with lock held by the thread that just returned from
+  // device::exec_wait.
+  //
+  // Wake command waiters whose commands have completed, and if the
+  // calling thread is not going to poll the device again, wake one
+  // waiter whose command has not completed such that it can take
+  // over polling of the device.  Threads in exec_wait() waiting for
+  // any completion are woken only if there are any.
+  void
+  exec_wait_done(const cmd_waiter* self, bool continue_polling)
+  {
+    ++m_exec_wait_call_count;
+    --m_exec_wait_active;
+
+    cmd_waiter* next_poller = nullptr;
+    for (auto waiter : m_cmd_waiters) {
+      if (waiter == self)
+        continue;
+      if (waiter->completed())
+        waiter->wake();
+      else if (!next_poller)
+        next_poller = waiter;
+    }
+
+    if (!continue_polling && next_poller)
+      next_poller->wake();
+
+    if (m_exec_wait_waiters)
+      m_work.notify_all();
+  }
 
   // Thread safe shim level exec wait call.   This function allows
   // multiple threads to call exec_wait through same device handle.
@@ -563,6 +988,10 @@ class kds_device : public hw_queue_impl
   // The specified timeout affects the waiting for device::exec_wait
   // only. The timeout can be masked if device is busy and many
   // commands complete with the specified timeout.
+  //
+  // This function is used when waiting for any command to complete.
+  // Waiting for a specific command uses wait_cmd(), which shares the
+  // device polling with this function.
   std::cv_status
   exec_wait(size_t timeout_ms=0)
   {
@@ -585,6 +1014,7 @@ class kds_device : public hw_queue_impl
         // Some other thread is calling device::exec_wait, wait
         // for it complete its work and notify this thread
         auto status = std::cv_status::no_timeout;
+        ++m_exec_wait_waiters;
         if (timeout_ms) {
           status = (m_work.wait_for(lk, timeout_ms * 1ms,
                                     [this] {
@@ -599,6 +1029,7 @@ class kds_device : public hw_queue_impl
                         return thread_exec_wait_call_count != m_exec_wait_call_count;
                       });
         }
+        --m_exec_wait_waiters;
 
         // The other thread has completed its exec_wait call,
         // sync with current global call count and return
@@ -632,16 +1063,76 @@ class kds_device : public hw_queue_impl
       while (m_device->exec_wait(default_timeout) == 0) {}
     }
 
-    // Acquire lock before updating shared state
-    {
-      std::lock_guard lk(m_exec_wait_mutex);
-      thread_exec_wait_call_count = ++m_exec_wait_call_count;
-      --m_exec_wait_active;
+    // Acquire lock before updating shared state, then notify any
+    // waiting threads so they can check command status and possibly
+    // call exec_wait again.
+    std::lock_guard lk(m_exec_wait_mutex);
+    exec_wait_done(nullptr, false);
+    thread_exec_wait_call_count = m_exec_wait_call_count;
+
+    return status;
+  }
+
+  // Wait for a specific command to complete.
+  //
+  // The waiting thread registers itself as a waiter for the command.
+  // If no other thread is polling the device, then this thread calls
+  // device::exec_wait, otherwise it sleeps on its own condition
+  // variable.  The polling thread wakes only the waiters whose
+  // commands have completed, plus one waiter to take over polling
+  // when the polling thread is done.  This avoids waking up all
+  // waiting threads for every completion.
+  std::cv_status
+  wait_cmd(const xrt_core::command* cmd, size_t timeout_ms)
+  {
+    cmd_waiter self{cmd};
+    if (self.completed())
+      return std::cv_status::no_timeout;
+
+    constexpr size_t default_timeout = 1000;
+    auto deadline = std::chrono::steady_clock::now() + timeout_ms * 1ms;
+    auto status = std::cv_status::no_timeout;
+
+    std::unique_lock lk(m_exec_wait_mutex);
+    m_cmd_waiters.push_back(&self);
+    while (!self.completed()) {
+      auto now = std::chrono::steady_clock::now();
+      if (timeout_ms && now >= deadline) {
+        status = std::cv_status::timeout;
+        break;
+      }
+
+      // Remaining time rounded up to whole milliseconds
+      auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+
+      if (!m_exec_wait_active) {
+        // No other thread is polling the device
+        ++m_exec_wait_active;
+        lk.unlock();
+        m_device->exec_wait(static_cast<int>(timeout_ms ? remaining : default_timeout));
+        lk.lock();
+        exec_wait_done(&self, !self.completed());
+        continue;
+      }
+
+      // Some other thread is polling, sleep until woken
+      self.woken = false;
+      if (timeout_ms)
+        self.cv.wait_for(lk, remaining * 1ms, [&self] { return self.woken; });
+      else
+        self.cv.wait(lk, [&self] { return self.woken; });
     }
 
-    // Notify any waiting threads so they can check command status and
-    // possibly call exec_wait again.
-    m_work.notify_all();
+    m_cmd_waiters.erase(std::find(m_cmd_waiters.begin(), m_cmd_waiters.end(), &self));
+
+    // A waiter that leaves while other waiters remain must make sure
+    // that some thread polls the device.
+    if (!m_exec_wait_active) {
+      auto itr = std::find_if(m_cmd_waiters.begin(), m_cmd_waiters.end(),
+                              [](auto waiter) { return !waiter->completed(); });
+      if (itr != m_cmd_waiters.end())
+        (*itr)->wake();
+    }
 
     return status;
   }
@@ -660,16 +1151,14 @@ public:
   std::cv_status
   wait(const xrt_core::command* cmd, size_t timeout_ms) override
   {
-    volatile auto pkt = cmd->get_ert_packet();
-    while (pkt->state < ERT_CMD_STATE_COMPLETED) {
-      // return immediately on timeout
-      if (exec_wait(timeout_ms) == std::cv_status::timeout)
-        return std::cv_status::timeout;
-    }
+    // return immediately on timeout
+    if (wait_cmd(cmd, timeout_ms) == std::cv_status::timeout)
+      return std::cv_status::timeout;
 
     // notify_host is not strictly necessary for unmanaged
     // command execution but provides a central place to update
     // and mark commands as done so they can be re-executed.
+    auto pkt = cmd->get_ert_packet();
     notify_host(const_cast<xrt_core::command*>(cmd), static_cast<ert_cmd_state>(pkt->state)); // NOLINT
 
     return std::cv_status::no_timeout;
@@ -688,6 +1177,37 @@ public:
     m_device->exec_buf(cmd->get_exec_bo());
   }
 
+  // Submit consecutive commands that share a hw context with one
+  // call to the shim.  Commands not tied to a context are submitted
+  // one by one.  Commands are submitted in list order such that
+  // @submitted is always a count of leading commands.
+  void
+  submit(const command_queue_type& cmds, size_t& submitted) override
+  {
+    std::vector<xrt_core::buffer_handle*> bos;
+    bos.reserve(cmds.size() - submitted);
+    while (submitted < cmds.size()) {
+      auto hwctx = cmds[submitted]->get_hwctx_handle();
+      if (!hwctx) {
+        submit(cmds[submitted]);
+        ++submitted;
+        continue;
+      }
+
+      bos.clear();
+      for (auto idx = submitted; idx < cmds.size() && cmds[idx]->get_hwctx_handle() == hwctx; ++idx)
+        bos.push_back(cmds[idx]->get_exec_bo());
+
+      // The shim returns early if a command fails submission after
+      // other commands were submitted, the remaining commands are
+      // resubmitted in next iteration
+      auto count = hwctx->exec_buf(bos);
+      if (!count)
+        throw std::runtime_error("hw context failed to submit commands");
+      submitted += count;
+    }
+  }
+
   void
   submit(xrt_core::buffer_handle* cmd) override
   {
@@ -892,6 +1412,20 @@ unmanaged_start(xrt_core::command* cmd)
   get_handle()->unmanaged_start(cmd);
 }
 
+void
+hw_queue::
+managed_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+{
+  get_handle()->managed_start(cmds, submitted);
+}
+
+void
+hw_queue::
+unmanaged_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted)
+{
+  get_handle()->unmanaged_start(cmds, submitted);
+}
+
 void
 hw_queue::
 submit(xrt_core::buffer_handle* cmd)
@@ -928,6 +1462,20 @@ poll(xrt_core::buffer_handle* cmd) const
   return get_handle()->poll(cmd);
 }
 
+size_t
+hw_queue::
+get_queue_depth() const
+{
+  return get_handle()->get_queue_depth();
+}
+
+size_t
+hw_queue::
+get_max_chain_size() const
+{
+  return get_handle()->get_max_chain_size();
+}
+
 void
 hw_queue::
 submit_wait(const xrt::fence& fence)
@@ -950,6 +1498,22 @@ wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout_ms)
   return get_handle()->wait(cmd, timeout_ms.count());
 }
 
+std::cv_status
+hw_queue::
+wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout_ms,
+     const wait_policy& policy) const
+{
+  return get_handle()->wait(cmd, timeout_ms.count(), policy);
+}
+
+wait_policy
+wait_policy::
+get_default()
+{
+  static wait_policy policy {xrt_core::config::get_wait_spin_us(), xrt_core::config::get_wait_yield_us()};
+  return policy;
+}
+
 std::cv_status
 hw_queue::
 exec_wait(const xrt_core::device* device, const std::chrono::milliseconds& timeout_ms)
@@ -13,6 +13,7 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <vector>
 
 namespace xrt {
@@ -26,6 +27,31 @@ class command;
 class device;
 class fence;
 
+// struct wait_policy - policy for waiting on command completion
+//
+// @spin_us: Busy poll command state for this many microseconds
+// @yield_us: Then poll and yield cpu for this many microseconds
+//
+// After spinning and yielding, the wait blocks in the driver.  Short
+// running commands complete faster than the latency of a blocking
+// wait and subsequent wake up.
+struct wait_policy
+{
+  uint32_t spin_us = 0;
+  uint32_t yield_us = 0;
+
+  bool
+  blocking() const
+  {
+    return spin_us == 0 && yield_us == 0;
+  }
+
+  // Default policy as specified in xrt.ini
+  XRT_CORE_COMMON_EXPORT
+  static wait_policy
+  get_default();
+};
+
 // class hw_queue - internal representation of hw queue for scheduling
 //
 // Constructed from within xrt::kernel
@@ -58,6 +84,23 @@ public:
   void
   unmanaged_start(xrt_core::command* cmd);
 
+  // Start a list of independent commands and manage their execution
+  // by monitoring for command completion.  The commands are
+  // submitted in order with as few shim calls as possible.
+  //
+  // @submitted is the number of leading commands already submitted,
+  // it is advanced as commands are submitted.  If the function
+  // throws, then commands from @submitted and on were not started.
+  void
+  managed_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted);
+
+  // Start a list of independent commands with explicit completion
+  // control from application.  The commands are submitted in order
+  // with as few shim calls as possible.  @submitted as for
+  // managed_start.
+  void
+  unmanaged_start(const std::vector<xrt_core::command*>& cmds, size_t& submitted);
+
   // Submit a raw cmd for execution
   void
   submit(xrt_core::buffer_handle* cmd);
@@ -77,6 +120,12 @@ public:
   std::cv_status
   wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout) const;
 
+  // Wait for unmanaged command completion using a spin-then-block
+  // policy.  A timeout of 0 means wait for ever.
+  std::cv_status
+  wait(const xrt_core::command* cmd, const std::chrono::milliseconds& timeout,
+       const wait_policy& policy) const;
+
   // Poll for command state. A return value of 0 indicates the command
   // is still running. Any other return value implies the command
   // state must be checked.
@@ -89,6 +138,16 @@ public:
   int
   poll(xrt_core::buffer_handle*) const;
 
+  // Number of commands that can be in flight on the queue, or 0 if
+  // the depth is unknown.
+  size_t
+  get_queue_depth() const;
+
+  // Maximum number of commands in a chained command accepted by
+  // the queue, or 0 if the limit is unknown.
+  size_t
+  get_max_chain_size() const;
+
   // Enqueue a command dependency
   void
   submit_wait(const xrt::fence& fence);
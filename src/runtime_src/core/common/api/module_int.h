@@ -10,6 +10,7 @@
 #include "core/include/experimental/xrt_bo.h"
 #include "core/include/experimental/xrt_module.h"
 
+#include <cstdint>
 #include <string>
 
 namespace xrt_core::module_int {
@@ -46,6 +47,22 @@ patch(const xrt::module&, const std::string& argnm, size_t index, const void* va
 void
 sync(const xrt::module&);
 
+// Bytes of control code patched since the previous run start and
+// synced to device by the most recent run start, see sync().  Only
+// the byte ranges modified by patching are synced, so bytes_synced is
+// typically much smaller than the size of the control code.  All
+// counters are zero if nothing was patched before the last start.
+struct patch_counters
+{
+  uint64_t bytes_patched = 0;
+  uint64_t bytes_synced = 0;
+  uint64_t syncs = 0;
+};
+
+XRT_CORE_COMMON_EXPORT
+patch_counters
+get_patch_counters(const xrt::module& module);
+
 // Get the ERT command opcode in ELF flow
 ert_cmd_opcode
 get_ert_opcode(const xrt::module& module);
@@ -9,6 +9,7 @@
 #define XRT_API_SOURCE         // in same dll as api
 #include "core/include/xrt/xrt_bo.h"
 #include "core/include/xrt/xrt_aie.h"
+#include "core/include/experimental/xrt_bo.h"
 #include "core/include/xrt/xrt_hw_context.h"
 #include "core/include/experimental/xrt_ext.h"
 
@@ -21,6 +22,7 @@
 #include "kernel_int.h"
 #include "xrt_mem.h"
 #include "core/common/api/bo_int.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
 #include "core/common/memalign.h"
 #include "core/common/message.h"
@@ -33,10 +35,17 @@
 #include "core/common/shim/buffer_handle.h"
 #include "core/common/shim/shared_handle.h"
 
+#include <condition_variable>
+#include <algorithm>
 #include <cstdlib>
+#include <exception>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <queue>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -174,6 +183,8 @@ public:
 
 namespace xrt {
 
+class dma_engine;
+
 // class bo_impl - Base class for buffer objects
 //
 // [bo_impl]: base class
@@ -218,6 +229,10 @@ private:
   std::shared_ptr<xrt_core::usage_metrics::base_logger> m_usage_logger =
       xrt_core::usage_metrics::get_usage_metrics_logger();
 
+  // Device engine for async sync operations, acquired on first use
+  std::once_flag m_dma_engine_flag;
+  std::shared_ptr<dma_engine> m_dma_engine;
+
 protected:
   // deliberately made protected, this is a file-scoped controlled API
   device_type device;                              // NOLINT device where bo is allocated
@@ -473,6 +488,27 @@ public:
     m_usage_logger->log_buffer_sync(device->get_device_id(), device.get_hwctx_handle(), sz, dir);
   }
 
+  // Sync a list of ranges of this buffer with one shim call.  The
+  // ranges are sorted and non-overlapping.
+  virtual void
+  sync(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges)
+  {
+    size_t sz = 0;
+    for (const auto& r : ranges)
+      sz += r.size;
+
+    handle->sync(static_cast<xrt_core::buffer_handle::direction>(dir), ranges);
+    m_usage_logger->log_buffer_sync(device->get_device_id(), device.get_hwctx_handle(), sz, dir);
+  }
+
+  // Buffer through which this buffer is synced and the offset of
+  // this buffer within that buffer.
+  virtual std::pair<bo_impl*, size_t>
+  get_sync_root()
+  {
+    return {this, 0};
+  }
+
   virtual uint64_t
   get_address() const
   {
@@ -538,6 +574,213 @@ public:
   {
     throw std::runtime_error("Unsupported feature");
   }
+
+  // wait() - Wait for async to complete with timeout
+  virtual std::cv_status
+  wait(const std::chrono::milliseconds&)
+  {
+    throw std::runtime_error("Unsupported feature");
+  }
+};
+
+// class sync_async_handle_impl - Asynchronous sync of a buffer
+//
+// The sync operation is executed by a dma_engine worker thread.  The
+// handle records completion of the operation along with any exception
+// thrown by the sync, which is rethrown by wait().
+class sync_async_handle_impl : public bo::async_handle_impl
+{
+  std::mutex m_mutex;
+  std::condition_variable m_done_cond;
+  bool m_done = false;
+  std::exception_ptr m_exception;
+
+  void
+  rethrow() const
+  {
+    if (m_exception)
+      std::rethrow_exception(m_exception);
+  }
+
+public:
+  explicit sync_async_handle_impl(xrt::bo bo)
+    : bo::async_handle_impl(std::move(bo))
+  {}
+
+  // execute() - Called by dma_engine worker thread
+  void
+  execute(xclBOSyncDirection dir, size_t sz, size_t offset)
+  {
+    std::exception_ptr eptr;
+    try {
+      m_bo.get_handle()->sync(dir, sz, offset);
+    }
+    catch (...) {
+      eptr = std::current_exception();
+    }
+
+    std::lock_guard lk(m_mutex);
+    m_exception = std::move(eptr);
+    m_done = true;
+    m_done_cond.notify_all();
+  }
+
+  void
+  wait() override
+  {
+    std::unique_lock lk(m_mutex);
+    m_done_cond.wait(lk, [this] { return m_done; });
+    rethrow();
+  }
+
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout) override
+  {
+    if (timeout.count() == 0) {
+      wait();
+      return std::cv_status::no_timeout;
+    }
+
+    std::unique_lock lk(m_mutex);
+    if (!m_done_cond.wait_for(lk, timeout, [this] { return m_done; }))
+      return std::cv_status::timeout;
+
+    rethrow();
+    return std::cv_status::no_timeout;
+  }
+};
+
+// class dma_engine - Worker pool for asynchronous buffer sync
+//
+// Each worker executes its operations in FIFO order.  All operations
+// on a buffer handle are dispatched to the same worker, so async
+// operations on a buffer and its sub-buffers (which share the parent
+// handle) complete in order, while operations on different buffers
+// proceed concurrently with each other and with the host.
+//
+// There is one engine per device.  The engine is shared by the
+// buffers that have used async, so it is destroyed with the last of
+// these buffers and never outlives the device.  Queued operations
+// reference their buffer, so the engine can be destroyed by one of
+// its own workers, in which case that worker is detached and exits
+// after draining its queue.
+//
+// The number of workers is controlled by xrt.ini
+// Runtime.bo_async_workers.
+class dma_engine
+{
+  using operation = std::function<void()>;
+
+  // State shared between a worker and its thread, such that a
+  // detached thread can finish after the worker is destroyed
+  struct worker_state
+  {
+    std::queue<operation> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_work;
+    bool m_stop = false;
+  };
+
+  struct worker
+  {
+    std::shared_ptr<worker_state> m_state;
+    std::thread m_thread;
+
+    worker()
+      : m_state(std::make_shared<worker_state>())
+      , m_thread([state = m_state] { run(state); })
+    {}
+
+    ~worker()
+    {
+      {
+        std::lock_guard lk(m_state->m_mutex);
+        m_state->m_stop = true;
+        m_state->m_work.notify_one();
+      }
+
+      if (m_thread.get_id() == std::this_thread::get_id())
+        m_thread.detach();
+      else
+        m_thread.join();
+    }
+
+    worker(const worker&) = delete;
+    worker(worker&&) = delete;
+    worker& operator=(const worker&) = delete;
+    worker& operator=(worker&&) = delete;
+
+    // Drain pending operations before stopping so that no
+    // async_handle is left incomplete
+    static void
+    run(const std::shared_ptr<worker_state>& state)
+    {
+      while (true) {
+        operation op;
+        {
+          std::unique_lock lk(state->m_mutex);
+          state->m_work.wait(lk, [&state] { return state->m_stop || !state->m_queue.empty(); });
+          if (state->m_queue.empty())
+            return;
+          op = std::move(state->m_queue.front());
+          state->m_queue.pop();
+        }
+        op();
+      }
+    }
+
+    void
+    enqueue(operation&& op)
+    {
+      std::lock_guard lk(m_state->m_mutex);
+      m_state->m_queue.push(std::move(op));
+      m_state->m_work.notify_one();
+    }
+  };
+
+  std::vector<std::unique_ptr<worker>> m_workers;
+
+public:
+  explicit dma_engine(size_t workers)
+  {
+    for (size_t i = 0; i < std::max<size_t>(workers, 1); ++i)
+      m_workers.emplace_back(std::make_unique<worker>());
+  }
+
+  // get() - Engine of a device, constructed on first use
+  static std::shared_ptr<dma_engine>
+  get(const xrt_core::device* device)
+  {
+    static std::mutex mutex;
+    static std::map<const xrt_core::device*, std::weak_ptr<dma_engine>> engines;
+    std::lock_guard lk(mutex);
+
+    // drop engines released since last lookup, the map would otherwise
+    // grow with every device ever opened
+    for (auto itr = engines.begin(); itr != engines.end();) {
+      if (itr->second.expired())
+        itr = engines.erase(itr);
+      else
+        ++itr;
+    }
+
+    auto& weak = engines[device];
+    auto engine = weak.lock();
+    if (!engine) {
+      engine = std::make_shared<dma_engine>(xrt_core::config::get_bo_async_workers());
+      weak = engine;
+    }
+    return engine;
+  }
+
+  // enqueue() - Schedule an operation on the worker owning the key
+  void
+  enqueue(const xrt_core::buffer_handle* key, operation&& op)
+  {
+    // low bits of heap pointers are constant, skip them
+    auto idx = (reinterpret_cast<uintptr_t>(key) >> 6) % m_workers.size(); // NOLINT
+    m_workers[idx]->enqueue(std::move(op));
+  }
 };
 
 class aie::bo::async_handle_impl : public xrt::bo::async_handle_impl
@@ -636,13 +879,20 @@ xrt::bo::async_handle
 bo_impl::
 async(xrt::bo& bo, xclBOSyncDirection dir, size_t sz, size_t offset)
 {
-  throw std::runtime_error("Unsupported feature");
+  // Validate arguments here rather than when the operation executes,
+  // such that errors are reported by the call that caused them
+  if (dir != XCL_BO_SYNC_BO_TO_DEVICE && dir != XCL_BO_SYNC_BO_FROM_DEVICE)
+    throw xrt_core::error(-EINVAL, "Invalid direction for async buffer sync");
+  if (offset > size || sz > size - offset)
+    throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing buffer");
+
+  std::call_once(m_dma_engine_flag, [this] { m_dma_engine = dma_engine::get(device.get_core_device()); });
 
-#if 0
-  //TODO for Alveo; base xrt::bo class
-  auto a_bo_impl = std::make_shared<xrt::bo::async_handle_impl>(bo);
+  auto a_bo_impl = std::make_shared<sync_async_handle_impl>(bo);
+  m_dma_engine->enqueue(get_handle(), [a_bo_impl, dir, sz, offset] {
+    a_bo_impl->execute(dir, sz, offset);
+  });
   return xrt::bo::async_handle{a_bo_impl};
-#endif
 }
 
 // class buffer_ubuf - User provide host side buffer
@@ -881,6 +1131,13 @@ public:
     }
   }
 
+  void
+  sync(xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges) override
+  {
+    for (const auto& r : ranges)
+      sync(dir, r.size, r.offset);
+  }
+
   void
   copy(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset) override
   {
@@ -947,6 +1204,13 @@ public:
     // sync through parent buffer, which handles nodma case also
     m_parent->sync(dir, sz, off);
   }
+
+  std::pair<bo_impl*, size_t>
+  get_sync_root() override
+  {
+    auto [root, offset] = m_parent->get_sync_root();
+    return {root, offset + m_offset};
+  }
 };
 
 // class buffer_xbuf - Wrapper for extern managed xclBufferHandle
@@ -982,6 +1246,12 @@ public:
     throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
   }
 
+  void
+  sync(xclBOSyncDirection, const std::vector<xrt_core::buffer_handle::range>&) override
+  {
+    throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
+  }
+
   bool
   is_sub() const override
   {
@@ -1274,6 +1544,63 @@ adjust_buffer_flags(const device_type& dev, xrt::bo::flags flags, xrt::memory_gr
   return static_cast<xrtBufferFlags>(flags);
 }
 
+// sync_ranges() - Sync a list of buffer ranges in batches
+//
+// Ranges are resolved to their root buffer and grouped by root buffer
+// and direction.  Within a group, adjacent and overlapping ranges are
+// merged and the group is synced with one call to the root buffer.
+// All ranges are validated before any range is synced.
+static void
+sync_ranges(const std::vector<xrt::bo_sync_range>& ranges)
+{
+  using range = xrt_core::buffer_handle::range;
+  struct group
+  {
+    xrt::bo_impl* root;
+    xclBOSyncDirection dir;
+    std::vector<range> ranges;
+  };
+
+  std::vector<group> groups;
+  for (const auto& r : ranges) {
+    const auto& boh = r.bo.get_handle();
+    // checked such that a large offset cannot wrap around
+    auto size = boh->get_size();
+    if (r.size > size || r.offset > size - r.size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing buffer range");
+    if (!r.size)
+      continue;
+
+    auto [root, offset] = boh->get_sync_root();
+    auto itr = std::find_if(groups.begin(), groups.end(), [root = root, dir = r.dir](const auto& g) {
+      return g.root == root && g.dir == dir;
+    });
+    if (itr == groups.end())
+      itr = groups.insert(groups.end(), {root, r.dir, {}});
+    itr->ranges.push_back({r.size, r.offset + offset});
+  }
+
+  for (auto& g : groups) {
+    auto& rs = g.ranges;
+    std::sort(rs.begin(), rs.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.offset < rhs.offset;
+    });
+
+    // merge adjacent and overlapping ranges in place
+    auto last = rs.begin();
+    for (auto itr = std::next(rs.begin()); itr != rs.end(); ++itr) {
+      auto end = last->offset + last->size;
+      if (itr->offset <= end)
+        last->size = std::max(end, itr->offset + itr->size) - last->offset;
+      else
+        *(++last) = *itr;
+    }
+    rs.erase(std::next(last), rs.end());
+
+    g.root->sync(g.dir, rs);
+  }
+}
+
 } // namespace
 
 ////////////////////////////////////////////////////////////////
@@ -1351,6 +1678,13 @@ wait()
   handle->wait();
 }
 
+std::cv_status
+bo::async_handle::
+wait(const std::chrono::milliseconds& timeout)
+{
+  return handle->wait(timeout);
+}
+
 bo::
 bo(const xrt::device& device, void* userptr, size_t sz, bo::flags flags, memory_group grp)
   : handle(xdp::native::profiling_wrapper("xrt::bo::bo",
@@ -1561,6 +1895,14 @@ copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
 bo::
 ~bo() = default;
 
+void
+sync(const std::vector<bo_sync_range>& ranges)
+{
+  xdp::native::profiling_wrapper("xrt::sync", [&ranges]{
+    sync_ranges(ranges);
+  });
+}
+
 } // xrt
 
 ////////////////////////////////////////////////////////////////
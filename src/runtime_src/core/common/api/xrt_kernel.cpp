@@ -57,6 +57,7 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -853,23 +854,51 @@ public:
       (*cb)(state);
   }
 
+  // Mark the command as running prior to submission.  Returns true
+  // if the command must be submitted for managed execution.
+  bool
+  prep_run()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_done)
+      throw std::runtime_error("bad command state, can't launch");
+    m_managed = (m_callbacks && !m_callbacks->empty());
+    m_done = false;
+    return m_managed;
+  }
+
+  // Revert prep_run() for a command that was not submitted
+  void
+  cancel_run()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_done = true;
+  }
+
   // Submit the command for execution.
   void
   run()
   {
-    {
-      std::lock_guard<std::mutex> lk(m_mutex);
-      if (!m_done)
-        throw std::runtime_error("bad command state, can't launch");
-      m_managed = (m_callbacks && !m_callbacks->empty());
-      m_done = false;
-    }
-    if (m_managed)
+    if (prep_run())
       m_hwqueue.managed_start(this);
     else
       m_hwqueue.unmanaged_start(this);
   }
 
+  const xrt_core::hw_queue&
+  get_hw_queue() const
+  {
+    return m_hwqueue;
+  }
+
+  // Policy for unmanaged wait, managed commands are notified
+  // by the command monitor and always block
+  void
+  set_wait_policy(const xrt_core::wait_policy& policy)
+  {
+    m_wait_policy = policy;
+  }
+
   // Wait for command completion
   ert_cmd_state
   wait() const
@@ -880,7 +909,7 @@ public:
         m_exec_done.wait(lk);
     }
     else {
-      m_hwqueue.wait(this);
+      m_hwqueue.wait(this, std::chrono::milliseconds{0}, m_wait_policy);
     }
 
     return get_state_raw(); // state wont change after wait
@@ -896,7 +925,7 @@ public:
           return {get_state_raw(), std::cv_status::timeout};
     }
     else {
-      if (m_hwqueue.wait(this, timeout_ms) == std::cv_status::timeout)
+      if (m_hwqueue.wait(this, timeout_ms, m_wait_policy) == std::cv_status::timeout)
         return {get_state_raw(), std::cv_status::timeout};
     }
 
@@ -975,6 +1004,7 @@ private:
   unsigned int m_uid = 0;
   bool m_managed = false;
   mutable bool m_done = false;
+  xrt_core::wait_policy m_wait_policy = xrt_core::wait_policy::get_default();
 
   mutable std::mutex m_mutex;
   mutable std::condition_variable m_exec_done;
@@ -1853,6 +1883,14 @@ class run_impl
 
     virtual arg_range<uint8_t>
     get_arg_value(const argument& arg) = 0;
+
+    // Location of argument value in the payload if the value can be
+    // copied directly into the payload, nullptr otherwise.
+    virtual uint8_t*
+    get_arg_location(const argument&)
+    {
+      return nullptr;
+    }
   };
 
   // AP_CTRL_HS, AP_CTRL_CHAIN
@@ -1883,6 +1921,12 @@ class run_impl
     {
       return { data + arg.offset(), arg.size() };
     }
+
+    uint8_t*
+    get_arg_location(const argument& arg) override
+    {
+      return data + arg.offset();
+    }
   };
 
   // FAST_ADAPTER
@@ -1933,6 +1977,12 @@ class run_impl
       uint64_t value[2] = {bo.address(), bo.size()}; // NOLINT
       hs_arg_setter::set_arg_value(arg, arg_range<uint8_t>{value, sizeof(value)});
     }
+
+    uint8_t*
+    get_arg_location(const argument&) override
+    {
+      return nullptr;
+    }
   };
 
   static uint32_t
@@ -2308,6 +2358,66 @@ public:
     set_arg_value(arg, value, bytes);
   }
 
+  // struct arg_slot - Argument of a precompiled argument binding plan
+  //
+  // The slot caches the location of the argument value in the command
+  // payload.  If the value cannot be copied directly into the payload,
+  // e.g. because the run object patches an instruction module, then
+  // @value is nullptr and the argument is set through the arg_setter.
+  struct arg_slot
+  {
+    const argument* arg = nullptr;
+    uint8_t* value = nullptr;
+  };
+
+  // Create argument slots for all kernel arguments, the slot of an
+  // argument is at the index of the argument.  Compute units are
+  // encoded per current connectivity so that starting the run object
+  // after setting arguments through the slots is not re-encoding.
+  std::vector<arg_slot>
+  get_arg_slots()
+  {
+    encode_compute_units();
+
+    auto setter = get_arg_setter();
+    std::vector<arg_slot> slots;
+    for (const auto& arg : kernel->get_args()) {
+      if (arg.index() == argument::no_index)
+        break;
+
+      auto location = m_module ? nullptr : setter->get_arg_location(arg);
+      slots.push_back({&arg, location});
+    }
+    return slots;
+  }
+
+  // Set global argument through a slot.  The connectivity of the
+  // buffer is not validated.
+  void
+  set_arg_slot(const arg_slot& slot, const xrt::bo& bo)
+  {
+    if (!slot.value) {
+      set_arg_value(*slot.arg, bo);
+      return;
+    }
+
+    auto addr = bo.address();
+    std::memcpy(slot.value, &addr, std::min(slot.arg->size(), sizeof(addr)));
+    cmd->bind_arg_at_index(slot.arg->index(), bo);
+  }
+
+  // Set scalar argument through a slot
+  void
+  set_arg_slot(const arg_slot& slot, const void* value, size_t bytes)
+  {
+    if (!slot.value) {
+      set_arg_value(*slot.arg, value, bytes);
+      return;
+    }
+
+    std::memcpy(slot.value, value, std::min(slot.arg->size(), bytes));
+  }
+
   void
   get_arg_at_index(size_t index, uint32_t* out, size_t bytes)
   {
@@ -2372,9 +2482,11 @@ public:
     XRT_DEBUG_CALL(debug_cmd_packet(kernel->get_name(), pkt));
   }
 
-  // start() - start the run object (execbuf)
+  // prep_submit() - prepare the run object for submission
+  //
+  // Common to start() and to batched start of multiple run objects.
   virtual void
-  start()
+  prep_submit()
   {
     if (m_runlist)
       throw xrt_core::error("Run object belongs to a runlist and cannot be explicitly started");
@@ -2387,6 +2499,13 @@ public:
     // constructing args in place
     // sending state as ERT_CMD_STATE_NEW for kernel start
     m_usage_logger->log_kernel_run_info(kernel.get(), this, ERT_CMD_STATE_NEW);
+  }
+
+  // start() - start the run object (execbuf)
+  void
+  start()
+  {
+    prep_submit();
     cmd->run();
   }
 
@@ -2549,7 +2668,7 @@ public:
 // Implements an argument setter override that writes kernel arguments
 // to mailbox using register_write.
 //
-// Overrides start() function to sync mailbox to HW compute unit
+// Overrides prep_submit() function to sync mailbox to HW compute unit
 // register map.
 class mailbox_impl : public run_impl
 {
@@ -2608,6 +2727,13 @@ class mailbox_impl : public run_impl
       mbox->kernel->read_register_n(arg.offset(), arg.size() / wsize, data32 + arg.offset() / wsize);
       return run_impl::hs_arg_setter::get_arg_value(arg);
     }
+
+    // mailbox must be written when an argument is set
+    uint8_t*
+    get_arg_location(const argument&) override
+    {
+      return nullptr;
+    }
   };
 
   void
@@ -2780,7 +2906,7 @@ public:
   }
 
   void
-  start() override
+  prep_submit() override
   {
     // sync command payload to mailbox if necessary
     write();
@@ -2790,8 +2916,8 @@ public:
     auto pkt = cmd->get_ert_packet();
     pkt->count = kernel->get_num_cumasks() + ap_ctrl_reserved;
 
-    // Regular start
-    run_impl::start();
+    // Regular start preparation
+    run_impl::prep_submit();
   }
 };
 
@@ -2898,6 +3024,37 @@ public:
   }
 };
 
+// class arg_plan_impl - Precompiled argument binding plan
+//
+// The plan resolves argument meta data and argument payload locations
+// of a run object once, such that subsequent setting of arguments by
+// index is a copy into the command payload without validation or
+// allocation.
+class arg_plan_impl
+{
+  std::shared_ptr<run_impl> m_run;
+  std::vector<run_impl::arg_slot> m_slots;
+
+public:
+  explicit
+  arg_plan_impl(std::shared_ptr<run_impl> run)
+    : m_run(std::move(run))
+    , m_slots(m_run->get_arg_slots())
+  {}
+
+  void
+  set_arg(size_t index, const xrt::bo& bo)
+  {
+    m_run->set_arg_slot(m_slots.at(index), bo);
+  }
+
+  void
+  set_arg(size_t index, const void* value, size_t bytes)
+  {
+    m_run->set_arg_slot(m_slots.at(index), value, bytes);
+  }
+};
+
 class run::command_error_impl
 {
 public:
@@ -2911,16 +3068,23 @@ public:
 
 // class runlist_impl - The internals of a runlist
 //
-// Execution of a runlist is carved into multiple
-// submissions of chained ert commands.  The size
-// of a chain is currently hardwired, but at some
-// point will be dyanmic.
+// Execution of a runlist is carved into multiple submissions of
+// chained ert commands.  The chained commands are built when the
+// runlist is executed after run objects have been added, at which
+// point the size of a chain is adapted to the length of the runlist
+// and the depth of the hardware queue.
+//
+// A runlist executed repeatedly with execute(iterations) alternates
+// between two banks of chained commands such that iteration N+1 is
+// submitted while iteration N drains.
 class runlist_impl
 {
-  static constexpr size_t submit_size = 24;
+  static constexpr size_t min_submit_size = 24;
   static constexpr size_t noidx = std::numeric_limits<size_t>::max();
-  static constexpr size_t execbuf_size = sizeof(ert_packet) + sizeof(ert_cmd_chain_data) + submit_size * sizeof(uint64_t);
+  static constexpr size_t execbuf_size = 4096;
+  static constexpr size_t max_submit_size = (execbuf_size - sizeof(ert_packet) - sizeof(ert_cmd_chain_data)) / sizeof(uint64_t);
   static constexpr size_t word_size = sizeof(uint32_t); // ert payload word size
+  static constexpr size_t max_banks = 2;
 
   // The runlist creates its own execution buffers, which are
   // ert_packets with payload interpreted as ert_cmd_chain_data
@@ -2928,6 +3092,17 @@ class runlist_impl
   using execbuf_type = xrt_core::bo_cache::cmd_bo<cmd_type>;
   xrt_core::bo_cache_t<execbuf_size> m_exec_buffer_cache;
 
+  // Commands are submitted in chained ert commands where the number
+  // of chained commands is at most 'm_submit_size'.  A bank owns the
+  // chained commands for all run objects in the runlist.  The
+  // commands are passed around as pointers. Successfully submitted
+  // chained commands are added to 'submitted_cmds' of the bank.
+  struct bank
+  {
+    std::vector<execbuf_type> cmds;
+    std::vector<execbuf_type*> submitted_cmds;
+  };
+
   enum class state { idle, closed, running, error };
   mutable state m_state = state::idle;
   
@@ -2936,14 +3111,13 @@ class runlist_impl
   std::vector<xrt::run> m_runlist;
   std::vector<xrt_core::buffer_handle*> m_bos;
 
-  // Commands are submitted in chained ert commands where the number
-  // of chained commands in less than 'submit_size'. The ert chained
-  // commands are created when run objects are added to the runlist.
-  // The created commands are owned by m_cmds, but passed around as
-  // pointers. Successfully submitted chained commands are added to
-  // m_submitted_cmds only after the runlist is closed.
-  std::vector<execbuf_type> m_cmds;
-  std::vector<execbuf_type*> m_submitted_cmds;
+  // Banks of chained commands and the banks currently submitted in
+  // order of submission.  The chained commands are rebuilt on
+  // execute if run objects were added since they were built.
+  std::array<bank, max_banks> m_banks;
+  std::vector<bank*> m_inflight;
+  size_t m_submit_size = min_submit_size;
+  bool m_rebuild = true;
 
   static const std::string&
   state_to_string(state st)
@@ -2984,19 +3158,81 @@ class runlist_impl
     return execbuf;
   }
 
-  // The chained command execbufs are created as needed
-  // when commands are added to the runlist.  Here we
-  // get the cmd that chains the run at specified index.
-  execbuf_type*
-  get_cmd_chain_for_run_at_index(size_t runidx)
+  // Number of run objects per chained command.  Chains are made as
+  // long as the hardware queue accepts to minimize submissions.  If
+  // the queue does not report a limit, chains are kept at the size
+  // accepted by all ERT firmware.  If the depth of the hardware queue
+  // is known, the runlist is spread over enough chains to fill half
+  // the queue, so that two iterations fit and execution of the first
+  // chain overlaps submission of the rest.  The chains are balanced
+  // to avoid a short remainder chain.
+  size_t
+  get_submit_size() const
+  {
+    if (auto size = xrt_core::config::get_runlist_chain_size())
+      return std::min<size_t>(size, max_submit_size);
+
+    auto max_chain = m_hwqueue.get_max_chain_size();
+    max_chain = max_chain ? std::min(max_chain, max_submit_size) : min_submit_size;
+
+    auto runs = m_runlist.size();
+    auto chains = (runs + max_chain - 1) / max_chain;
+    if (auto depth = m_hwqueue.get_queue_depth()) {
+      auto max_chains = (runs + min_submit_size - 1) / min_submit_size;
+      chains = std::max(chains, std::min(depth / max_banks, max_chains));
+    }
+
+    return (runs + chains - 1) / chains;
+  }
+
+  // Create the chained commands for all run objects in the runlist.
+  // The bank is changed only if all commands are created succesfully.
+  void
+  build_bank(bank& bk)
+  {
+    std::vector<execbuf_type> cmds;
+    cmds.reserve((m_bos.size() + m_submit_size - 1) / m_submit_size);
+
+    for (size_t runidx = 0; runidx < m_bos.size(); ++runidx) {
+      if (runidx % m_submit_size == 0)
+        cmds.push_back(create_exec_buf());
+
+      auto [cmd, pkt] = unpack(cmds.back());
+      auto chain_data = get_ert_cmd_chain_data(pkt);
+      auto run_bo = m_bos[runidx];
+      auto run_bo_props = run_bo->get_properties();
+
+      auto data_idx = chain_data->command_count;
+      chain_data->data[data_idx] = run_bo_props.kmhdl;
+
+      // Let shim handle binding of run_bo arguments to the command
+      // that chains the run_bo.  This allows pinning if necessary.
+      cmd->bind_at(data_idx, run_bo, 0, run_bo_props.size);
+
+      chain_data->command_count++;
+      pkt->count += sizeof(uint64_t) / word_size; // account for added command
+    }
+
+    bk.submitted_cmds.clear();
+    bk.submitted_cmds.reserve(cmds.size());
+    bk.cmds = std::move(cmds);
+  }
+
+  // Make sure the specified number of banks have chained commands
+  // for the current run objects.
+  void
+  build_banks(size_t banks)
   {
-    auto idx = runidx / submit_size;
-    if (idx < m_cmds.size())
-      return &m_cmds[idx];
+    if (m_rebuild) {
+      for (auto& bk : m_banks)
+        bk.cmds.clear();
+      m_submit_size = get_submit_size();
+      m_rebuild = false;
+    }
 
-    m_cmds.push_back(create_exec_buf());
-    m_submitted_cmds.reserve(m_cmds.size());
-    return &m_cmds.at(idx);
+    for (size_t idx = 0; idx < banks; ++idx)
+      if (m_banks[idx].cmds.empty())
+        build_bank(m_banks[idx]);
   }
 
   void
@@ -3028,17 +3264,17 @@ class runlist_impl
     return static_cast<ert_cmd_state>(pkt->state);
   }
 
-  // Wait for the last succesfully submitted command to complete.  If
-  // the last submitted command has completed (error or not), then
-  // in-order execution guarantees that all prior commands have
-  // completed (error or not).
+  // Wait for the last succesfully submitted command of a bank to
+  // complete.  If the last submitted command has completed (error or
+  // not), then in-order execution guarantees that all prior commands
+  // have completed (error or not).
   std::cv_status
-  wait_last_cmd(const std::chrono::milliseconds& timeout) const
+  wait_last_cmd(const bank& bk, const std::chrono::milliseconds& timeout) const
   {
-    if (m_submitted_cmds.empty())
+    if (bk.submitted_cmds.empty())
       return std::cv_status::no_timeout;
 
-    auto [cmd, pkt] = unpack(m_submitted_cmds.back());
+    auto [cmd, pkt] = unpack(bk.submitted_cmds.back());
     return m_hwqueue.wait(cmd, timeout);
   }
 
@@ -3053,10 +3289,10 @@ class runlist_impl
   poll_last_cmd() const
   {
     // Treat empty runlist as completed
-    if (m_submitted_cmds.empty())
+    if (m_inflight.empty() || m_inflight.back()->submitted_cmds.empty())
       return ERT_CMD_STATE_COMPLETED;
 
-    auto [cmd, pkt] = unpack(m_submitted_cmds.back());
+    auto [cmd, pkt] = unpack(m_inflight.back()->submitted_cmds.back());
 
     // For lazy state update the command must be polled. Polling
     // is a no-op on platforms where command state is live.
@@ -3065,34 +3301,30 @@ class runlist_impl
     return static_cast<ert_cmd_state>(pkt->state);
   }
 
-  // Wait for runlist to complete, then check each chained command
-  // submitted to determine potential error within chunk.  Locate the
-  // first failing command if any and mark all subsequent commands as
-  // aborted. Throw a runlist exception with first failing command if
-  // any.
-  std::cv_status
-  wait(const std::chrono::milliseconds& timeout) const
+  // Check each chained command submitted from a completed bank to
+  // determine potential error within chunk.  Locate the first failing
+  // command if any and mark all subsequent commands as aborted. Throw
+  // a runlist exception with first failing command if any.
+  void
+  check_bank(const bank& bk)
   {
-    // Wait on last chained command that was submitted; this implies
-    // all have finished.
-    if (wait_last_cmd(timeout) == std::cv_status::timeout)
-      return std::cv_status::timeout;
-
-    // All submitted commands have completed (error or not).  If any
-    // command failed to complete successfully, then all subsequent
-    // commands are marked aborted including any unsubmitted commands.
     size_t runidx = 0;
-    for (auto execbuf : m_submitted_cmds) {
+    for (auto execbuf : bk.submitted_cmds) {
       auto state = get_completed_state(execbuf, 1ms);
       if (state == ERT_CMD_STATE_COMPLETED) {
-        runidx += submit_size;
+        runidx += m_submit_size;
         continue;
       }
 
+      // Other banks may still be executing, the runlist cannot
+      // become idle before they have completed.
+      wait_last_cmd(*m_inflight.back(), 0ms);
+
       // The runlist is idle now but an exception will be thrown
       // with the first run object that failed.  The application
       // must handle the exception and decide what to do next.
       m_state = state::idle;
+      m_inflight.clear();
 
       // Get the index of the first failing run object in the chained
       // command structure.  The index in chain_data is relative to
@@ -3111,27 +3343,63 @@ class runlist_impl
       set_run_state(run, state);
       throw xrt::runlist::command_error(run, state, "runlist failed execution");
     }
+  }
+
+  // Wait for all submitted banks to complete, then check each bank
+  // in order of submission for errors.  Throws with the first
+  // failing command if any.
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout)
+  {
+    if (m_inflight.empty())
+      return std::cv_status::no_timeout;
 
+    // Wait on last chained command that was submitted; this implies
+    // all have finished.
+    if (wait_last_cmd(*m_inflight.back(), timeout) == std::cv_status::timeout)
+      return std::cv_status::timeout;
+
+    // All submitted commands have completed (error or not).  If any
+    // command failed to complete successfully, then all subsequent
+    // commands are marked aborted including any unsubmitted commands.
+    for (auto bk : m_inflight)
+      check_bank(*bk);
+
+    m_inflight.clear();
     return std::cv_status::no_timeout;
   }
 
-  // Submit runlist in chunks of submit size.  Make a note of last
-  // submitted command; in case of submit failure at least the last
+  // Wait for the oldest submitted bank to complete so that it can be
+  // resubmitted.  Throws with the first failing command if any.
+  void
+  drain_oldest()
+  {
+    auto bk = m_inflight.front();
+    wait_last_cmd(*bk, 0ms);
+    check_bank(*bk);
+    m_inflight.erase(m_inflight.begin());
+  }
+
+  // Submit runlist bank in chunks of submit size.  The bank is
+  // recorded as in flight once its first chained command is
+  // submitted; in case of submit failure at least the last
   // successfully submitted command must be waited for before the list
   // can be reset. Pre-condition ensured by execute() is that size of
   // runlist is greater than 0.
   void
-  submit()
+  submit(bank& bk)
   {
-    m_submitted_cmds.clear();
-    for (auto& execbuf : m_cmds) {
+    bk.submitted_cmds.clear();
+    for (auto& execbuf : bk.cmds) {
       auto [cmd, pkt] = unpack(execbuf);
       pkt->state = ERT_CMD_STATE_NEW;
-      // m_submitted commands reflect what has been successfully
-      // submitted to the hwqueue. Resize to avoid exception during
+      // submitted commands reflect what has been successfully
+      // submitted to the hwqueue. Reserved to avoid exception during
       // emplace_back after hwqueue::submit.
       m_hwqueue.submit(cmd); // can throw
-      m_submitted_cmds.emplace_back(&execbuf); // no throw reserved size
+      if (bk.submitted_cmds.empty())
+        m_inflight.push_back(&bk); // no throw reserved size
+      bk.submitted_cmds.emplace_back(&execbuf); // no throw reserved size
     }
   }
 
@@ -3149,7 +3417,9 @@ public:
     : m_exec_buffer_cache{hwctx.get_device().get_handle(), 128}
     , m_hwctx{std::move(hwctx)}
     , m_hwqueue{m_hwctx}
-  {}
+  {
+    m_inflight.reserve(max_banks);
+  }
 
   ~runlist_impl()
   {
@@ -3173,22 +3443,9 @@ public:
     m_runlist.reserve(runidx + 1);
     m_bos.reserve(runidx + 1);
 
-    auto execbuf = get_cmd_chain_for_run_at_index(runidx);
-    auto [cmd, pkt] = unpack(execbuf);
-    auto chain_data = get_ert_cmd_chain_data(pkt);
-    
     auto run_impl = run.get_handle();
     auto run_cmd = run_impl->get_cmd();
     auto run_bo = run_cmd->get_exec_bo();
-    auto run_bo_props = run_bo->get_properties();
-
-    auto data_idx = chain_data->command_count;
-    chain_data->data[data_idx] = run_bo_props.kmhdl;
-
-    // Let shim handle binding of run_bo arguments to the command
-    // that cahins the run_bo.  This allows pinning if necessary.
-    // May throw, but so far no state change, so still safe.
-    cmd->bind_at(data_idx, run_bo, 0, run_bo_props.size); 
 
     // Once a run object is added to a list it will be in a state that
     // makes it impossible to add to another list or to same list
@@ -3198,22 +3455,27 @@ public:
     // which is undefined behavior.  No exceptions after this point.
     run_impl->set_runlist(this);  // throws or changes state of run
 
-    // Non throwing state change
-    chain_data->command_count++;
-    pkt->count += sizeof(uint64_t) / word_size; // account for added command
+    // Non throwing state change.  The chained commands are rebuilt
+    // on next execute.
     m_runlist.push_back(std::move(run));  // move of shared_ptr is noexcept
     m_bos.push_back(run_bo);              // ptr noexcept
+    m_rebuild = true;
   }
 
   void
-  execute(const xrt::runlist& rl)
+  execute(const xrt::runlist& rl, size_t iterations)
   {
     if (m_state != state::idle)
       throw xrt_core::error("runlist must be idle before submitting for execution, current state: " + state_to_string(m_state));
 
-    if (m_runlist.empty())
+    if (m_runlist.empty() || iterations == 0)
       return;
 
+    // Create chained commands, one bank per iteration in flight.
+    // May throw, but so far no state change.
+    auto banks = std::min(iterations, max_banks);
+    build_banks(banks);
+
     // Prep each run object
     for (auto& run : m_runlist)
       run.get_handle()->prep_start();
@@ -3225,9 +3487,18 @@ public:
     // runlist is running.  This forces the user to call wait() even
     // as submit() throws.  The burden is on application to handle the
     // error properly while at least giving some hint as to where
-    // things failed.
+    // things failed.  Failing execution of an earlier iteration makes
+    // the runlist idle before the exception is thrown.
     try {
-      submit();
+      for (size_t iteration = 0; iteration < iterations; ++iteration) {
+        if (m_inflight.size() == banks)
+          drain_oldest(); // can throw command_error
+
+        submit(m_banks[iteration % banks]);
+      }
+    }
+    catch (const xrt::runlist::command_error&) {
+      throw;
     }
     catch (const std::exception&) {
       m_state = state::running;
@@ -3302,8 +3573,12 @@ public:
 
     m_runlist.clear();
     m_bos.clear();
-    m_submitted_cmds.clear();
-    m_cmds.clear();
+    m_inflight.clear();
+    for (auto& bk : m_banks) {
+      bk.submitted_cmds.clear();
+      bk.cmds.clear();
+    }
+    m_rebuild = true;
     m_state = state::idle;
   }
 };
@@ -3466,6 +3741,80 @@ get_mailbox_impl(const xrt::run& run)
   return mimpl;
 }
 
+// start_batch() - start a batch of run objects
+//
+// The run objects are prepared first, then grouped by hw queue and
+// by managed versus unmanaged execution.  Each group is submitted to
+// its hw queue with as few calls as possible.  If any run object
+// fails preparation, then none of the run objects are submitted.
+// If submission fails, then the run objects submitted before the
+// failure are running, the remaining run objects are reverted and
+// marked aborted.
+static void
+start_batch(const std::vector<xrt::run>& runs)
+{
+  struct group_type
+  {
+    xrt_core::hw_queue hwqueue;
+    bool managed;
+    std::vector<xrt_core::command*> cmds;
+  };
+
+  std::vector<group_type> groups;
+  std::vector<kernel_command*> prepped;
+  prepped.reserve(runs.size());
+  try {
+    for (const auto& run : runs) {
+      // Mark the command running before preparing the packet, such
+      // that a run object that is already running is rejected before
+      // its packet is modified
+      auto cmd = run.get_handle()->get_cmd();
+      auto managed = cmd->prep_run();
+      prepped.push_back(cmd);
+      run.get_handle()->prep_submit();
+
+      const auto& hwqueue = cmd->get_hw_queue();
+      auto itr = std::find_if(groups.begin(), groups.end(),
+                              [&hwqueue, managed](const auto& group) {
+                                return group.managed == managed
+                                  && group.hwqueue.get_handle() == hwqueue.get_handle();
+                              });
+      if (itr == groups.end())
+        itr = groups.insert(groups.end(), group_type{hwqueue, managed, {}});
+
+      itr->cmds.push_back(cmd);
+    }
+  }
+  catch (...) {
+    for (auto cmd : prepped)
+      cmd->cancel_run();
+    throw;
+  }
+
+  for (auto itr = groups.begin(); itr != groups.end(); ++itr) {
+    size_t submitted = 0;
+    try {
+      if (itr->managed)
+        itr->hwqueue.managed_start(itr->cmds, submitted);
+      else
+        itr->hwqueue.unmanaged_start(itr->cmds, submitted);
+    }
+    catch (...) {
+      // Revert the commands that were not submitted in this and
+      // remaining groups, such that they can be started again
+      auto abort = [](xrt_core::command* cmd) {
+        auto kcmd = static_cast<kernel_command*>(cmd);
+        kcmd->get_ert_packet()->state = ERT_CMD_STATE_ABORT;
+        kcmd->cancel_run();
+      };
+      std::for_each(itr->cmds.begin() + submitted, itr->cmds.end(), abort);
+      for (auto next = std::next(itr); next != groups.end(); ++next)
+        std::for_each(next->cmds.begin(), next->cmds.end(), abort);
+      throw;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////
 // Implementation helper for C API
 ////////////////////////////////////////////////////////////////
@@ -3978,7 +4327,15 @@ runlist::
 execute()
 {
   XRT_TRACE_POINT_SCOPE(xrt_runlist_execute);
-  handle->execute(*this);
+  handle->execute(*this, 1);
+}
+
+void
+runlist::
+execute(size_t iterations)
+{
+  XRT_TRACE_POINT_SCOPE(xrt_runlist_execute);
+  handle->execute(*this, iterations);
 }
 
 std::cv_status
@@ -4011,6 +4368,43 @@ reset()
   handle->reset();
 }
 
+void
+set_wait_policy(const xrt::run& run, const wait_policy& policy)
+{
+  auto spin_us = std::chrono::duration_cast<std::chrono::microseconds>(policy.spin).count();
+  auto yield_us = std::chrono::duration_cast<std::chrono::microseconds>(policy.yield).count();
+  run.get_handle()->get_cmd()->set_wait_policy
+    ({static_cast<uint32_t>(spin_us), static_cast<uint32_t>(yield_us)});
+}
+
+void
+start(const std::vector<xrt::run>& runs)
+{
+  xdp::native::profiling_wrapper
+    ("xrt::start", [&runs] {
+      start_batch(runs);
+    });
+}
+
+arg_plan::
+arg_plan(const xrt::run& run)
+  : detail::pimpl<arg_plan_impl>(std::make_shared<arg_plan_impl>(run.get_handle()))
+{}
+
+void
+arg_plan::
+set_arg(int index, const xrt::bo& bo)
+{
+  handle->set_arg(index, bo);
+}
+
+void
+arg_plan::
+set_arg(int index, const void* value, size_t bytes)
+{
+  handle->set_arg(index, value, bytes);
+}
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
@@ -23,12 +23,12 @@
 #include <elfio/elfio.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <numeric>
 #include <map>
-#include <set>
 #include <string>
 #include <sstream>
 
@@ -230,40 +230,200 @@ struct patcher
     bd_data_ptr[2] = (bd_data_ptr[2] & 0xFFFF0000) | (base_address >> 32);            // NOLINT
   }
 
+  // Number of bytes from a patch site modified by the patching
+  // scheme of this symbol.
+  size_t
+  patch_size() const
+  {
+    switch (m_symbol_type) {
+    case symbol_type::scalar_32bit_kind:
+      return sizeof(uint32_t);
+    case symbol_type::shim_dma_base_addr_symbol_kind:
+      return 9 * sizeof(uint32_t);  // bd words [0, 8]
+    case symbol_type::shim_dma_aie4_base_addr_symbol_kind:
+      return 2 * sizeof(uint32_t);  // bd words [0, 1]
+    case symbol_type::control_packet_48:
+      return 4 * sizeof(uint32_t);  // bd words [0, 3]
+    case symbol_type::shim_dma_48:
+      return 3 * sizeof(uint32_t);  // bd words [0, 2]
+    default:
+      return 0;
+    }
+  }
+
+  // Apply fn to each patch site.  The symbol type is resolved once
+  // by patch() and each scheme is a tight loop over the contiguous
+  // array of patch sites.
+  template <typename PatchFunction>
+  void
+  patch_each(uint8_t* base, PatchFunction&& fn)
+  {
+    for (const auto& item : m_ctrlcode_patchinfo)
+      fn(reinterpret_cast<uint32_t*>(base + item.offset_to_patch_buffer), item);
+  }
+
   void
   patch(uint8_t* base, uint64_t new_value)
   {
-    for (auto item : m_ctrlcode_patchinfo) {
-      auto bd_data_ptr = reinterpret_cast<uint32_t*>(base + item.offset_to_patch_buffer);
-      switch (m_symbol_type) {
-      case symbol_type::scalar_32bit_kind:
-        // new_value is a register value
+    switch (m_symbol_type) {
+    case symbol_type::scalar_32bit_kind:
+      // new_value is a register value
+      patch_each(base, [this, new_value](uint32_t* bd_data_ptr, const patch_info& item) {
         if (item.mask)
           patch32(bd_data_ptr, new_value, item.mask);
-        break;
-      case symbol_type::shim_dma_base_addr_symbol_kind:
-        // new_value is a bo address
+      });
+      break;
+    case symbol_type::shim_dma_base_addr_symbol_kind:
+      // new_value is a bo address
+      patch_each(base, [this, new_value](uint32_t* bd_data_ptr, const patch_info& item) {
         patch57(bd_data_ptr, new_value + item.offset_to_base_bo_addr);
-        break;
-      case symbol_type::shim_dma_aie4_base_addr_symbol_kind:
-        // new_value is a bo address
+      });
+      break;
+    case symbol_type::shim_dma_aie4_base_addr_symbol_kind:
+      // new_value is a bo address
+      patch_each(base, [this, new_value](uint32_t* bd_data_ptr, const patch_info& item) {
         patch57_aie4(bd_data_ptr, new_value + item.offset_to_base_bo_addr);
-        break;
-      case symbol_type::control_packet_48:
-        // new_value is a bo address
+      });
+      break;
+    case symbol_type::control_packet_48:
+      // new_value is a bo address
+      patch_each(base, [this, new_value](uint32_t* bd_data_ptr, const patch_info& item) {
         patch_ctrl48(bd_data_ptr, new_value + item.offset_to_base_bo_addr);
-        break;
-      case symbol_type::shim_dma_48:
-        // new_value is a bo address
+      });
+      break;
+    case symbol_type::shim_dma_48:
+      // new_value is a bo address
+      patch_each(base, [this, new_value](uint32_t* bd_data_ptr, const patch_info& item) {
         patch_shim48(bd_data_ptr, new_value + item.offset_to_base_bo_addr);
-        break;
-      default:
+      });
+      break;
+    default:
+      if (!m_ctrlcode_patchinfo.empty())
         throw std::runtime_error("Unsupported symbol type");
-      }
     }
   }
 };
 
+// struct arg_patch_plan - pre-resolved patchers for an argument
+//
+// The patchers of an argument are looked up by symbol name, or by
+// argument index if no symbol matches the name, once per buffer
+// type.  The plan caches the result of the lookup such that patching
+// the argument again is an array access per buffer type with no key
+// string construction or map lookup.
+struct arg_patch_plan
+{
+  static constexpr auto buf_type_count = static_cast<size_t>(patcher::buf_type::buf_type_count);
+
+  std::array<patcher*, buf_type_count> m_patchers {};
+  std::array<bool, buf_type_count> m_by_index {};  // resolved by argument index
+  bool m_resolved = false;
+
+  patcher*
+  get(patcher::buf_type type) const
+  {
+    return m_patchers[static_cast<size_t>(type)];
+  }
+
+  bool
+  by_index(patcher::buf_type type) const
+  {
+    return m_by_index[static_cast<size_t>(type)];
+  }
+
+  bool
+  empty() const
+  {
+    return std::none_of(m_patchers.begin(), m_patchers.end(), [](auto p) { return p != nullptr; });
+  }
+};
+
+// class dirty_ranges - byte ranges of a buffer patched since last sync
+//
+// Patching an argument modifies a few bytes at each patch site of the
+// argument.  Rather than syncing the entire control code buffer when
+// an argument changes, only the patched ranges are synced.  Ranges
+// closer than min_sync_gap are coalesced when they are added, so
+// repeated patching of the same sites between syncs does not grow the
+// tracked ranges.  The entire buffer is synced if the ranges cover
+// most of it, or if there are more than max_ranges disjoint ranges in
+// which case the ranges are no longer tracked.
+class dirty_ranges
+{
+  static constexpr size_t min_sync_gap = 4096;
+  static constexpr size_t max_ranges = 256;
+
+  std::map<size_t, size_t> m_ranges; // begin -> end, disjoint
+  bool m_all = false;                // sync entire buffer
+
+  void
+  insert(size_t begin, size_t end)
+  {
+    if (m_all)
+      return;
+
+    // First range that may coalesce with [begin, end)
+    auto itr = m_ranges.lower_bound(begin > min_sync_gap ? begin - min_sync_gap : 0);
+    if (itr != m_ranges.begin() && std::prev(itr)->second + min_sync_gap >= begin)
+      --itr;
+
+    while (itr != m_ranges.end() && itr->first <= end + min_sync_gap) {
+      begin = std::min(begin, itr->first);
+      end = std::max(end, itr->second);
+      itr = m_ranges.erase(itr);
+    }
+    m_ranges.emplace(begin, end);
+
+    if (m_ranges.size() > max_ranges) {
+      m_ranges.clear();
+      m_all = true;
+    }
+  }
+
+public:
+  // Record the patch sites of a patcher, return bytes patched
+  size_t
+  add(const patcher& ptchr)
+  {
+    auto size = ptchr.patch_size();
+    for (const auto& item : ptchr.m_ctrlcode_patchinfo)
+      insert(item.offset_to_patch_buffer, item.offset_to_patch_buffer + size);
+    return ptchr.m_ctrlcode_patchinfo.size() * size;
+  }
+
+  bool
+  empty() const
+  {
+    return !m_all && m_ranges.empty();
+  }
+
+  // Sync dirty ranges of bo to device, return bytes synced
+  size_t
+  sync(xrt::bo& bo)
+  {
+    if (empty())
+      return 0;
+
+    auto total = std::accumulate(m_ranges.begin(), m_ranges.end(), static_cast<size_t>(0),
+                                 [&bo](auto acc, const auto& range) {
+                                   return acc + std::min(range.second, bo.size()) - range.first;
+                                 });
+
+    if (m_all || total * 2 > bo.size()) {
+      m_ranges.clear();
+      m_all = false;
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      return bo.size();
+    }
+
+    for (auto [begin, end] : m_ranges)
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, std::min(end, bo.size()) - begin, begin);
+    m_ranges.clear();
+
+    return total;
+  }
+};
+
   XRT_CORE_UNUSED void
   dump_bo(xrt::bo& bo, const std::string& filename)
   {
@@ -282,6 +442,22 @@ struct patcher
     return argument_name + buf_string;
   }
 
+  void
+  log_patch(patcher::buf_type type, const std::string& argnm, size_t index, bool by_index, uint64_t patch)
+  {
+    if (!xrt_core::config::get_xrt_debug())
+      return;
+
+    std::stringstream ss;
+    ss << "Patched " << patcher::section_name_to_string(type);
+    if (by_index)
+      ss << " using argument index " << index;
+    else
+      ss << " using argument name " << argnm;
+    ss << " with value " << std::hex << patch;
+    xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+  }
+
 } // namespace
 
 namespace xrt
@@ -441,6 +617,18 @@ public:
     throw std::runtime_error("Not supported");
   }
 
+  // Resolve the patchers of an argument for all buffer types
+  //
+  // @param argname - argument name
+  // @param index - argument index
+  // @Return resolved plan with one patcher per buffer type, the
+  //  patcher of a buffer type is nullptr if the argument has none
+  virtual arg_patch_plan
+  resolve_arg_patch_plan(const std::string&, size_t)
+  {
+    throw std::runtime_error("Not supported");
+  }
+
   // Get the number of patchers for arguments.  The returned
   // value is the number of arguments that must be patched before
   // the control code can be executed.
@@ -464,6 +652,14 @@ public:
   {
     throw std::runtime_error("Not supported");
   }
+
+  // Get bytes of control code patched and synced to device for the
+  // most recent run start
+  virtual xrt_core::module_int::patch_counters
+  get_patch_counters() const
+  {
+    return {};
+  }
 };
 
 // class module_elf - Elf provided by application
@@ -837,36 +1033,44 @@ class module_elf : public module_impl
     return arg2patcher;
   }
 
+  // Find patcher for argument by name, or by index if no symbol
+  // matches the name.  Returns patcher and whether it was found by
+  // index.
+  std::pair<patcher*, bool>
+  find_patcher(const std::string& argnm, size_t index, patcher::buf_type type)
+  {
+    if (auto it = m_arg2patcher.find(generate_key_string(argnm, type)); it != m_arg2patcher.end())
+      return {&it->second, false};
+
+    if (auto it = m_arg2patcher.find(generate_key_string(std::to_string(index), type)); it != m_arg2patcher.end())
+      return {&it->second, true};
+
+    return {nullptr, false};
+  }
+
   bool
   patch(uint8_t* base, const std::string& argnm, size_t index, uint64_t patch, patcher::buf_type type) override
   {
-    const std::string key_string = generate_key_string(argnm, type);
-    auto it = m_arg2patcher.find(key_string);
-    auto not_found_use_argument_name = (it == m_arg2patcher.end());
-    if (not_found_use_argument_name) {// Search using index
-      auto index_string = std::to_string(index);
-      const std::string key_index_string = generate_key_string(index_string, type);
-      it = m_arg2patcher.find(key_index_string);
-      if (it == m_arg2patcher.end())
-        return false;
-    }
+    auto [patcher, by_index] = find_patcher(argnm, index, type);
+    if (!patcher)
+      return false;
 
-    it->second.patch(base, patch);
-    if (xrt_core::config::get_xrt_debug()) {
-      if (not_found_use_argument_name) {
-        std::stringstream ss;
-        ss << "Patched " << patcher::section_name_to_string(type) << " using argument index " << index << " with value " << std::hex << patch;
-        xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
-      }
-      else {
-        std::stringstream ss;
-        ss << "Patched " << patcher::section_name_to_string(type) << " using argument name " << argnm << " with value " << std::hex << patch;
-        xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
-      }
-    }
+    patcher->patch(base, patch);
+    log_patch(type, argnm, index, by_index, patch);
     return true;
   }
 
+  arg_patch_plan
+  resolve_arg_patch_plan(const std::string& argnm, size_t index) override
+  {
+    arg_patch_plan plan;
+    for (size_t type = 0; type < arg_patch_plan::buf_type_count; ++type)
+      std::tie(plan.m_patchers[type], plan.m_by_index[type]) =
+        find_patcher(argnm, index, static_cast<patcher::buf_type>(type));
+    plan.m_resolved = true;
+    return plan;
+  }
+
   [[nodiscard]] uint8_t
   get_os_abi() const override
   {
@@ -1045,14 +1249,31 @@ class module_sram : public module_impl
   // each column.
   std::vector<std::pair<uint64_t, uint64_t>> m_column_bo_address;
 
-  // Arguments patched in the ctrlcode buffer object
+  // Patch plans of arguments indexed by argument index, resolved
+  // when an argument is first patched.
+  std::vector<arg_patch_plan> m_arg_plans;
+
+  // Number of arguments patched in the ctrlcode buffer object
   // Must match number of argument patchers in parent module
-  std::set<std::string> m_patched_args;
+  size_t m_patched_args = 0;
+  std::vector<bool> m_arg_patched;
 
   // Dirty bit to indicate that patching was done prior to last
   // buffer sync to device.
   bool m_dirty{ false };
 
+  // Byte ranges patched since last sync per control code buffer
+  dirty_ranges m_buffer_dirty;
+  dirty_ranges m_instr_dirty;
+  dirty_ranges m_ctrlpkt_dirty;
+  dirty_ranges m_preempt_save_dirty;
+  dirty_ranges m_preempt_restore_dirty;
+
+  // Bytes patched and synced since the last run start, and the
+  // counters of the last run start
+  xrt_core::module_int::patch_counters m_counters;
+  xrt_core::module_int::patch_counters m_run_counters;
+
   union debug_flag_union {
     struct debug_mode_struct {
       uint32_t dump_control_codes     : 1;
@@ -1280,26 +1501,89 @@ class module_sram : public module_impl
     patch_instr_value(bo_ctrlcode, argnm, index, bo.address(), type);
   }
 
+  const arg_patch_plan&
+  get_arg_patch_plan(const std::string& argnm, size_t index)
+  {
+    if (index >= m_arg_plans.size()) {
+      m_arg_plans.resize(index + 1);
+      m_arg_patched.resize(index + 1);
+    }
+
+    auto& plan = m_arg_plans[index];
+    if (!plan.m_resolved)
+      plan = m_parent->resolve_arg_patch_plan(argnm, index);
+
+    return plan;
+  }
+
+  // Dirty range tracking of a control code buffer owned by this module
+  dirty_ranges&
+  get_dirty_ranges(const xrt::bo& bo)
+  {
+    if (&bo == &m_buffer)
+      return m_buffer_dirty;
+    if (&bo == &m_instr_bo)
+      return m_instr_dirty;
+    if (&bo == &m_ctrlpkt_bo)
+      return m_ctrlpkt_dirty;
+    if (&bo == &m_preempt_save_bo)
+      return m_preempt_save_dirty;
+    if (&bo == &m_preempt_restore_bo)
+      return m_preempt_restore_dirty;
+
+    throw std::runtime_error("internal error: patched buffer is not a control code buffer");
+  }
+
+  bool
+  patch_with_plan(const arg_patch_plan& plan, xrt::bo& bo, const std::string& argnm, size_t index, uint64_t value, patcher::buf_type type)
+  {
+    auto patcher = plan.get(type);
+    if (!patcher)
+      return false;
+
+    patcher->patch(bo.map<uint8_t*>(), value);
+    m_counters.bytes_patched += get_dirty_ranges(bo).add(*patcher);
+    log_patch(type, argnm, index, plan.by_index(type), value);
+    return true;
+  }
+
+  void
+  sync_dirty(xrt::bo& bo, dirty_ranges& dirty)
+  {
+    if (dirty.empty())
+      return;
+
+    m_counters.bytes_synced += dirty.sync(bo);
+    ++m_counters.syncs;
+  }
+
   void
   patch_value(const std::string& argnm, size_t index, uint64_t value)
   {
+    const auto& plan = get_arg_patch_plan(argnm, index);
+    if (plan.empty())
+      return;
+
     bool patched = false;
     if (m_parent->get_os_abi() == Elf_Amd_Aie2p) {
       // patch control-packet buffer
       if (m_ctrlpkt_bo) {
-        if (m_parent->patch(m_ctrlpkt_bo.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrldata))
+        if (patch_with_plan(plan, m_ctrlpkt_bo, argnm, index, value, patcher::buf_type::ctrldata))
           patched = true;
       }
 
       // patch instruction buffer
-      if (m_parent->patch(m_instr_bo.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrltext))
+      if (patch_with_plan(plan, m_instr_bo, argnm, index, value, patcher::buf_type::ctrltext))
           patched = true;
     }
-    else if (m_parent->patch(m_buffer.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrltext))
+    else if (patch_with_plan(plan, m_buffer, argnm, index, value, patcher::buf_type::ctrltext))
       patched = true;
 
     if (patched) {
-      m_patched_args.insert(argnm);
+      if (!m_arg_patched[index]) {
+        m_arg_patched[index] = true;
+        ++m_patched_args;
+      }
       m_dirty = true;
     }
   }
@@ -1307,7 +1591,8 @@ class module_sram : public module_impl
   void
   patch_instr_value(xrt::bo& bo, const std::string& argnm, size_t index, uint64_t value, patcher::buf_type type)
   {
-    if (!m_parent->patch(bo.map<uint8_t*>(), argnm, index, value, type))
+    auto plan = m_parent->resolve_arg_patch_plan(argnm, index);
+    if (!patch_with_plan(plan, bo, argnm, index, value, type))
       return;
 
     m_dirty = true;
@@ -1334,20 +1619,22 @@ class module_sram : public module_impl
   void
   sync_if_dirty() override
   {
-    if (!m_dirty)
+    if (!m_dirty) {
+      m_run_counters = {};
       return;
+    }
 
     auto os_abi = m_parent.get()->get_os_abi();
     if (os_abi == Elf_Amd_Aie2ps) {
-      if (m_patched_args.size() != m_parent->number_of_arg_patchers()) {
+      if (m_patched_args != m_parent->number_of_arg_patchers()) {
         auto fmt = boost::format("ctrlcode requires %d patched arguments, but only %d are patched")
-            % m_parent->number_of_arg_patchers() % m_patched_args.size();
+            % m_parent->number_of_arg_patchers() % m_patched_args;
         throw std::runtime_error{ fmt.str() };
       }
-      m_buffer.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      sync_dirty(m_buffer, m_buffer_dirty);
     }
     else if (os_abi == Elf_Amd_Aie2p) {
-      m_instr_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      sync_dirty(m_instr_bo, m_instr_dirty);
 
       if (is_dump_control_codes()) {
         std::string dump_file_name = "ctr_codes_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1359,7 +1646,7 @@ class module_sram : public module_impl
       }
 
       if (m_ctrlpkt_bo) {
-        m_ctrlpkt_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        sync_dirty(m_ctrlpkt_bo, m_ctrlpkt_dirty);
 
         if (is_dump_control_packet()) {
           std::string dump_file_name = "ctr_packet_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1372,8 +1659,8 @@ class module_sram : public module_impl
       }
 
       if (m_preempt_save_bo && m_preempt_restore_bo) {
-        m_preempt_save_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        m_preempt_restore_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        sync_dirty(m_preempt_save_bo, m_preempt_save_dirty);
+        sync_dirty(m_preempt_restore_bo, m_preempt_restore_dirty);
 
         if (is_dump_preemption_codes()) {
           std::string dump_file_name = "preemption_save_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1393,9 +1680,25 @@ class module_sram : public module_impl
       }
     }
 
+    m_run_counters = m_counters;
+    m_counters = {};
+
+    if (xrt_core::config::get_xrt_debug()) {
+      std::stringstream ss;
+      ss << "Control code patched " << m_run_counters.bytes_patched << " bytes, synced "
+         << m_run_counters.bytes_synced << " bytes in " << m_run_counters.syncs << " syncs";
+      xrt_core::message::send(xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+    }
+
     m_dirty = false;
   }
 
+  xrt_core::module_int::patch_counters
+  get_patch_counters() const override
+  {
+    return m_run_counters;
+  }
+
   uint32_t*
   fill_ert_aie2p(uint32_t *payload) const
   {
@@ -1579,6 +1882,12 @@ sync(const xrt::module& module)
   module.get_handle()->sync_if_dirty();
 }
 
+patch_counters
+get_patch_counters(const xrt::module& module)
+{
+  return module.get_handle()->get_patch_counters();
+}
+
 enum ert_cmd_opcode
 get_ert_opcode(const xrt::module& module)
 {
@@ -9,10 +9,12 @@
 #include "core/include/experimental/xrt_xclbin.h"
 
 #include "core/common/system.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
 #include "core/common/message.h"
 #include "core/common/module_loader.h"
 #include "core/common/query_requests.h"
+#include "core/common/xclbin_metadata_cache.h"
 #include "core/common/xclbin_parser.h"
 #include "core/common/xclbin_swemu.h"
 
@@ -25,8 +27,11 @@
 #include <boost/algorithm/string.hpp>
 
 #include <array>
+#include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <numeric>
 #include <regex>
 #include <set>
@@ -38,6 +43,10 @@
 # pragma warning( disable : 4244 4267 4996)
 #else
 # include <linux/uuid.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
 #endif
 
 namespace {
@@ -90,6 +99,84 @@ read_xclbin(const std::string& fnm)
   return read_file(path.string());
 }
 
+// class mapped_file - Read only memory mapping of a file
+//
+// The pages of the file are loaded on first access, so constructing
+// an xclbin from a mapped file does not read sections that are never
+// used.  The mapping is private and read only, the file must not be
+// truncated while it is mapped.
+class mapped_file
+{
+  const char* m_addr = nullptr;
+  size_t m_size = 0;
+
+public:
+  explicit
+  mapped_file(const std::string& fnm)
+  {
+#ifndef _WIN32
+    auto fd = ::open(fnm.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::runtime_error("Failed to open file '" + fnm + "' for reading");
+
+    struct stat st = {};
+    if (::fstat(fd, &st) < 0 || st.st_size <= 0) {
+      ::close(fd);
+      throw std::runtime_error("Failed to stat file '" + fnm + "'");
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    auto addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+      throw std::runtime_error("Failed to map file '" + fnm + "'");
+    m_addr = static_cast<const char*>(addr);
+#else
+    throw std::runtime_error("Memory mapped xclbin files are not supported");
+#endif
+  }
+
+  ~mapped_file()
+  {
+#ifndef _WIN32
+    if (m_addr)
+      ::munmap(const_cast<char*>(m_addr), m_size);
+#endif
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  const char*
+  data() const
+  {
+    return m_addr;
+  }
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+};
+
+static std::unique_ptr<mapped_file>
+map_xclbin(const std::string& fnm)
+{
+#ifndef _WIN32
+  if (!xrt_core::config::get_xclbin_mmap())
+    return nullptr;
+
+  if (fnm.empty())
+    throw std::runtime_error("No xclbin specified");
+
+  auto path = xrt_core::environment::platform_path(fnm);
+  return std::make_unique<mapped_file>(path.string());
+#else
+  return nullptr;
+#endif
+}
+
 static std::vector<char>
 copy_axlf(const axlf* top)
 {
@@ -440,29 +527,40 @@ class xclbin_impl
       return ips;
     }
 
+    // init_xml_metadata() - extract project and kernel meta data
+    //
+    // The xml meta data is parsed or read from the persistent meta
+    // data cache if enabled.
+    static xrt_core::xclbin::xml_metadata
+    init_xml_metadata(const xclbin_impl* ximpl)
+    {
+      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
+      if (!xml.first)
+        return {};
+
+      return xrt_core::xclbin::metadata_cache::get(ximpl->get_uuid(), xml.first, xml.second);
+    }
+
     // init_kernels() - populate m_kernels with xclbin::kernel objects
     //
-    // Iterate the XML meta data section and collect kernel meta data along
-    // with compute units grouped by the kernel.
+    // Collect kernel meta data from the XML meta data along with
+    // compute units grouped by the kernel.
     //
     // Pre-condition for this function is that init_mems() and init_ips()
     // have been called.
     static std::vector<xclbin::kernel>
-    init_kernels(const xclbin_impl* ximpl, const std::vector<xclbin::ip>& ips)
+    init_kernels(xrt_core::xclbin::xml_metadata& xml, const std::vector<xclbin::ip>& ips)
     {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      if (!xml.first)
-        return {};
-
-      // get kernel CUs from xclbin meta data
       std::vector<xclbin::kernel> kernels;
-      for (auto& kernel : xrt_core::xclbin::get_kernels(xml.first, xml.second)) {
-        auto props = xrt_core::xclbin::get_kernel_properties(xml.first, xml.second, kernel.name);
+      kernels.reserve(xml.kernels.size());
+      for (auto& kernel : xml.kernels) {
+        xrt_core::xclbin::apply_ini_overrides(kernel.properties);
+        auto name = kernel.properties.name;
         std::vector<xclbin::ip> cus;
-        copy_if_name_match(ips.begin(), ips.end(), std::back_inserter(cus), kernel.name);
+        copy_if_name_match(ips.begin(), ips.end(), std::back_inserter(cus), name);
         kernels.emplace_back
           (std::make_shared<xclbin::kernel_impl>
-           (std::move(kernel.name), std::move(props), std::move(cus), std::move(kernel.args)));
+           (std::move(name), std::move(kernel.properties), std::move(cus), std::move(kernel.args)));
       }
 
       return kernels;
@@ -480,24 +578,6 @@ class xclbin_impl
       return aie_partitions;
     }
 
-    static std::string
-    init_project_name(const xclbin_impl* ximpl)
-    {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      return xml.first
-        ? xrt_core::xclbin::get_project_name(xml.first, xml.second)
-        : "";
-    }
-
-    static std::string
-    init_fpga_device_name(const xclbin_impl* ximpl)
-    {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      return xml.first
-        ? xrt_core::xclbin::get_fpga_device_name(xml.first, xml.second)
-        : "";
-    }
-
     // init_mem_encoding() - compress memory indices
     //
     // Mapping from memory index to encoded index.  The compressed
@@ -571,12 +651,16 @@ class xclbin_impl
     // xclbin_info() - constructor for xclbin meta data
     explicit
     xclbin_info(const xrt::xclbin_impl* impl)
+      : xclbin_info(impl, init_xml_metadata(impl))
+    {}
+
+    xclbin_info(const xrt::xclbin_impl* impl, xrt_core::xclbin::xml_metadata xml)
       : m_ximpl(impl)
-      , m_project_name(init_project_name(m_ximpl))
-      , m_fpga_device_name(init_fpga_device_name(m_ximpl))
+      , m_project_name(std::move(xml.project_name))
+      , m_fpga_device_name(std::move(xml.fpga_device_name))
       , m_mems(init_mems(m_ximpl))
       , m_ips(init_ips(m_ximpl, m_mems))
-      , m_kernels(init_kernels(m_ximpl, m_ips))
+      , m_kernels(init_kernels(xml, m_ips))
       , m_aie_partitions(init_aie_partitions(m_ximpl))
       , m_membank_encoding(init_mem_encoding(m_mems))
     {}
@@ -755,20 +839,36 @@ public:
 // binary images for file content
 class xclbin_full : public xclbin_impl
 {
-  std::vector<char> m_axlf;    // complete copy of xclbin raw data
+  std::unique_ptr<mapped_file> m_mapped; // mapped xclbin file if any
+  std::vector<char> m_axlf;    // complete copy of xclbin raw data if not mapped
+  const char* m_data = nullptr;  // raw data, mapped or copied
+  size_t m_size = 0;             // size of raw data
   const axlf* m_top = nullptr; // axlf pointer to the raw data
   uuid m_uuid;                 // uuid of xclbin
   uuid m_intf_uuid;
 
-  // sections within this xclbin
-  std::multimap<axlf_section_kind, std::vector<char>> m_axlf_sections;
+  // index of sections within this xclbin, the sections are views
+  // of the raw data
+  std::multimap<axlf_section_kind, std::pair<const char*, size_t>> m_axlf_sections;
+
+  // sections that are not aligned within the raw data are copied so
+  // they can be accessed through their section structs
+  std::vector<std::vector<uint64_t>> m_aligned_sections;
 
   void
   emplace_section(const axlf_section_header* hdr, axlf_section_kind kind)
   {
-    auto section_data = reinterpret_cast<const char*>(m_top) + hdr->m_sectionOffset;
-    std::vector<char> data{section_data, section_data + hdr->m_sectionSize};
-    m_axlf_sections.emplace(kind , std::move(data));
+    if (hdr->m_sectionOffset > m_size || hdr->m_sectionSize > m_size - hdr->m_sectionOffset)
+      throw std::runtime_error("Invalid xclbin, section " + std::to_string(kind) + " is out of bounds");
+
+    auto section_data = m_data + hdr->m_sectionOffset;
+    auto section_size = static_cast<size_t>(hdr->m_sectionSize);
+    if (reinterpret_cast<uintptr_t>(section_data) % alignof(uint64_t)) {
+      auto& copy = m_aligned_sections.emplace_back((section_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+      std::memcpy(copy.data(), section_data, section_size);
+      section_data = reinterpret_cast<const char*>(copy.data());
+    }
+    m_axlf_sections.emplace(kind, std::make_pair(section_data, section_size));
   }
 
   void
@@ -783,9 +883,21 @@ class xclbin_full : public xclbin_impl
   void
   init_axlf()
   {
-    const axlf* tmp = reinterpret_cast<const axlf*>(m_axlf.data());
+    if (!m_mapped) {
+      m_data = m_axlf.data();
+      m_size = m_axlf.size();
+    }
+    if (m_size < sizeof(axlf))
+      throw std::runtime_error("Invalid xclbin");
+
+    const axlf* tmp = reinterpret_cast<const axlf*>(m_data);
     if (strncmp(tmp->m_magic, "xclbin2", strlen("xclbin2")) != 0) // Future: Do not hardcode "xclbin2"
       throw std::runtime_error("Invalid xclbin");
+
+    // Section headers are read in place, they must be within the data
+    auto headers_size = static_cast<uint64_t>(tmp->m_header.m_numSections) * sizeof(axlf_section_header);
+    if (headers_size > m_size - offsetof(axlf, m_sections))
+      throw std::runtime_error("Invalid xclbin, section headers are out of bounds");
     m_top = tmp;
 
     m_uuid = uuid(m_top->m_header.uuid);
@@ -814,8 +926,15 @@ class xclbin_full : public xclbin_impl
 public:
   explicit
   xclbin_full(const std::string& filename)
-    : m_axlf(read_xclbin(filename))
+    : m_mapped(map_xclbin(filename))
   {
+    if (m_mapped) {
+      m_data = m_mapped->data();
+      m_size = m_mapped->size();
+    }
+    else
+      m_axlf = read_xclbin(filename);
+
     init();
   }
 
@@ -833,6 +952,18 @@ public:
     init();
   }
 
+  // The xml parser caches meta data parsed from the embedded xml,
+  // release it along with the xml
+  ~xclbin_full()
+  {
+    try {
+      auto xml = get_axlf_section(EMBEDDED_METADATA);
+      xrt_core::xclbin::release_xml_metadata(xml.first, xml.second);
+    }
+    catch (...) {
+    }
+  }
+
   uuid
   get_uuid() const override
   {
@@ -875,7 +1006,7 @@ public:
   {
     auto itr = m_axlf_sections.find(kind);
     return itr != m_axlf_sections.end()
-      ? std::make_pair((*itr).second.data(), (*itr).second.size())
+      ? (*itr).second
       : std::make_pair(nullptr, size_t(0));
   }
 
@@ -890,7 +1021,7 @@ public:
       std::vector<std::pair<const char*, size_t>> return_sections;
 
       for (auto itr = result.first; itr != result.second; itr++)
-        return_sections.emplace_back(std::make_pair(itr->second.data(), itr->second.size()));
+        return_sections.emplace_back(itr->second);
 
       return return_sections;
     }
@@ -5,14 +5,19 @@
 #ifndef core_common_bo_cache_h_
 #define core_common_bo_cache_h_
 
-#include "core/common/system.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
+#include "core/common/message.h"
+#include "core/common/system.h"
 #include "core/common/shim/buffer_handle.h"
 #include "core/include/ert.h"
 
-#include <vector>
-#include <utility>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning( push )
@@ -21,8 +26,18 @@
 
 namespace xrt_core {
 
-// Create a cache of CMD BO objects -- for now only used for M2M -- to reduce
-// the overhead of BO life cycle management.
+// Create a cache of CMD BO objects to reduce the overhead of BO life
+// cycle management.
+//
+// The cache is striped into a fixed number of mutex protected shards
+// in front of a shared back pool.  Host threads are assigned a shard
+// round robin on first use, and allocate from and release to that
+// shard, so concurrent threads mostly lock different mutexes.  Threads
+// beyond the number of shards share shards.  The back pool is used
+// only when a shard is empty or full.  The shards are owned by the
+// cache such that cached BOs never outlive the device that allocated
+// them.  The high-water mark bounds the total number of cached BOs,
+// shards and back pool combined.
 template <size_t BoSize>
 class bo_cache_t {
 public:
@@ -30,31 +45,83 @@ public:
   // pair is immutable. The clients should not change the contents of cmd_bo.
   template <typename CommandType>
   using cmd_bo = std::pair<std::unique_ptr<buffer_handle>, CommandType *const>;
+
+  // struct stats - cache counters
+  //
+  // @thread_hits: allocations served by the calling thread's shard
+  // @pool_hits: allocations served by the shared back pool
+  // @misses: allocations that required a new BO
+  // @destroyed: released BOs that were destroyed because cache was full
+  struct stats
+  {
+    uint64_t thread_hits;
+    uint64_t pool_hits;
+    uint64_t misses;
+    uint64_t destroyed;
+  };
+
 private:
+  static constexpr size_t num_shards = 16;
+
+  struct alignas(64) shard
+  {
+    std::mutex mutex;
+    std::vector<cmd_bo<void>> bos;
+  };
 
   // We are really allocating a page size as that is what xocl/zocl do. Note on
   // POWER9 pagesize maybe more than 4K, xocl would upsize the allocation to the
   // correct pagesize. unmap always unmaps the full page.
   static constexpr size_t m_bo_size = BoSize;
   std::shared_ptr<device> m_device;
-  // Maximum number of BOs that can be cached in the pool. Value of 0 indicates
-  // caching should be disabled.
+  // Maximum number of BOs that can be cached in shards and pool. Value of 0
+  // indicates caching should be disabled.
   const unsigned int m_cache_max_size;
+  // Maximum number of BOs cached per thread shard.
+  const unsigned int m_shard_max_size;
   std::vector<cmd_bo<void>> m_cmd_bo_cache;
   std::mutex m_mutex;
+  std::array<shard, num_shards> m_shards;
+  // Number of BOs currently cached in shards and pool
+  std::atomic<unsigned int> m_cached {0};
+
+  std::atomic<uint64_t> m_thread_hits {0};
+  std::atomic<uint64_t> m_pool_hits {0};
+  std::atomic<uint64_t> m_misses {0};
+  std::atomic<uint64_t> m_destroyed {0};
+
+  // Shard assigned to calling thread.  Threads are assigned shards
+  // round robin on first use, the assignment is shared by all caches.
+  static shard&
+  get_shard(std::array<shard, num_shards>& shards)
+  {
+    static std::atomic<unsigned int> count {0};
+    static thread_local unsigned int idx = count++ % num_shards;
+    return shards[idx];
+  }
 
 public:
   bo_cache_t(std::shared_ptr<xrt_core::device> device, unsigned int max_size)
-    : m_device(std::move(device)), m_cache_max_size(max_size)
+    : m_device(std::move(device))
+    , m_cache_max_size(config::get_exec_buffer_cache_high_water(BoSize, max_size))
+    , m_shard_max_size(std::min(m_cache_max_size, config::get_exec_buffer_cache_thread_size()))
   {}
 
   bo_cache_t(xclDeviceHandle handle, unsigned int max_size)
-    : m_device(get_userpf_device(handle)), m_cache_max_size(max_size)
+    : bo_cache_t(get_userpf_device(handle), max_size)
   {}
 
   ~bo_cache_t()
   {
     try {
+      if (config::get_exec_buffer_cache_stats())
+        report();
+
+      for (auto& s : m_shards) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (auto& bo : s.bos)
+          destroy(bo);
+      }
       std::lock_guard<std::mutex> lock(m_mutex);
       for (auto& bo : m_cmd_bo_cache)
         destroy(bo);
@@ -63,6 +130,11 @@ public:
     }
   }
 
+  bo_cache_t(const bo_cache_t&) = delete;
+  bo_cache_t(bo_cache_t&&) = delete;
+  bo_cache_t& operator=(const bo_cache_t&) = delete;
+  bo_cache_t& operator=(bo_cache_t&&) = delete;
+
   template<typename T>
   cmd_bo<T>
   alloc()
@@ -78,36 +150,87 @@ public:
     release_impl(std::make_pair(std::move(bo.first), static_cast<void *>(bo.second)));
   }
 
+  // size() - Number of BOs currently cached, never above high-water mark
+  unsigned int
+  size() const
+  {
+    return m_cached.load();
+  }
+
+  stats
+  get_stats() const
+  {
+    return { m_thread_hits.load(), m_pool_hits.load(), m_misses.load(), m_destroyed.load() };
+  }
+
 private:
   cmd_bo<void>
   alloc_impl()
   {
+    if (m_shard_max_size) {
+      // First look up in the calling thread's shard
+      auto& s = get_shard(m_shards);
+      std::lock_guard lock(s.mutex);
+      if (!s.bos.empty()) {
+        auto bo = std::move(s.bos.back());
+        s.bos.pop_back();
+        m_cached.fetch_sub(1, std::memory_order_relaxed);
+        m_thread_hits.fetch_add(1, std::memory_order_relaxed);
+        return bo;
+      }
+    }
+
     if (m_cache_max_size) {
-      // If caching is enabled first look up in the BO cache
+      // If caching is enabled look up in the shared BO cache
       std::lock_guard lock(m_mutex);
       if (!m_cmd_bo_cache.empty()) {
         auto bo = std::move(m_cmd_bo_cache.back());
         m_cmd_bo_cache.pop_back();
+        m_cached.fetch_sub(1, std::memory_order_relaxed);
+        m_pool_hits.fetch_add(1, std::memory_order_relaxed);
         return bo;
       }
     }
 
+    m_misses.fetch_add(1, std::memory_order_relaxed);
     auto execHandle = m_device->alloc_bo(m_bo_size, XCL_BO_FLAGS_EXECBUF);
     auto map = execHandle->map(buffer_handle::map_type::write);
     return std::make_pair(std::move(execHandle), map);
   }
 
+  // Reserve room for one more cached BO, returns false if the cache
+  // is at its high-water mark
+  bool
+  reserve()
+  {
+    auto cached = m_cached.load(std::memory_order_relaxed);
+    while (cached < m_cache_max_size)
+      if (m_cached.compare_exchange_weak(cached, cached + 1, std::memory_order_relaxed))
+        return true;
+    return false;
+  }
+
   void
   release_impl(cmd_bo<void>&& bo)
   {
-    if (m_cache_max_size) {
-      // If caching is enabled and BO cache is not fully populated add this the cache
-      std::lock_guard lock(m_mutex);
-      if (m_cmd_bo_cache.size() < m_cache_max_size) {
-        m_cmd_bo_cache.push_back(std::move(bo));
-        return;
+    if (reserve()) {
+      if (m_shard_max_size) {
+        // Return to the calling thread's shard if not full
+        auto& s = get_shard(m_shards);
+        std::lock_guard lock(s.mutex);
+        if (s.bos.size() < m_shard_max_size) {
+          s.bos.push_back(std::move(bo));
+          return;
+        }
       }
+
+      // Shard is full, add to the shared BO cache
+      std::lock_guard lock(m_mutex);
+      m_cmd_bo_cache.push_back(std::move(bo));
+      return;
     }
+
+    m_destroyed.fetch_add(1, std::memory_order_relaxed);
     destroy(bo);
   }
 
@@ -116,6 +239,19 @@ private:
   {
     bo.first->unmap(bo.second);
   }
+
+  void
+  report() const
+  {
+    auto st = get_stats();
+    message::send(message::severity_level::info, "XRT",
+                  "exec buffer cache(%zu): thread_hits(%llu) pool_hits(%llu) misses(%llu) destroyed(%llu)",
+                  m_bo_size,
+                  static_cast<unsigned long long>(st.thread_hits),
+                  static_cast<unsigned long long>(st.pool_hits),
+                  static_cast<unsigned long long>(st.misses),
+                  static_cast<unsigned long long>(st.destroyed));
+  }
 };
 
 using bo_cache = bo_cache_t<4096>;
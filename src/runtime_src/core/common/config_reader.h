@@ -233,6 +233,26 @@ get_trace_file_dump_interval_s()
   return value;
 }
 
+// Device trace file format, "csv" or "binary".  Binary device trace
+// is streamed while the application runs and can be converted to
+// csv with xrt_device_trace_convert.
+inline std::string
+get_device_trace_file_format()
+{
+  static std::string value = detail::get_string_value("Debug.device_trace_file_format", "csv");
+  return value;
+}
+
+// Number of threads logging decoded PL trace packets.  Packets are
+// split by compute unit so each thread owns all monitors of a compute
+// unit.  0 picks one thread per compute unit up to the number of cores.
+inline unsigned int
+get_device_trace_decode_threads()
+{
+  static unsigned int value = detail::get_uint_value("Debug.device_trace_decode_threads", 0);
+  return value;
+}
+
 inline std::string
 get_trace_buffer_size()
 {
@@ -364,6 +384,36 @@ get_use_xclbin_group_sections()
   return value;
 }
 
+// Map xclbin files into memory instead of reading them.  Sections are
+// then only paged in when accessed, but the file must not be modified
+// or truncated while an xclbin object constructed from it is alive.
+inline bool
+get_xclbin_mmap()
+{
+  static bool value = detail::get_bool_value("Runtime.xclbin_mmap",false);
+  return value;
+}
+
+// Persist xml meta data extracted from an xclbin in an on-disk cache
+// keyed by xclbin uuid.  Processes loading the same xclbin later read
+// the cached meta data instead of parsing the xml.
+inline bool
+get_xclbin_metadata_cache()
+{
+  static bool value = detail::get_bool_value("Runtime.xclbin_metadata_cache",false);
+  return value;
+}
+
+// Directory for xclbin meta data cache files.  Empty selects
+// $XDG_CACHE_HOME/xrt, or $HOME/.cache/xrt if XDG_CACHE_HOME is unset
+// (%LOCALAPPDATA%\xrt on Windows).
+inline std::string
+get_xclbin_metadata_cache_dir()
+{
+  static std::string value = detail::get_string_value("Runtime.xclbin_metadata_cache_dir","");
+  return value;
+}
+
 inline std::string
 get_logging()
 {
@@ -600,6 +650,29 @@ get_noop_completion_delay_us()
   return delay;
 }
 
+/**
+ * Busy poll command state for specified number of microseconds
+ * before blocking when waiting for an unmanaged command to complete.
+ */
+inline unsigned int
+get_wait_spin_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.wait_spin_us", 0);
+  return value;
+}
+
+/**
+ * Poll command state while yielding the cpu for specified number of
+ * microseconds after busy polling and before blocking when waiting
+ * for an unmanaged command to complete.
+ */
+inline unsigned int
+get_wait_yield_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.wait_yield_us", 0);
+  return value;
+}
+
 /**
  * Set CMD BO cache size. CUrrently it is only used in xclCopyBO()
  */
@@ -610,6 +683,68 @@ get_cmdbo_cache()
   return value;
 }
 
+/**
+ * Number of exec buffers cached per thread shard in front of the
+ * shared exec buffer cache.  Value of 0 disables the thread shards.
+ * Buffers in thread shards count against the cache high-water mark.
+ */
+inline unsigned int
+get_exec_buffer_cache_thread_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_buffer_cache_thread_size",4);
+  return value;
+}
+
+/**
+ * High-water mark of shared exec buffer cache for buffers of
+ * specified size.  The key is suffixed with the buffer size, e.g.
+ * Runtime.exec_buffer_cache_high_water_4096.  Returns argument
+ * default value if not specified.
+ */
+inline unsigned int
+get_exec_buffer_cache_high_water(size_t bo_size, unsigned int default_value)
+{
+  auto key = std::string("Runtime.exec_buffer_cache_high_water_") + std::to_string(bo_size);
+  return detail::get_uint_value(key.c_str(), default_value);
+}
+
+/**
+ * Report exec buffer cache hit and miss counters when a cache is
+ * destroyed.
+ */
+inline bool
+get_exec_buffer_cache_stats()
+{
+  static bool value = detail::get_bool_value("Runtime.exec_buffer_cache_stats",false);
+  return value;
+}
+
+/**
+ * Number of run objects per chained command of a runlist.  The
+ * default, 0, adapts the chain size to the length of the runlist, the
+ * depth of the hardware queue, and the chain size limit of the
+ * hardware queue.  A non-zero value is not checked against the limit
+ * of the hardware queue.
+ */
+inline unsigned int
+get_runlist_chain_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.runlist_chain_size",0);
+  return value;
+}
+
+/**
+ * Number of worker threads used to execute asynchronous buffer
+ * object sync operations (xrt::bo::async).  Operations on the same
+ * buffer object are always executed in order by the same worker.
+ */
+inline unsigned int
+get_bo_async_workers()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.bo_async_workers",2);
+  return value;
+}
+
 inline std::string
 get_hw_em_driver()
 {
@@ -33,12 +33,18 @@
 # pragma warning (pop)
 #endif
 
+#include <algorithm>
+#include <condition_variable>
 #include <istream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning (disable: 4100 4189 4505)
@@ -931,7 +937,17 @@ public:
     , m_execution{m_resources, m_recipe.get_child("execution")}
   {}
 
-  recipe(const recipe&) = default;
+  // Create a new instance of other.  The instance shares device,
+  // hardware context, kernels, and cpu functions with other, but has
+  // its own internal buffers and its own runs recreated from the
+  // execution section of the recipe.  External buffers are unbound.
+  recipe(const recipe& other)
+    : m_device{other.m_device}
+    , m_recipe{other.m_recipe}
+    , m_header{other.m_header}
+    , m_resources{other.m_resources}
+    , m_execution{m_resources, m_recipe.get_child("execution")}
+  {}
 
   void
   bind_input(const std::string& name, const xrt::bo& bo)
@@ -982,16 +998,24 @@ namespace xrt_core {
 // class runner_impl -
 //
 // A runner implementation is default created with one instance of a
-// recipe.  But the runner can be used by multiple threads and new
-// recipe instances are created for each thread as needed.
+// recipe, which is used by the runner member functions.
+//
+// Additional recipe instances are created on demand for threads that
+// acquire an instance through runner::acquire().  Released instances
+// are kept in a pool for reuse, the number of concurrently acquired
+// instances is limited by m_max_instances.
 //
 // The runner can be created from any thread, but member functions
-// are thread specific.
+// operating on the default recipe instance are not thread safe.
 class runner_impl
 {
-  //std::map<std::thread::id, recipe> m_recipes;
   recipe m_recipe;
-  //thread_local recipe m_thread_recipe;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<std::unique_ptr<recipe>> m_idle; // released instances
+  size_t m_instances = 0;                      // created instances
+  size_t m_max_instances = std::max(1u, std::thread::hardware_concurrency());
 
 public:
   runner_impl(const xrt::device& device, const std::string& recipe)
@@ -1031,6 +1055,112 @@ public:
   {
     m_recipe.wait();
   }
+
+  // Acquire an idle instance or create a new one if limit allows.
+  // The new instance is created outside the lock.
+  std::unique_ptr<recipe>
+  acquire()
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_cv.wait(lk, [this] { return !m_idle.empty() || m_instances < m_max_instances; });
+    if (!m_idle.empty()) {
+      auto instance = std::move(m_idle.back());
+      m_idle.pop_back();
+      return instance;
+    }
+
+    ++m_instances;
+    lk.unlock();
+
+    try {
+      return std::make_unique<recipe>(m_recipe);
+    }
+    catch (...) {
+      discard();
+      throw;
+    }
+  }
+
+  // Return an instance to the pool
+  void
+  release(std::unique_ptr<recipe> instance)
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      if (m_instances > m_max_instances)
+        --m_instances; // limit was lowered, destroy the instance
+      else
+        m_idle.push_back(std::move(instance));
+    }
+    m_cv.notify_one();
+  }
+
+  // Forget an acquired instance that is not returned to the pool
+  void
+  discard()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      --m_instances;
+    }
+    m_cv.notify_one();
+  }
+
+  void
+  set_max_instances(size_t max)
+  {
+    if (!max)
+      throw std::runtime_error("runner max instances must be at least 1");
+
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_max_instances = max;
+      while (m_idle.size() > m_max_instances) {
+        m_idle.pop_back();
+        --m_instances;
+      }
+    }
+    m_cv.notify_all();
+  }
+};
+
+// class runner::instance_impl - an acquired recipe instance
+//
+// Returns the recipe instance to the runner when destroyed.  An
+// instance whose execution failed is discarded rather than reused
+// since its runs may be in an undefined state.
+class runner::instance_impl
+{
+  std::shared_ptr<runner_impl> m_runner;
+  std::unique_ptr<recipe> m_recipe;
+
+public:
+  instance_impl(std::shared_ptr<runner_impl> runner, std::unique_ptr<recipe> instance)
+    : m_runner{std::move(runner)}
+    , m_recipe{std::move(instance)}
+  {}
+
+  instance_impl(const instance_impl&) = delete;
+  instance_impl(instance_impl&&) = delete;
+  instance_impl& operator=(const instance_impl&) = delete;
+  instance_impl& operator=(instance_impl&&) = delete;
+
+  ~instance_impl()
+  {
+    try {
+      m_recipe->wait();
+      m_runner->release(std::move(m_recipe));
+    }
+    catch (...) {
+      m_runner->discard();
+    }
+  }
+
+  recipe*
+  operator->() const
+  {
+    return m_recipe.get();
+  }
 };
 
 ////////////////////////////////////////////////////////////////
@@ -1083,4 +1213,61 @@ wait()
   m_impl->wait();
 }
 
+runner::instance
+runner::
+acquire()
+{
+  return instance{std::make_shared<instance_impl>(m_impl, m_impl->acquire())};
+}
+
+void
+runner::
+set_max_instances(size_t max)
+{
+  m_impl->set_max_instances(max);
+}
+
+////////////////////////////////////////////////////////////////
+// Public runner instance APIs
+////////////////////////////////////////////////////////////////
+runner::instance::
+instance(std::shared_ptr<instance_impl> impl)
+  : m_impl{std::move(impl)}
+{}
+
+void
+runner::instance::
+bind_input(const std::string& name, const xrt::bo& bo)
+{
+  (*m_impl)->bind_input(name, bo);
+}
+
+void
+runner::instance::
+bind_output(const std::string& name, const xrt::bo& bo)
+{
+  (*m_impl)->bind_output(name, bo);
+}
+
+void
+runner::instance::
+bind(const std::string& name, const xrt::bo& bo)
+{
+  (*m_impl)->bind(name, bo);
+}
+
+void
+runner::instance::
+execute()
+{
+  (*m_impl)->execute();
+}
+
+void
+runner::instance::
+wait()
+{
+  (*m_impl)->wait();
+}
+
 } // namespace xrt_core
@@ -5,6 +5,7 @@
 #include "core/common/config.h"
 
 #include <any>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -25,9 +26,56 @@ namespace xrt_core {
 class runner_impl;
 class runner
 {
-  std::shared_ptr<runner_impl> m_impl;  // probably unique_ptr is enough
+  std::shared_ptr<runner_impl> m_impl;  // shared with acquired instances
 
 public:
+  /**
+   * class instance - An exclusively acquired instance of the recipe
+   *
+   * An instance is acquired from a runner and has its own internal
+   * buffers and runs, such that different threads can bind and
+   * execute separate instances concurrently.  The instance is
+   * returned to the runner for reuse when the last copy of the
+   * instance object is destroyed.  Destruction waits for an
+   * outstanding execution to complete.
+   *
+   * An instance itself is not thread safe.
+   */
+  class instance_impl;
+  class instance
+  {
+    std::shared_ptr<instance_impl> m_impl;
+
+  public:
+    explicit
+    instance(std::shared_ptr<instance_impl> impl);
+
+    // bind_input() - Bind a buffer object to an input tensor
+    XRT_CORE_COMMON_EXPORT
+    void
+    bind_input(const std::string& name, const xrt::bo& bo);
+
+    // bind_output() - Bind a buffer object to an output tensor
+    XRT_CORE_COMMON_EXPORT
+    void
+    bind_output(const std::string& name, const xrt::bo& bo);
+
+    // bind() - Bind a buffer object to a tensor
+    XRT_CORE_COMMON_EXPORT
+    void
+    bind(const std::string& name, const xrt::bo& bo);
+
+    // execute() - Execute the instance
+    XRT_CORE_COMMON_EXPORT
+    void
+    execute();
+
+    // wait() - Wait for the execution to complete
+    XRT_CORE_COMMON_EXPORT
+    void
+    wait();
+  };
+
   /**
    * artifacts_repository - A map of artifacts
    *
@@ -70,6 +118,23 @@ public:
   XRT_CORE_COMMON_EXPORT
   void
   wait();
+
+  // acquire() - Acquire a recipe instance for exclusive use
+  //
+  // Instances are created on demand from the recipe of this runner
+  // and reused once released.  Blocks while the maximum number of
+  // instances are acquired.  Thread safe.
+  XRT_CORE_COMMON_EXPORT
+  instance
+  acquire();
+
+  // set_max_instances() - Limit number of concurrently acquired instances
+  //
+  // Defaults to the number of hardware threads.  Instances already
+  // acquired beyond a lowered limit are not affected.
+  XRT_CORE_COMMON_EXPORT
+  void
+  set_max_instances(size_t max);
 };
 
 /**
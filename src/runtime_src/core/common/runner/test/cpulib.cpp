@@ -1,15 +1,22 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
-#include "experimental/xrt_runner.h"
+#include "core/common/runner/runner.h"
 #include "xrt/xrt_bo.h"
 
 #include <any>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <iostream>
 #include <string>
 #include <vector>
 
-#pragma warning(disable: 4100 4505)
+#ifdef _WIN32
+# pragma warning(disable: 4100 4505)
+# define CPULIB_EXPORT __declspec(dllexport)
+#else
+# define CPULIB_EXPORT __attribute__((visibility("default")))
+#endif
 
 
 
@@ -61,9 +68,9 @@ hello(const std::vector<std::any>& args)
 }
 
 static void
-lookup(const std::string& fnm, xrt::cpu::lookup_args* args)
+lookup(const std::string& fnm, xrt_core::cpu::lookup_args* args)
 {
-  using function_info = xrt::cpu::lookup_args;
+  using function_info = xrt_core::cpu::lookup_args;
   static std::map<std::string, function_info> function_map = 
   {
     { "convert_ifm", {2, convert_ifm} },
@@ -85,9 +92,9 @@ lookup(const std::string& fnm, xrt::cpu::lookup_args* args)
 
 extern "C" {
 
-__declspec(dllexport)
+CPULIB_EXPORT
 void
-library_init(xrt::cpu::library_init_args* args)
+library_init(xrt_core::cpu::library_init_args* args)
 {
   args->lookup_fn = &cpux::lookup;
 }
@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// This test measures throughput of concurrent recipe execution
+// through runner instances acquired from the runner pool, compared
+// with serialized execution of the runner itself.
+//
+// The recipe is generated by the test and executes two cpu functions
+// from cpulib (convert_ifm and convert_ofm), which copies an input
+// buffer to an output buffer through an internal buffer.  No device
+// kernels are used, so the test runs with the noop shim (XCL_NOOP=1).
+//
+// mkdir build
+// cd build
+// cmake -DXILINX_XRT=/home/stsoe/git/stsoe/XRT/build/Debug/opt/xilinx/xrt
+//       -DXRT_ROOT=/home/stsoe/git/stsoe/XRT ..
+// cmake --build . --config Debug
+//
+// ./pool -k verify.xclbin -l $PWD/cpulib [-t <threads>] [-i <iterations>] [-s <bytes>]
+
+#include "xrt/xrt_device.h"
+#include "experimental/xrt_ext.h"
+#include "core/common/runner/runner.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: pool [options]\n"
+            << " -k <xclbin> xclbin referenced by the generated recipe\n"
+            << " -l <cpulib> path to cpulib without prefix and extension\n"
+            << " [-d <device>] (default: 0)\n"
+            << " [-t <threads>] (default: 4)\n"
+            << " [-i <iterations>] per thread (default: 1000)\n"
+            << " [-s <bytes>] buffer size (default: 65536)\n";
+}
+
+static std::vector<char>
+read_file(const std::string& fnm)
+{
+  std::ifstream ifs{fnm, std::ios::binary};
+  if (!ifs)
+    throw std::runtime_error("Failed to open file '" + fnm + "' for reading");
+
+  ifs.seekg(0, std::ios::end);
+  std::vector<char> data(ifs.tellg());
+  ifs.seekg(0, std::ios::beg);
+  ifs.read(data.data(), data.size());
+  return data;
+}
+
+// Generate a cpu only recipe, absolute library_path takes precedence
+// over XILINX_XRT.
+static std::string
+write_recipe(const std::string& cpulib, size_t size)
+{
+  std::string recipe = "pool_recipe.json";
+  std::ofstream ofs{recipe};
+  ofs << "{\n"
+      << "  \"header\": { \"xclbin_path\": \"design.xclbin\" },\n"
+      << "  \"resources\": {\n"
+      << "    \"buffers\": [\n"
+      << "      { \"name\": \"ifm\", \"type\": \"input\" },\n"
+      << "      { \"name\": \"tmp\", \"type\": \"internal\", \"size\": \"" << size << "\" },\n"
+      << "      { \"name\": \"ofm\", \"type\": \"output\" }\n"
+      << "    ],\n"
+      << "    \"kernels\": [],\n"
+      << "    \"cpus\": [\n"
+      << "      { \"name\": \"convert_ifm\", \"library_path\": \"" << cpulib << "\" },\n"
+      << "      { \"name\": \"convert_ofm\", \"library_path\": \"" << cpulib << "\" }\n"
+      << "    ]\n"
+      << "  },\n"
+      << "  \"execution\": {\n"
+      << "    \"runs\": [\n"
+      << "      { \"name\": \"convert_ifm\", \"where\": \"cpu\",\n"
+      << "        \"arguments\": [ { \"name\": \"ifm\", \"argidx\": 0 }, { \"name\": \"tmp\", \"argidx\": 1 } ] },\n"
+      << "      { \"name\": \"convert_ofm\", \"where\": \"cpu\",\n"
+      << "        \"arguments\": [ { \"name\": \"tmp\", \"argidx\": 0 }, { \"name\": \"ofm\", \"argidx\": 1 } ] }\n"
+      << "    ]\n"
+      << "  }\n"
+      << "}\n";
+  if (!ofs)
+    throw std::runtime_error("Failed to write recipe '" + recipe + "'");
+  return recipe;
+}
+
+struct buffers
+{
+  xrt::bo ifm;
+  xrt::bo ofm;
+  uint8_t value;
+
+  buffers(const xrt::device& device, size_t size, uint8_t v)
+    : ifm{xrt::ext::bo{device, size}}
+    , ofm{xrt::ext::bo{device, size}}
+    , value{v}
+  {
+    std::memset(ifm.map<uint8_t*>(), value, size);
+  }
+
+  void
+  verify()
+  {
+    auto data = ofm.map<const uint8_t*>();
+    for (size_t i = 0; i < ofm.size(); ++i)
+      if (data[i] != value)
+        throw std::runtime_error("Output mismatch at index " + std::to_string(i));
+  }
+};
+
+template <typename Worker>
+static double
+timed(unsigned int threads, Worker&& worker)
+{
+  std::vector<std::thread> workers;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int t = 0; t < threads; ++t)
+    workers.emplace_back(worker, t);
+  for (auto& w : workers)
+    w.join();
+  auto elapsed = std::chrono::high_resolution_clock::now() - start;
+  return std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count();
+}
+
+static void
+report(const std::string& label, unsigned int executions, double seconds)
+{
+  std::cout << std::setw(10) << label << ": " << executions << " executions in "
+            << std::fixed << std::setprecision(3) << seconds << "s ("
+            << std::setprecision(1) << (seconds > 0 ? executions / seconds : 0.0)
+            << " executions/s)\n";
+}
+
+static void
+run(int argc, char* argv[])
+{
+  std::string xclbin_fnm;
+  std::string cpulib;
+  unsigned int device_index = 0;
+  unsigned int threads = 4;
+  unsigned int iterations = 1000;
+  size_t size = 65536;
+
+  std::vector<std::string> args(argv+1,argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-l")
+      cpulib = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-t")
+      threads = std::stoi(arg);
+    else if (cur == "-i")
+      iterations = std::stoi(arg);
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty() || cpulib.empty())
+    throw std::runtime_error("No xclbin or cpulib specified");
+
+  xrt_core::runner::artifacts_repository repo;
+  repo.emplace("design.xclbin", read_file(xclbin_fnm));
+
+  xrt::device device{device_index};
+  auto recipe = write_recipe(cpulib, size);
+  xrt_core::runner runner{device, recipe, repo};
+  runner.set_max_instances(threads);
+
+  std::vector<buffers> bufs;
+  for (unsigned int t = 0; t < threads; ++t)
+    bufs.emplace_back(device, size, static_cast<uint8_t>(t + 1));
+
+  // Serialized, all threads share the runner itself
+  std::mutex mutex;
+  auto serial = timed(threads, [&](unsigned int t) {
+    for (unsigned int i = 0; i < iterations; ++i) {
+      std::lock_guard lk(mutex);
+      runner.bind_input("ifm", bufs[t].ifm);
+      runner.bind_output("ofm", bufs[t].ofm);
+      runner.execute();
+      runner.wait();
+    }
+  });
+
+  for (auto& b : bufs)
+    b.verify();
+
+  // Concurrent, each iteration acquires an instance from the pool
+  auto pooled = timed(threads, [&](unsigned int t) {
+    for (unsigned int i = 0; i < iterations; ++i) {
+      auto instance = runner.acquire();
+      instance.bind_input("ifm", bufs[t].ifm);
+      instance.bind_output("ofm", bufs[t].ofm);
+      instance.execute();
+      instance.wait();
+    }
+  });
+
+  for (auto& b : bufs)
+    b.verify();
+
+  report("serialized", threads * iterations, serial);
+  report("pooled", threads * iterations, pooled);
+}
+
+int
+main(int argc, char **argv)
+{
+  try {
+    run(argc, argv);
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "Error: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cerr << "Unknown error" << "\n";
+  }
+  return 1;
+}
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace xrt_core {
 
@@ -34,6 +35,13 @@ public:
     device2host = XCL_BO_SYNC_BO_FROM_DEVICE,
   };
 
+  // range - region of a buffer
+  struct range
+  {
+    size_t size;
+    size_t offset;
+  };
+
   // properties - buffer details
   struct properties
   {
@@ -67,6 +75,16 @@ public:
   virtual void
   sync(direction, size_t size, size_t offset) = 0;
 
+  // Sync a list of non-overlapping buffer ranges to or from device.
+  // Shims that can submit several ranges in one driver request
+  // should override the default which syncs one range at a time.
+  virtual void
+  sync(direction dir, const std::vector<range>& ranges)
+  {
+    for (const auto& r : ranges)
+      sync(dir, r.size, r.offset);
+  }
+
   // Copy size bytes from src buffer at src offset into this
   // buffer at dst offset
   virtual void
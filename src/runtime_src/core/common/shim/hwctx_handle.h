@@ -15,6 +15,7 @@
 #include "xrt/xrt_graph.h"
 
 #include <memory>
+#include <vector>
 
 namespace xrt_core {
 
@@ -96,6 +97,34 @@ public:
   virtual void
   exec_buf(buffer_handle* cmd) = 0;
 
+  // Execution of a list of independent command objects when the shim
+  // does not support hardware queues.  Shims that can submit multiple
+  // commands with one call should override this function, default is
+  // to submit the commands one by one.
+  //
+  // Returns the number of commands submitted, which is less than the
+  // size of the list only if submission of the next command failed.
+  // Throws only if no command could be submitted.  The caller
+  // resubmits the remaining commands to either progress or get the
+  // error.
+  virtual size_t
+  exec_buf(const std::vector<buffer_handle*>& cmds)
+  {
+    size_t submitted = 0;
+    for (auto cmd : cmds) {
+      try {
+        exec_buf(cmd);
+      }
+      catch (...) {
+        if (!submitted)
+          throw;
+        break;
+      }
+      ++submitted;
+    }
+    return submitted;
+  }
+
   virtual std::unique_ptr<xrt_core::graph_handle>
   open_graph_handle(const char*, xrt::graph::access_mode)
   {
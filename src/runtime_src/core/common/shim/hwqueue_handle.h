@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: Apache-2.0
-// Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
 #ifndef XRT_CORE_HWQUEUE_HANDLE_H
 #define XRT_CORE_HWQUEUE_HANDLE_H
 
@@ -28,6 +28,32 @@ public:
   virtual void
   submit_command(buffer_handle* cmd) = 0;
 
+  // Submit list of commands for execution.  The commands are
+  // independent and may complete in any order.  Shims that can
+  // submit multiple commands with one call should override this
+  // function, default is to submit the commands one by one.
+  //
+  // Returns the number of commands submitted, which is less than the
+  // size of the list only if submission of the next command failed.
+  // Throws only if no command could be submitted.
+  virtual size_t
+  submit_command(const std::vector<buffer_handle*>& cmds)
+  {
+    size_t submitted = 0;
+    for (auto cmd : cmds) {
+      try {
+        submit_command(cmd);
+      }
+      catch (...) {
+        if (!submitted)
+          throw;
+        break;
+      }
+      ++submitted;
+    }
+    return submitted;
+  }
+
   // Poll for command completion
   //
   // @cmd    Handle to command to poll for
@@ -51,6 +77,23 @@ public:
   virtual int
   wait_command(buffer_handle* cmd, uint32_t timeout_ms) const = 0;
 
+  // Number of commands that can be in flight on this queue before
+  // submission blocks.  Used to size submissions, e.g. the command
+  // chains of a runlist.  A value of 0 means the depth is unknown.
+  virtual size_t
+  get_queue_depth() const
+  {
+    return 0;
+  }
+
+  // Maximum number of commands in an ERT_CMD_CHAIN command accepted
+  // by this queue.  A value of 0 means the limit is unknown.
+  virtual size_t
+  get_max_chain_size() const
+  {
+    return 0;
+  }
+
   // Submit wait on a fence.  The fence prevents the hardware queue from
   // proceeding until the fence is signaled.
   virtual void
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// This test allocates and releases exec buffers of one xrt_core::bo_cache
+// concurrently from several threads and checks that the number of
+// cached buffers never exceeds the global high-water mark, and that
+// every buffer created by the cache is either cached or destroyed
+// once all buffers are released.
+//
+// The test allocates exec buffers only, no xclbin is required and
+// the test runs with the noop shim (XCL_NOOP=1).
+//
+// mkdir build
+// cd build
+// cmake -DXILINX_XRT=<xrt install>/opt/xilinx/xrt -DXRT_ROOT=<xrt repo> ..
+// cmake --build . --config Debug
+//
+// ./bo_cache [-d <device>] [-t <threads>] [-i <iterations>] [-w <high water>] [-b <buffers>]
+
+#include "xrt/xrt_device.h"
+#include "core/common/bo_cache.h"
+#include "core/common/config_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: bo_cache [options]\n"
+            << " [-d <device>] (default: 0)\n"
+            << " [-t <threads>] (default: 8)\n"
+            << " [-i <iterations>] per thread (default: 10000)\n"
+            << " [-w <high water>] cache high-water mark (default: 16)\n"
+            << " [-b <buffers>] max buffers held at a time per thread (default: 8)\n";
+}
+
+static void
+run(int argc, char** argv)
+{
+  unsigned int device_index = 0;
+  unsigned int threads = 8;
+  unsigned int iterations = 10000;
+  unsigned int high_water = 16;
+  unsigned int held = 8;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-t")
+      threads = std::stoi(arg);
+    else if (cur == "-i")
+      iterations = std::stoi(arg);
+    else if (cur == "-w")
+      high_water = std::stoi(arg);
+    else if (cur == "-b")
+      held = std::max(std::stoi(arg), 1);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  // xrt.ini can override the high-water mark passed to the cache
+  auto bound = xrt_core::config::get_exec_buffer_cache_high_water(4096, high_water);
+
+  xrt::device device{device_index};
+  xrt_core::bo_cache cache{device.get_handle(), high_water};
+
+  std::atomic<bool> done {false};
+  std::atomic<unsigned int> max_cached {0};
+  auto sample = [&cache, &max_cached] {
+    auto cached = cache.size();
+    auto max = max_cached.load();
+    while (cached > max && !max_cached.compare_exchange_weak(max, cached));
+  };
+
+  // Sample the cache size while the workers run
+  std::thread monitor([&done, &sample] {
+    while (!done)
+      sample();
+  });
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back([&cache, &sample, t, iterations, held] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<unsigned int> dist(1, held);
+      std::vector<xrt_core::bo_cache::cmd_bo<ert_packet>> bos;
+      for (unsigned int i = 0; i < iterations; ++i) {
+        for (auto n = dist(gen); n; --n)
+          bos.push_back(cache.alloc<ert_packet>());
+        while (!bos.empty()) {
+          cache.release(std::move(bos.back()));
+          bos.pop_back();
+          sample();
+        }
+      }
+    });
+  }
+
+  for (auto& w : workers)
+    w.join();
+  done = true;
+  monitor.join();
+  sample();
+
+  auto st = cache.get_stats();
+  std::cout << "high water: " << bound << "\n"
+            << "max cached: " << max_cached << "\n"
+            << "cached: " << cache.size() << "\n"
+            << "thread hits: " << st.thread_hits << "\n"
+            << "pool hits: " << st.pool_hits << "\n"
+            << "misses: " << st.misses << "\n"
+            << "destroyed: " << st.destroyed << "\n";
+
+  if (max_cached > bound)
+    throw std::runtime_error("cache exceeded high-water mark");
+
+  if (st.misses - st.destroyed != cache.size())
+    throw std::runtime_error("created buffers are neither cached nor destroyed");
+}
+
+int
+main(int argc, char **argv)
+{
+  try {
+    run(argc, argv);
+    std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cerr << "TEST FAILED for unknown reason\n";
+  }
+  return 1;
+}
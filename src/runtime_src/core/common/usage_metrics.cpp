@@ -17,15 +17,18 @@
 #include "core/include/xrt/xrt_uuid.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 
 #ifdef _WIN32
 # pragma warning ( disable : 4996 )
@@ -38,9 +41,14 @@ namespace {
 static std::mutex m;
 static std::atomic<uint32_t> thread_count {0};
 
+// Bumped whenever a kernel is logged. Per thread kernel lookup caches
+// compare against this to detect that a kernel_impl address may have
+// been reused by a new kernel.
+static std::atomic<uint64_t> kernel_epoch {0};
+
 template <typename MetType, typename FindType>
 static MetType*
-get_metrics(std::vector<MetType>& metrics_vec, const FindType& finder)
+get_metrics(std::deque<MetType>& metrics_vec, const FindType& finder)
 {
   auto it = std::find_if(metrics_vec.begin(), metrics_vec.end(), 
                         [finder](const auto& met) 
@@ -106,7 +114,9 @@ struct hw_ctx_metrics
   const xrt_core::hwctx_handle* handle;  // using hw_ctx handle ptr as unique identifier for logging
   xrt::uuid xclbin_uuid;
   bo_metrics bos_met;
-  std::vector<kernel_metrics> kernel_metrics_vec;
+  // deque keeps kernel_metrics addresses stable, they are cached
+  // by the kernel run logging
+  std::deque<kernel_metrics> kernel_metrics_vec;
 
   void
   log_kernel(const std::string& name, size_t args)
@@ -124,7 +134,7 @@ struct device_metrics
   bo_metrics global_bos_met;
   uint32_t bo_active_count = 0;
   uint32_t bo_peak_count = 0;
-  std::vector<hw_ctx_metrics> hw_ctx_vec;
+  std::deque<hw_ctx_metrics> hw_ctx_vec;
 
   void
   log_hw_ctx(const xrt_core::hwctx_handle* handle, const xrt::uuid& uuid)
@@ -209,7 +219,7 @@ get_bos_ptree(const bo_metrics& bo_met)
 }
 
 static bpt::ptree
-get_kernels_ptree(const std::vector<kernel_metrics>& kernels_vec)
+get_kernels_ptree(const std::deque<kernel_metrics>& kernels_vec)
 {
   bpt::ptree kernel_array;
 
@@ -230,7 +240,7 @@ get_kernels_ptree(const std::vector<kernel_metrics>& kernels_vec)
 }
 
 static bpt::ptree
-get_hw_ctx_ptree(const std::vector<hw_ctx_metrics>& hw_ctx_vec)
+get_hw_ctx_ptree(const std::deque<hw_ctx_metrics>& hw_ctx_vec)
 {
   bpt::ptree hw_ctx_array;
 
@@ -291,8 +301,26 @@ print_usage_metrics()
 //
 // This class collects metrics from all threads using XRT
 // The metrics are collected in a thread safe manner.
+//
+// Kernel run logging is on the critical path of every kernel
+// launch and wait. The calls only resolve the kernel to its metrics
+// through a per thread cache and append a timestamped event to a
+// fixed size buffer. Events are folded into the kernel metrics when
+// the buffer fills up and when the thread exits.
 class usage_metrics_logger : public xrt_core::usage_metrics::base_logger
 {
+  using tp = kernel_metrics::tp;
+
+  struct run_event
+  {
+    kernel_metrics* kernel_met;
+    const xrt::run_impl* run_hdl;
+    ert_cmd_state state;
+    tp time;
+  };
+
+  static constexpr size_t max_events = 1024;
+
 public:
   usage_metrics_logger();
 
@@ -320,8 +348,27 @@ public:
   log_kernel_run_info(const xrt::kernel_impl*, const xrt::run_impl*, ert_cmd_state) override;
 
 private:
+  kernel_metrics*
+  lookup_kernel_metrics(const xrt::kernel_impl*);
+
+  kernel_metrics*
+  find_kernel_metrics(const xrt::kernel_impl*);
+
+  void
+  flush_run_events();
+
   device_metrics_map m_dev_map;
   std::shared_ptr<metrics_map> map_ptr;
+
+  // kernel_impl to metrics cache, nullptr values record kernels
+  // that are not logged.  Valid for m_kernel_epoch only.
+  std::unordered_map<const xrt::kernel_impl*, kernel_metrics*> m_kernel_cache;
+  const xrt::kernel_impl* m_last_kernel = nullptr;
+  kernel_metrics* m_last_kernel_met = nullptr;
+  uint64_t m_kernel_epoch = 0;
+
+  std::array<run_event, max_events> m_events;
+  size_t m_num_events = 0;
 };
 
 usage_metrics_logger::
@@ -334,6 +381,7 @@ usage_metrics_logger::
 ~usage_metrics_logger()
 {
   thread_count--;
+  flush_run_events();
   {
     std::lock_guard<std::mutex> lk(m);
     // push this threads usage metrics to global map
@@ -448,6 +496,9 @@ void
 usage_metrics_logger::
 log_kernel_info(const xrt_core::device* dev, const xrt::hw_context& ctx, const std::string& name, size_t args)
 {
+  // a new kernel may reuse the address of a destroyed one
+  kernel_epoch.fetch_add(1, std::memory_order_relaxed);
+
   auto dev_id = dev->get_device_id();
   auto hwctx_handle = static_cast<xrt_core::hwctx_handle*>(ctx);
 
@@ -466,12 +517,11 @@ log_kernel_info(const xrt_core::device* dev, const xrt::hw_context& ctx, const s
   }
 }
 
-void
+// find_kernel_metrics() - Slow path lookup of kernel metrics
+kernel_metrics*
 usage_metrics_logger::
-log_kernel_run_info(const xrt::kernel_impl* krnl_impl, const xrt::run_impl* run_hdl, ert_cmd_state state)
+find_kernel_metrics(const xrt::kernel_impl* krnl_impl)
 {
-  // collecting time at start of call as next calls will be overhead
-  auto ts_now = std::chrono::high_resolution_clock::now();
   try {
     auto kernel =
         xrt_core::kernel_int::create_kernel_from_implementation(krnl_impl);
@@ -480,28 +530,76 @@ log_kernel_run_info(const xrt::kernel_impl* krnl_impl, const xrt::run_impl* run_
     auto hwctx_handle = static_cast<xrt_core::hwctx_handle*>(hw_ctx);
 
     auto dev_id = xrt_core::hw_context_int::get_core_device(hw_ctx)->get_device_id();
-    auto name = kernel.get_name();
 
     auto dev_metrics = get_device_metrics(m_dev_map, dev_id);
     if (!dev_metrics)
-      return;
+      return nullptr;
 
     auto hw_ctx_met = get_metrics(dev_metrics->hw_ctx_vec, hwctx_handle);
     // dont log if hw ctx didn't match existing ones
     if (!hw_ctx_met)
-      return;
-  
-    auto kernel_met = get_metrics(hw_ctx_met->kernel_metrics_vec, name);
-    if (!kernel_met)
-      return;
+      return nullptr;
 
-    kernel_met->log_kernel_exec_time(run_hdl, ts_now, state);
+    return get_metrics(hw_ctx_met->kernel_metrics_vec, kernel.get_name());
   }
   catch(...) {
     // dont log anything
+    return nullptr;
   }
 }
 
+// lookup_kernel_metrics() - Cached lookup of kernel metrics
+kernel_metrics*
+usage_metrics_logger::
+lookup_kernel_metrics(const xrt::kernel_impl* krnl_impl)
+{
+  auto epoch = kernel_epoch.load(std::memory_order_relaxed);
+  if (epoch != m_kernel_epoch) {
+    m_kernel_cache.clear();
+    m_last_kernel = nullptr;
+    m_kernel_epoch = epoch;
+  }
+
+  if (krnl_impl == m_last_kernel)
+    return m_last_kernel_met;
+
+  auto it = m_kernel_cache.find(krnl_impl);
+  if (it == m_kernel_cache.end())
+    it = m_kernel_cache.emplace(krnl_impl, find_kernel_metrics(krnl_impl)).first;
+
+  m_last_kernel = krnl_impl;
+  m_last_kernel_met = it->second;
+  return m_last_kernel_met;
+}
+
+// flush_run_events() - Fold buffered run events into kernel metrics
+void
+usage_metrics_logger::
+flush_run_events()
+{
+  for (size_t idx = 0; idx < m_num_events; ++idx) {
+    const auto& ev = m_events[idx];
+    ev.kernel_met->log_kernel_exec_time(ev.run_hdl, ev.time, ev.state);
+  }
+  m_num_events = 0;
+}
+
+void
+usage_metrics_logger::
+log_kernel_run_info(const xrt::kernel_impl* krnl_impl, const xrt::run_impl* run_hdl, ert_cmd_state state)
+{
+  // collecting time at start of call as next calls will be overhead
+  auto ts_now = std::chrono::high_resolution_clock::now();
+  auto kernel_met = lookup_kernel_metrics(krnl_impl);
+  if (!kernel_met)
+    return;
+
+  if (m_num_events == max_events)
+    flush_run_events();
+
+  m_events[m_num_events++] = {kernel_met, run_hdl, state, ts_now};
+}
+
 // Create specific logger if ini option is enabled
 static std::shared_ptr<xrt_core::usage_metrics::base_logger>
 get_logger_object()
@@ -0,0 +1,360 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#define XRT_CORE_COMMON_SOURCE
+#include "xclbin_metadata_cache.h"
+#include "config_reader.h"
+#include "message.h"
+#include "utils.h"
+
+#include "gen/version.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Cache file layout, all integers are native 64-bit:
+//
+//   magic, format version, XRT build hash, xml size, xml digest,
+//   project name, fpga device name, kernels
+//
+// Strings are stored as length followed by characters.  A cache file
+// is read in full and is valid only if every field in the header
+// matches the running XRT and the xclbin being loaded.  Bump
+// format_version whenever struct xml_metadata, kernel_properties, or
+// kernel_argument change.
+namespace {
+
+namespace fs = std::filesystem;
+using xml_metadata = xrt_core::xclbin::xml_metadata;
+using kernel_properties = xrt_core::xclbin::kernel_properties;
+using kernel_argument = xrt_core::xclbin::kernel_argument;
+
+constexpr uint64_t magic = 0x31434d44584c4d58; // "XMLXDMC1"
+constexpr uint64_t format_version = 1;
+
+// FNV-1a, stable across processes and builds unlike std::hash
+static uint64_t
+digest(const char* data, size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+class writer
+{
+  std::vector<char> m_buf;
+
+public:
+  void
+  put(uint64_t value)
+  {
+    auto p = reinterpret_cast<const char*>(&value);
+    m_buf.insert(m_buf.end(), p, p + sizeof(value));
+  }
+
+  void
+  put(const std::string& str)
+  {
+    put(str.size());
+    m_buf.insert(m_buf.end(), str.begin(), str.end());
+  }
+
+  const std::vector<char>&
+  data() const
+  {
+    return m_buf;
+  }
+};
+
+// Thrown on truncated or malformed cache file
+struct invalid_cache : std::runtime_error
+{
+  invalid_cache() : std::runtime_error("invalid xclbin meta data cache file") {}
+};
+
+class reader
+{
+  const std::vector<char>& m_buf;
+  size_t m_pos = 0;
+
+public:
+  explicit
+  reader(const std::vector<char>& buf)
+    : m_buf(buf)
+  {}
+
+  uint64_t
+  get()
+  {
+    uint64_t value = 0;
+    if (m_buf.size() - m_pos < sizeof(value))
+      throw invalid_cache();
+    std::memcpy(&value, m_buf.data() + m_pos, sizeof(value));
+    m_pos += sizeof(value);
+    return value;
+  }
+
+  std::string
+  get_string()
+  {
+    auto size = get();
+    if (m_buf.size() - m_pos < size)
+      throw invalid_cache();
+    std::string str(m_buf.data() + m_pos, size);
+    m_pos += size;
+    return str;
+  }
+
+  void
+  expect(uint64_t value)
+  {
+    if (get() != value)
+      throw invalid_cache();
+  }
+
+  void
+  expect(const std::string& value)
+  {
+    if (get_string() != value)
+      throw invalid_cache();
+  }
+
+  bool
+  done() const
+  {
+    return m_pos == m_buf.size();
+  }
+};
+
+static void
+put_header(writer& w, const char* xml_data, size_t xml_size)
+{
+  w.put(magic);
+  w.put(format_version);
+  w.put(std::string(xrt_build_version_hash));
+  w.put(xml_size);
+  w.put(digest(xml_data, xml_size));
+}
+
+static void
+get_header(reader& r, const char* xml_data, size_t xml_size)
+{
+  r.expect(magic);
+  r.expect(format_version);
+  r.expect(std::string(xrt_build_version_hash));
+  r.expect(xml_size);
+  r.expect(digest(xml_data, xml_size));
+}
+
+static void
+put_properties(writer& w, const kernel_properties& p)
+{
+  w.put(p.name);
+  w.put(static_cast<uint64_t>(p.type));
+  w.put(p.counted_auto_restart);
+  w.put(static_cast<uint64_t>(p.mailbox));
+  w.put(p.address_range);
+  w.put(p.sw_reset);
+  w.put(p.functional);
+  w.put(p.kernel_id);
+  w.put(p.workgroupsize);
+  for (auto v : p.compileworkgroupsize)
+    w.put(v);
+  for (auto v : p.maxworkgroupsize)
+    w.put(v);
+  w.put(p.stringtable.size());
+  for (const auto& [id, value] : p.stringtable) {
+    w.put(id);
+    w.put(value);
+  }
+}
+
+static kernel_properties
+get_properties(reader& r)
+{
+  kernel_properties p;
+  p.name = r.get_string();
+  p.type = static_cast<kernel_properties::kernel_type>(r.get());
+  p.counted_auto_restart = r.get();
+  p.mailbox = static_cast<kernel_properties::mailbox_type>(r.get());
+  p.address_range = r.get();
+  p.sw_reset = r.get() != 0;
+  p.functional = r.get();
+  p.kernel_id = r.get();
+  p.workgroupsize = r.get();
+  for (auto& v : p.compileworkgroupsize)
+    v = r.get();
+  for (auto& v : p.maxworkgroupsize)
+    v = r.get();
+  for (auto n = r.get(); n; --n) {
+    auto id = static_cast<uint32_t>(r.get());
+    p.stringtable.emplace(id, r.get_string());
+  }
+  return p;
+}
+
+static void
+put_argument(writer& w, const kernel_argument& a)
+{
+  w.put(a.name);
+  w.put(a.hosttype);
+  w.put(a.port);
+  w.put(a.port_width);
+  w.put(a.index);
+  w.put(a.offset);
+  w.put(a.size);
+  w.put(a.hostsize);
+  w.put(a.fa_desc_offset);
+  w.put(static_cast<uint64_t>(a.type));
+  w.put(static_cast<uint64_t>(a.dir));
+}
+
+static kernel_argument
+get_argument(reader& r)
+{
+  kernel_argument a;
+  a.name = r.get_string();
+  a.hosttype = r.get_string();
+  a.port = r.get_string();
+  a.port_width = r.get();
+  a.index = r.get();
+  a.offset = r.get();
+  a.size = r.get();
+  a.hostsize = r.get();
+  a.fa_desc_offset = r.get();
+  a.type = static_cast<kernel_argument::argtype>(r.get());
+  a.dir = static_cast<kernel_argument::direction>(r.get());
+  return a;
+}
+
+static std::vector<char>
+serialize(const xml_metadata& md, const char* xml_data, size_t xml_size)
+{
+  writer w;
+  put_header(w, xml_data, xml_size);
+  w.put(md.project_name);
+  w.put(md.fpga_device_name);
+  w.put(md.kernels.size());
+  for (const auto& kernel : md.kernels) {
+    put_properties(w, kernel.properties);
+    w.put(kernel.args.size());
+    for (const auto& arg : kernel.args)
+      put_argument(w, arg);
+  }
+  return w.data();
+}
+
+static xml_metadata
+deserialize(const std::vector<char>& buf, const char* xml_data, size_t xml_size)
+{
+  reader r(buf);
+  get_header(r, xml_data, xml_size);
+
+  xml_metadata md;
+  md.project_name = r.get_string();
+  md.fpga_device_name = r.get_string();
+  for (auto nkernels = r.get(); nkernels; --nkernels) {
+    xml_metadata::kernel kernel;
+    kernel.properties = get_properties(r);
+    for (auto nargs = r.get(); nargs; --nargs)
+      kernel.args.push_back(get_argument(r));
+    md.kernels.push_back(std::move(kernel));
+  }
+
+  if (!r.done())
+    throw invalid_cache();
+
+  return md;
+}
+
+static fs::path
+get_cache_dir()
+{
+  auto dir = xrt_core::config::get_xclbin_metadata_cache_dir();
+  if (!dir.empty())
+    return dir;
+
+#ifdef _WIN32
+  if (auto local = std::getenv("LOCALAPPDATA"))
+    return fs::path(local) / "xrt";
+#else
+  if (auto xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+    return fs::path(xdg) / "xrt";
+  if (auto home = std::getenv("HOME"))
+    return fs::path(home) / ".cache" / "xrt";
+#endif
+  return {};
+}
+
+static std::vector<char>
+read_file(const fs::path& path)
+{
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs)
+    return {};
+  return {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+}
+
+// Write to a process unique temporary and rename into place such that
+// concurrent readers never see a partially written file
+static void
+write_file(const fs::path& path, const std::vector<char>& data)
+{
+  fs::create_directories(path.parent_path());
+  auto tmp = path;
+  tmp += "." + std::to_string(xrt_core::utils::get_pid());
+  {
+    std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+    ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!ofs)
+      throw std::runtime_error("failed to write " + tmp.string());
+  }
+  fs::rename(tmp, path);
+}
+
+} // namespace
+
+namespace xrt_core { namespace xclbin { namespace metadata_cache {
+
+xml_metadata
+get(const xrt::uuid& uuid, const char* xml_data, size_t xml_size)
+{
+  if (!xrt_core::config::get_xclbin_metadata_cache())
+    return get_xml_metadata(xml_data, xml_size);
+
+  auto dir = get_cache_dir();
+  if (dir.empty())
+    return get_xml_metadata(xml_data, xml_size);
+
+  auto path = dir / (uuid.to_string() + ".xmd");
+  auto buf = read_file(path);
+  if (!buf.empty()) {
+    try {
+      return deserialize(buf, xml_data, xml_size);
+    }
+    catch (const invalid_cache&) {
+      // stale or corrupt, replaced below
+    }
+  }
+
+  auto md = get_xml_metadata(xml_data, xml_size);
+  try {
+    write_file(path, serialize(md, xml_data, xml_size));
+  }
+  catch (const std::exception& ex) {
+    xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT",
+                            std::string("xclbin meta data cache not updated: ") + ex.what());
+  }
+  return md;
+}
+
+}}} // metadata_cache, xclbin, xrt_core
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrtcore_xclbin_metadata_cache_h_
+#define xrtcore_xclbin_metadata_cache_h_
+
+#include "core/common/config.h"
+#include "core/common/xclbin_parser.h"
+#include "core/include/xrt/xrt_uuid.h"
+
+// Persistent on-disk cache of xml meta data extracted from xclbins.
+//
+// Enabled with xrt.ini Runtime.xclbin_metadata_cache=true.  Cache
+// files are keyed by xclbin uuid and validated against the cache file
+// format version, the XRT build, and a digest of the xml meta data
+// before use.  Invalid or missing cache files are silently replaced.
+namespace xrt_core { namespace xclbin { namespace metadata_cache {
+
+/**
+ * get() - Get xml meta data for an xclbin
+ *
+ * @uuid:      uuid of xclbin
+ * @xml_data:  xml section of xclbin
+ * @xml_size:  size of xml section
+ * Return:     xml meta data from cache if valid, otherwise parsed
+ *
+ * If the cache is disabled, this is the same as get_xml_metadata().
+ * If enabled, xml meta data parsed on a cache miss is stored in the
+ * cache for subsequent processes.
+ */
+XRT_CORE_COMMON_EXPORT
+xml_metadata
+get(const xrt::uuid& uuid, const char* xml_data, size_t xml_size);
+
+}}} // metadata_cache, xclbin, xrt_core
+
+#endif
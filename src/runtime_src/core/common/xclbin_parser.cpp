@@ -19,8 +19,13 @@
 #include "error.h"
 
 #include <algorithm>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <sstream>
+#include <string_view>
 #include <cstring>
 #include <cstdlib>
 #include <boost/property_tree/ptree.hpp>
@@ -387,6 +392,201 @@ merge_args(std::vector<xrt_core::xclbin::kernel_argument>& args)
       throw std::runtime_error("xclbin parser internal error: mismatched argument index");
 }
 
+// Parsed embedded xml meta data keyed by a digest of the xml.
+//
+// The xml entry points are called repeatedly for the same xclbin, once
+// per kernel for properties and arguments, for the CU list, project
+// name, etc.  Parsing the xml dominates the cost of these queries, so
+// the parsed tree is cached and shared by all queries against the same
+// xml.  The xml entry points carry no uuid, so entries are looked up
+// by a hash of the xml content and its size, which is orders of
+// magnitude cheaper to compute than parsing the xml.  A copy of the xml
+// is kept with the parsed tree and compared on a hash match, such that
+// a hash collision never returns the meta data of another xclbin.  The
+// cache is bounded to a few entries, most recently used first, and an
+// entry is released when the xclbin owning the xml is unloaded, see
+// release_xml_metadata().
+class xml_cache
+{
+  static constexpr size_t max_entries = 8;
+
+  struct digest
+  {
+    size_t hash;
+    size_t size;
+
+    digest(const char* xml_data, size_t xml_size)
+      : hash(std::hash<std::string_view>{}(std::string_view{xml_data, xml_size}))
+      , size(xml_size)
+    {}
+
+    bool
+    operator==(const digest& rhs) const
+    {
+      return hash == rhs.hash && size == rhs.size;
+    }
+  };
+
+  struct entry
+  {
+    digest key;
+    std::string xml;
+    std::shared_ptr<const pt::ptree> project;
+
+    bool
+    matches(const digest& k, const char* xml_data) const
+    {
+      return key == k && std::memcmp(xml.data(), xml_data, xml.size()) == 0;
+    }
+  };
+
+  std::mutex m_mutex;
+  std::list<entry> m_entries;
+
+  std::shared_ptr<const pt::ptree>
+  lookup(const digest& key, const char* xml_data)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto itr = std::find_if(m_entries.begin(), m_entries.end(), [&key, xml_data](const auto& e) {
+      return e.matches(key, xml_data);
+    });
+    if (itr == m_entries.end())
+      return nullptr;
+
+    m_entries.splice(m_entries.begin(), m_entries, itr);
+    return itr->project;
+  }
+
+  void
+  insert(const digest& key, const char* xml_data, std::shared_ptr<const pt::ptree> project)
+  {
+    std::string xml{xml_data, key.size};
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_entries.push_front(entry{key, std::move(xml), std::move(project)});
+    if (m_entries.size() > max_entries)
+      m_entries.pop_back();
+  }
+
+public:
+  std::shared_ptr<const pt::ptree>
+  get(const char* xml_data, size_t xml_size)
+  {
+    digest key{xml_data, xml_size};
+    if (auto project = lookup(key, xml_data))
+      return project;
+
+    // Parse outside the lock, a concurrent miss on the same xml
+    // parses twice but both results are identical.  Parse errors
+    // propagate to caller and are not cached.
+    auto project = std::make_shared<pt::ptree>();
+    std::stringstream xml_stream;
+    xml_stream.write(xml_data, xml_size);
+    pt::read_xml(xml_stream, *project);
+
+    insert(key, xml_data, project);
+    return project;
+  }
+
+  // Queries in progress keep their shared parsed tree
+  void
+  release(const char* xml_data, size_t xml_size)
+  {
+    digest key{xml_data, xml_size};
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_entries.remove_if([&key, xml_data](const auto& e) { return e.matches(key, xml_data); });
+  }
+};
+
+// The cache is intentionally leaked, xclbin objects with static
+// storage duration release their entry when destroyed at exit, which
+// can be after a function local static cache would be destroyed
+static xml_cache&
+get_xml_cache()
+{
+  static auto cache = new xml_cache; // NOLINT
+  return *cache;
+}
+
+static std::shared_ptr<const pt::ptree>
+get_xml_project(const char* xml_data, size_t xml_size)
+{
+  return get_xml_cache().get(xml_data, xml_size);
+}
+
+// Extract arguments of a kernel xml entry
+static std::vector<xrt_core::xclbin::kernel_argument>
+get_xml_kernel_arguments(const pt::ptree& xml_kernel)
+{
+  using kernel_argument = xrt_core::xclbin::kernel_argument;
+  std::vector<kernel_argument> args;
+
+  auto pwmap = get_portname_width_map(xml_kernel);
+
+  for (auto& xml_arg : xml_kernel) {
+    if (xml_arg.first != "arg")
+      continue;
+
+    std::string id = xml_arg.second.get<std::string>("<xmlattr>.id");
+    size_t index = id.empty() ? kernel_argument::no_index : convert(id);
+
+    std::string port = xml_arg.second.get<std::string>("<xmlattr>.port", "no-port");
+    auto itr = pwmap.find(port);
+    size_t pwidth = (itr != pwmap.end()) ? (*itr).second : 0;
+
+    args.emplace_back(kernel_argument{
+        xml_arg.second.get<std::string>("<xmlattr>.name")
+       ,xml_arg.second.get<std::string>("<xmlattr>.type", "no-type")
+       ,port
+       ,pwidth
+       ,index
+       ,convert(xml_arg.second.get<std::string>("<xmlattr>.offset"))
+       ,convert(xml_arg.second.get<std::string>("<xmlattr>.size"))
+       ,convert(xml_arg.second.get<std::string>("<xmlattr>.hostSize"))
+       ,0  // fa_desc_offset post computed if necessary
+       ,kernel_argument::argtype(xml_arg.second.get<size_t>("<xmlattr>.addressQualifier"))
+       ,kernel_argument::direction(kernel_argument::direction::input)
+    });
+  }
+
+  // stable sort to preserve order of multi-component arguments
+  // for example global_size, local_size, etc.
+  std::stable_sort(args.begin(), args.end(), [](auto& a1, auto& a2) { return a1.index < a2.index; });
+
+  // merge args with same index
+  merge_args(args);
+
+  return args;
+}
+
+// Extract properties of a kernel xml entry without xrt.ini overrides
+static xrt_core::xclbin::kernel_properties
+get_xml_kernel_properties(const pt::ptree& xml_kernel, const std::string& kname)
+{
+  using kernel_properties = xrt_core::xclbin::kernel_properties;
+
+  // Determine features, xrt.ini overrides are applied separately
+  auto mailbox = convert_to_mailbox_type(xml_kernel.get<std::string>("<xmlattr>.mailbox", "none"));
+  auto restart = convert(xml_kernel.get<std::string>("<xmlattr>.countedAutoRestart", "0"));
+  auto sw_reset = to_bool(xml_kernel.get<std::string>("<xmlattr>.swReset", "false"));
+
+  auto functional = get_functional(xml_kernel, "extended-data");
+  auto kernel_id = get_kernel_id(xml_kernel, "extended-data");
+
+  return kernel_properties
+    { kname
+    , to_kernel_type(xml_kernel.get<std::string>("<xmlattr>.type", "pl"))
+    , restart
+    , mailbox
+    , get_address_range(xml_kernel)
+    , sw_reset
+    , functional
+    , kernel_id
+
+    , convert(xml_kernel.get<std::string>("<xmlattr>.workGroupSize", "0"))
+    , get_xyz(xml_kernel, "compileWorkGroupSize")
+    , get_xyz(xml_kernel, "maxWorkGroupSize")
+    , get_stringtable(xml_kernel) };
+}
 
 } // namespace
 
@@ -472,10 +672,8 @@ get_first_used_mem(const axlf* top)
 size_t
 get_max_cu_size(const char* xml_data, size_t xml_size)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
+  auto project = get_xml_project(xml_data, xml_size);
+  const auto& xml_project = *project;
 
   size_t maxsz = 0;
 
@@ -627,10 +825,8 @@ get_cus(const char* xml_data, size_t xml_size, bool)
 {
   std::vector<uint64_t> cus;
 
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data, xml_size);
-  pt::read_xml(xml_stream, xml_project);
+  auto project = get_xml_project(xml_data, xml_size);
+  const auto& xml_project = *project;
 
   for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
     if (xml_kernel.first != "kernel")
@@ -896,10 +1092,8 @@ get_kernel_freq(const axlf* top)
   size_t kernel_clk_freq = default_kernel_clk_freq;
   auto xml = get_xml_section(top);
 
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml.first,xml.second);
-  pt::read_xml(xml_stream,xml_project);
+  auto project = get_xml_project(xml.first, xml.second);
+  const auto& xml_project = *project;
 
   auto clock_child = xml_project.get_child_optional("project.platform.device.core.kernelClocks");
 
@@ -928,57 +1122,16 @@ get_kernel_freq(const axlf* top)
 std::vector<kernel_argument>
 get_kernel_arguments(const char* xml_data, size_t xml_size, const std::string& kname)
 {
-  std::vector<kernel_argument> args;
-
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
-
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
+  auto project = get_xml_project(xml_data, xml_size);
+  for (auto& xml_kernel : project->get_child("project.platform.device.core")) {
     if (xml_kernel.first != "kernel")
       continue;
     if (xml_kernel.second.get<std::string>("<xmlattr>.name") != kname)
       continue;
 
-    auto pwmap = get_portname_width_map(xml_kernel.second);
-
-    for (auto& xml_arg : xml_kernel.second) {
-      if (xml_arg.first != "arg")
-        continue;
-
-      std::string id = xml_arg.second.get<std::string>("<xmlattr>.id");
-      size_t index = id.empty() ? kernel_argument::no_index : convert(id);
-
-      std::string port = xml_arg.second.get<std::string>("<xmlattr>.port", "no-port");
-      auto itr = pwmap.find(port);
-      size_t pwidth = (itr != pwmap.end()) ? (*itr).second : 0;
-
-      args.emplace_back(kernel_argument{
-          xml_arg.second.get<std::string>("<xmlattr>.name")
-         ,xml_arg.second.get<std::string>("<xmlattr>.type", "no-type")
-         ,port
-         ,pwidth
-         ,index
-         ,convert(xml_arg.second.get<std::string>("<xmlattr>.offset"))
-         ,convert(xml_arg.second.get<std::string>("<xmlattr>.size"))
-         ,convert(xml_arg.second.get<std::string>("<xmlattr>.hostSize"))
-         ,0  // fa_desc_offset post computed if necessary
-         ,kernel_argument::argtype(xml_arg.second.get<size_t>("<xmlattr>.addressQualifier"))
-         ,kernel_argument::direction(kernel_argument::direction::input)
-      });
-    }
-
-    // stable sort to preserve order of multi-component arguments
-    // for example global_size, local_size, etc.
-    std::stable_sort(args.begin(), args.end(), [](auto& a1, auto& a2) { return a1.index < a2.index; });
-
-    // merge args with same index
-    merge_args(args);
-
-    break;
+    return get_xml_kernel_arguments(xml_kernel.second);
   }
-  return args;
+  return {};
 }
 
 std::vector<kernel_argument>
@@ -991,46 +1144,16 @@ get_kernel_arguments(const axlf* top, const std::string& kname)
 kernel_properties
 get_kernel_properties(const char* xml_data, size_t xml_size, const std::string& kname)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
-
-  for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
+  auto project = get_xml_project(xml_data, xml_size);
+  for (auto& xml_kernel : project->get_child("project.platform.device.core")) {
     if (xml_kernel.first != "kernel")
       continue;
     if (xml_kernel.second.get<std::string>("<xmlattr>.name") != kname)
       continue;
 
-    // Determine features
-    auto mailbox = convert_to_mailbox_type(xml_kernel.second.get<std::string>("<xmlattr>.mailbox", "none"));
-    if (mailbox == kernel_properties::mailbox_type::none)
-      mailbox = get_mailbox_from_ini(kname);
-    auto restart = convert(xml_kernel.second.get<std::string>("<xmlattr>.countedAutoRestart", "0"));
-    if (restart == 0)
-      restart = get_restart_from_ini(kname);
-    auto sw_reset = to_bool(xml_kernel.second.get<std::string>("<xmlattr>.swReset", "false"));
-    if (!sw_reset)
-      sw_reset = get_sw_reset_from_ini(kname);
-
-    auto functional = get_functional(xml_kernel.second, "extended-data");
-    auto kernel_id = get_kernel_id(xml_kernel.second, "extended-data");
-
-    return kernel_properties
-      { kname
-      , to_kernel_type(xml_kernel.second.get<std::string>("<xmlattr>.type", "pl"))
-      , restart
-      , mailbox
-      , get_address_range(xml_kernel.second)
-      , sw_reset
-      , functional
-      , kernel_id
-
-      , convert(xml_kernel.second.get<std::string>("<xmlattr>.workGroupSize", "0"))
-      , get_xyz(xml_kernel.second, "compileWorkGroupSize")
-      , get_xyz(xml_kernel.second, "maxWorkGroupSize")
-      , get_stringtable(xml_kernel.second) };
-
+    auto properties = get_xml_kernel_properties(xml_kernel.second, kname);
+    apply_ini_overrides(properties);
+    return properties;
   }
 
   return kernel_properties{};
@@ -1048,10 +1171,8 @@ get_kernel_names(const char *xml_data, size_t xml_size)
 {
   std::vector<std::string> names;
 
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
+  auto project = get_xml_project(xml_data, xml_size);
+  const auto& xml_project = *project;
 
   for (auto& xml_kernel : xml_project.get_child("project.platform.device.core")) {
     if (xml_kernel.first != "kernel")
@@ -1063,17 +1184,27 @@ get_kernel_names(const char *xml_data, size_t xml_size)
   return names;
 }
 
+// Single pass over the kernel entries of the xml.  The first entry
+// with a given name is used for properties and arguments.
 std::vector<kernel_object>
 get_kernels(const char* xml_data, size_t xml_size)
 {
   std::vector<kernel_object> kernels;
 
-  auto knames = get_kernel_names(xml_data, xml_size);
-  for (auto& kname : get_kernel_names(xml_data, xml_size)) {
-    auto kprop = get_kernel_properties(xml_data, xml_size, kname);
+  auto project = get_xml_project(xml_data, xml_size);
+  const auto& xml_core = project->get_child("project.platform.device.core");
+  std::map<std::string, const pt::ptree*> first;
+  for (auto& xml_kernel : xml_core) {
+    if (xml_kernel.first != "kernel")
+      continue;
+
+    auto kname = xml_kernel.second.get<std::string>("<xmlattr>.name");
+    auto node = first.emplace(kname, &xml_kernel.second).first->second;
+    auto kprop = get_xml_kernel_properties(*node, kname);
+    apply_ini_overrides(kprop);
     kernels.emplace_back(kernel_object{
         kname
-       ,get_kernel_arguments(xml_data, xml_size, kname)
+       ,get_xml_kernel_arguments(*node)
        ,kprop.address_range
        ,kprop.sw_reset
     });
@@ -1089,6 +1220,47 @@ get_kernels(const axlf* top)
   return get_kernels(xml.first, xml.second);
 }
 
+void
+release_xml_metadata(const char* xml_data, size_t xml_size)
+{
+  if (xml_data)
+    get_xml_cache().release(xml_data, xml_size);
+}
+
+xml_metadata
+get_xml_metadata(const char* xml_data, size_t xml_size)
+{
+  xml_metadata md;
+
+  auto project = get_xml_project(xml_data, xml_size);
+  md.project_name = project->get<std::string>("project.<xmlattr>.name","");
+  md.fpga_device_name = project->get<std::string>("project.platform.device.<xmlattr>.fpgaDevice","");
+
+  // same kernel entries and first match semantics as get_kernels()
+  std::map<std::string, const pt::ptree*> first;
+  for (auto& xml_kernel : project->get_child("project.platform.device.core")) {
+    if (xml_kernel.first != "kernel")
+      continue;
+
+    auto kname = xml_kernel.second.get<std::string>("<xmlattr>.name");
+    auto node = first.emplace(kname, &xml_kernel.second).first->second;
+    md.kernels.push_back({get_xml_kernel_properties(*node, kname), get_xml_kernel_arguments(*node)});
+  }
+
+  return md;
+}
+
+void
+apply_ini_overrides(kernel_properties& properties)
+{
+  if (properties.mailbox == kernel_properties::mailbox_type::none)
+    properties.mailbox = get_mailbox_from_ini(properties.name);
+  if (properties.counted_auto_restart == 0)
+    properties.counted_auto_restart = get_restart_from_ini(properties.name);
+  if (!properties.sw_reset)
+    properties.sw_reset = get_sw_reset_from_ini(properties.name);
+}
+
 // AIE only xclbin has LOAD_AIE action mask
 bool
 is_aie_only(const axlf* top)
@@ -1110,10 +1282,8 @@ get_vbnv(const axlf* top)
 std::string
 get_project_name(const char* xml_data, size_t xml_size)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
+  auto project = get_xml_project(xml_data, xml_size);
+  const auto& xml_project = *project;
 
   return xml_project.get<std::string>("project.<xmlattr>.name","");
 }
@@ -1133,10 +1303,8 @@ get_project_name(const axlf* top)
 std::string
 get_fpga_device_name(const char* xml_data, size_t xml_size)
 {
-  pt::ptree xml_project;
-  std::stringstream xml_stream;
-  xml_stream.write(xml_data,xml_size);
-  pt::read_xml(xml_stream,xml_project);
+  auto project = get_xml_project(xml_data, xml_size);
+  const auto& xml_project = *project;
 
   return xml_project.get<std::string>("project.platform.device.<xmlattr>.fpgaDevice","");
 }
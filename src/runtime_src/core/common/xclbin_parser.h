@@ -81,6 +81,24 @@ struct kernel_object
   bool sw_reset;
 };
 
+// struct xml_metadata - meta data extracted from xml section of xclbin
+//
+// All xml meta data used by xrt::xclbin extracted in one pass.  Kernel
+// properties are as specified in the xml, xrt.ini kernel overrides
+// are not applied, see apply_ini_overrides().
+struct xml_metadata
+{
+  struct kernel
+  {
+    kernel_properties properties;
+    std::vector<kernel_argument> args;
+  };
+
+  std::string project_name;
+  std::string fpga_device_name;
+  std::vector<kernel> kernels;
+};
+
 // struct softkernel_object - wrapper for a soft kernel object
 //
 // @ninst: number of instances
@@ -390,6 +408,38 @@ XRT_CORE_COMMON_EXPORT
 std::vector<kernel_object>
 get_kernels(const axlf* top);
 
+/**
+ * get_xml_metadata() - Get meta data for project and all kernels
+ *
+ * Return: struct xml_metadata with one kernel entry per kernel
+ * element in the xml.
+ */
+XRT_CORE_COMMON_EXPORT
+xml_metadata
+get_xml_metadata(const char* xml_data, size_t xml_size);
+
+/**
+ * release_xml_metadata() - Release cached meta data parsed from xml
+ *
+ * The parsed xml meta data is cached across queries of the same xml.
+ * Called when the xclbin owning the xml is unloaded, including by
+ * xclbin objects destroyed at process exit.
+ */
+XRT_CORE_COMMON_EXPORT
+void
+release_xml_metadata(const char* xml_data, size_t xml_size);
+
+/**
+ * apply_ini_overrides() - Apply xrt.ini kernel feature overrides
+ *
+ * Kernel features not enabled in xml meta data can be enabled per
+ * kernel in xrt.ini.  Applied by get_kernel_properties(), must be
+ * applied explicitly to properties from get_xml_metadata().
+ */
+XRT_CORE_COMMON_EXPORT
+void
+apply_ini_overrides(kernel_properties& properties);
+
 /**
  * is_aie_only() - check if xclbin passed is aie only xclbin
  */
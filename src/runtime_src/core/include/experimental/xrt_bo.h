@@ -15,3 +15,64 @@
  * under the License.
  */
 #include "xrt/xrt_bo.h"
+
+#ifndef XRT_EXPERIMENTAL_BO_H
+#define XRT_EXPERIMENTAL_BO_H
+
+#ifdef __cplusplus
+# include <vector>
+#endif
+
+#ifdef __cplusplus
+namespace xrt {
+
+/**
+ * struct bo_sync_range - A range of a buffer object to synchronize
+ *
+ * @var bo
+ *  Buffer object, possibly a sub-buffer
+ * @var dir
+ *  To device or from device
+ * @var size
+ *  Size of data to synchronize
+ * @var offset
+ *  Offset within the buffer object
+ */
+struct bo_sync_range
+{
+  xrt::bo bo;
+  xclBOSyncDirection dir;
+  size_t size;
+  size_t offset;
+};
+
+/**
+ * sync() - Synchronize a list of buffer ranges with device side
+ *
+ * @param ranges
+ *  The buffer ranges to synchronize
+ *
+ * The ranges are synchronized as if ``xrt::bo::sync()`` was called
+ * for each of them, but ranges of sub-buffers are resolved to their
+ * parent buffer, adjacent and overlapping ranges of the same parent
+ * buffer and direction are merged, and the merged ranges of a parent
+ * buffer are passed to the driver as one list.  This reduces the
+ * sync overhead for layouts with many small sub-buffers.  Drivers
+ * without a multi-range interface sync the merged ranges one at a
+ * time.
+ *
+ * The order in which ranges are synchronized is unspecified.  Ranges
+ * syncing the same memory in both directions must be synchronized
+ * separately.
+ *
+ * Throws if any range exceeds the size of its buffer object.  In
+ * this case no range has been synchronized.
+ */
+XCL_DRIVER_DLLESPEC
+void
+sync(const std::vector<bo_sync_range>& ranges);
+
+} // namespace xrt
+#endif // __cplusplus
+
+#endif
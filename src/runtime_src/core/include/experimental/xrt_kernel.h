@@ -12,6 +12,8 @@
 # include "xrt/detail/pimpl.h"
 # include <chrono>
 # include <condition_variable>
+# include <type_traits>
+# include <vector>
 #endif
 
 #ifdef __cplusplus
@@ -153,6 +155,30 @@ public:
   void
   execute();
 
+  /**
+   * execute() - Execute the runlist repeatedly
+   *
+   * @param iterations
+   *  Number of times to execute the runlist
+   *
+   * The runlist is executed the specified number of times as if
+   * execute() and wait() were called in a loop, but consecutive
+   * iterations are pipelined such that iteration N+1 is submitted
+   * while iteration N is still executing.  The function returns when
+   * the last iteration has been submitted, wait() must be called to
+   * wait for the last iteration to complete.
+   *
+   * Run objects are not restarted between iterations, so kernel
+   * arguments must not be changed until the runlist has completed.
+   *
+   * Throws if runlist is already executing.  Throws
+   * `xrt::runlist::command_error` if an iteration fails before the
+   * last iteration is submitted.
+   */
+  XRT_API_EXPORT
+  void
+  execute(size_t iterations);
+
   /**
    * wait() - Wait for the runlist to complete
    *
@@ -239,6 +265,158 @@ public:
   reset();
 };
 
+/**
+ * start() - Start a batch of run objects
+ *
+ * @param runs
+ *  The run objects to start
+ *
+ * The run objects are started as if ``xrt::run::start()`` was called
+ * for each of them, but run objects sharing the same hardware queue
+ * are handed to the driver as one list.  Drivers that support
+ * submission of multiple commands in one call submit the list at
+ * once, which reduces the submission overhead when many small
+ * kernels are launched back to back.  Other drivers submit the run
+ * objects one by one.
+ *
+ * Unlike a runlist, the run objects in a batch are independent.
+ * They may execute in any order, completion is tracked per run
+ * object, and each run object must be waited on individually.
+ *
+ * Throws if any run object cannot be started, e.g. if it is already
+ * running or belongs to a runlist.  In this case none of the run
+ * objects have been started.
+ *
+ * Throws if the driver fails to submit a run object.  In this case
+ * the run objects that were submitted are running and must be
+ * waited on, while the run objects that were not submitted report
+ * ``ERT_CMD_STATE_ABORT`` from ``xrt::run::state()`` and can be
+ * started again.
+ */
+XRT_API_EXPORT
+void
+start(const std::vector<xrt::run>& runs);
+
+/**
+ * struct wait_policy - Policy for waiting on run completion
+ *
+ * @var spin
+ *  Busy poll the run object state for this long
+ * @var yield
+ *  Then poll the run object state while yielding the cpu for this long
+ *
+ * After spinning and yielding, ``xrt::run::wait()`` blocks in the
+ * driver until the run completes.  For kernels that complete in a
+ * few microseconds, spinning avoids the latency of a blocking wait
+ * and subsequent wake up at the cost of cpu cycles.
+ *
+ * The default policy is to block immediately, it can be changed
+ * globally with xrt.ini keys ``Runtime.wait_spin_us`` and
+ * ``Runtime.wait_yield_us``.
+ */
+struct wait_policy
+{
+  std::chrono::microseconds spin {0};
+  std::chrono::microseconds yield {0};
+};
+
+/**
+ * set_wait_policy() - Set the wait policy of a run object
+ *
+ * @param run
+ *  The run object to change wait policy for
+ * @param policy
+ *  The new wait policy
+ *
+ * The policy applies to ``xrt::run::wait()`` of run objects that
+ * are not managed by a completion callback.
+ */
+XRT_API_EXPORT
+void
+set_wait_policy(const xrt::run& run, const wait_policy& policy);
+
+/**
+ * class arg_plan - Precompiled argument binding plan for a run object
+ *
+ * @brief
+ * An argument plan is used to set arguments of a run object in hot
+ * loops where one or a few arguments change between starts.
+ *
+ * @details
+ * The plan resolves the argument meta data and the location of each
+ * argument in the command payload when it is constructed.  Setting
+ * an argument through the plan copies the value directly into the
+ * command payload without validation, heap allocation, or locking.
+ *
+ * Unlike ``xrt::run::set_arg()``, the connectivity of a buffer
+ * argument is not validated against the compute units of the run
+ * object.  It is undefined behavior to set a buffer that is not
+ * connected to the compute units selected by arguments set prior
+ * to constructing the plan.
+ *
+ * The plan shares the run object and must not be used concurrently
+ * with the run object or while the run object is running.
+ */
+class arg_plan_impl;
+class arg_plan : public detail::pimpl<arg_plan_impl>
+{
+public:
+  arg_plan() = default;
+
+  /**
+   * arg_plan() - Construct plan for a run object
+   *
+   * @param run
+   *  Run object to set arguments for
+   */
+  XRT_API_EXPORT
+  explicit
+  arg_plan(const xrt::run& run);
+
+  /**
+   * set_arg() - Set a global argument
+   *
+   * @param index
+   *  Index of kernel argument
+   * @param bo
+   *  Buffer object argument value
+   */
+  XRT_API_EXPORT
+  void
+  set_arg(int index, const xrt::bo& bo);
+
+  /**
+   * set_arg() - Set a scalar argument
+   *
+   * @param index
+   *  Index of kernel argument
+   * @param value
+   *  Pointer to argument value
+   * @param bytes
+   *  Size of argument value, at most the size of the kernel argument
+   *  is copied
+   */
+  XRT_API_EXPORT
+  void
+  set_arg(int index, const void* value, size_t bytes);
+
+  /**
+   * set_arg() - Set a scalar argument
+   *
+   * @param index
+   *  Index of kernel argument
+   * @param value
+   *  Argument value
+   */
+  template <typename ArgType, typename = std::enable_if_t<!std::is_base_of_v<xrt::bo, ArgType>>>
+  void
+  set_arg(int index, const ArgType& value)
+  {
+    static_assert(std::is_trivially_copyable_v<ArgType>, "argument must be trivially copyable");
+    set_arg(index, &value, sizeof(value));
+  }
+};
+
 } // namespace xrt
 
 #endif // __cplusplus
@@ -10,6 +10,8 @@
 #include "xrt/detail/pimpl.h"
 
 #ifdef __cplusplus
+# include <chrono>
+# include <condition_variable>
 # include <memory>
 #endif
 
@@ -90,9 +92,29 @@ public:
       : detail::pimpl<async_handle_impl>(std::move(handle))
     {}
 
+    /**
+     * wait() - Wait for the asynchronous operation to complete
+     *
+     * Any error from the operation is rethrown by wait().
+     */
     XCL_DRIVER_DLLESPEC
     void
     wait();
+
+    /**
+     * wait() - Wait for the asynchronous operation to complete
+     *
+     * @param timeout
+     *  Timeout for wait.  A value of 0 waits indefinitely.
+     * @return
+     *  std::cv_status::no_timeout when the operation completed,
+     *  std::cv_status::timeout otherwise.
+     *
+     * Any error from the operation is rethrown by wait().
+     */
+    XCL_DRIVER_DLLESPEC
+    std::cv_status
+    wait(const std::chrono::milliseconds& timeout);
   };
 
 public:
@@ -538,6 +560,15 @@ public:
    *
    * Asynchronously transfer specified size bytes of buffer
    * starting at specified offset.
+   *
+   * Asynchronous operations on the same buffer object (including its
+   * sub-buffers) complete in the order they were started.  The host
+   * must not modify (to device) or read (from device) the transferred
+   * range until the operation has completed.
+   *
+   * Throws if the direction is invalid or if the range exceeds the
+   * buffer.  Errors from the transfer itself are rethrown by
+   * async_handle::wait().
    */
   XCL_DRIVER_DLLESPEC
   async_handle
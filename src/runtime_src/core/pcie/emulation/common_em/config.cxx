@@ -85,6 +85,7 @@ namespace xclemulation{
     mIsPlatformDataAvailable = false;
     mIsDisabledHostBuffer = false;
     mIsFasterNocDDRAccessEnabled = true;
+    mIsSharedDeviceMemory = false;
   }
 
   static bool getBoolValue(std::string& value,bool defaultValue)
@@ -257,6 +258,10 @@ namespace xclemulation{
       {
         mIsFasterNocDDRAccessEnabled = getBoolValue(value, true);
       }
+      else if(name == "shared_device_memory")
+      {
+        mIsSharedDeviceMemory = getBoolValue(value, false);
+      }
       else if(name == "packet_size")
       {
         unsigned int packetSize = strtoll(value.c_str(),NULL,0);
@@ -318,6 +318,7 @@ struct sParseLog
       inline bool getIsPlatformEnabled() { return mIsPlatformDataAvailable;}
       inline bool isDisabledHostBUffer() { return mIsDisabledHostBuffer;}
       inline bool isFastNocDDRAccessEnabled() { return mIsFasterNocDDRAccessEnabled;}
+      inline bool isSharedDeviceMemory() const { return mIsSharedDeviceMemory; }
       void populateEnvironmentSetup(std::map<std::string,std::string>& mEnvironmentNameValueMap);
 
     private:
@@ -355,6 +356,7 @@ struct sParseLog
       bool mIsPlatformDataAvailable;
       bool mIsDisabledHostBuffer;
       bool mIsFasterNocDDRAccessEnabled;
+      bool mIsSharedDeviceMemory;
       TIMEOUT_SCALE mTimeOutScale;
       config();
       ~config() { };//empty destructor
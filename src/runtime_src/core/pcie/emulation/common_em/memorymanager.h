@@ -20,6 +20,8 @@
 #include <mutex>
 #include <list>
 #include <map>
+#include <set>
+#include <string>
 #include <cassert>
 #include <algorithm>
 
@@ -30,20 +32,26 @@ namespace xclemulation
 {
 static std::map<uint64_t,uint64_t> DEFAULT_MAP;
 static std::string DEFAULT_TAG("");
+
+    // class MemoryManager - allocator of emulated device memory
+    //
+    // Free memory is kept coalesced in a tree ordered by address and
+    // indexed by size, busy buffers in a tree ordered by address, such
+    // that alloc, free and lookup are O(log n) in the number of
+    // buffers.  Allocation is best fit, lowest address among equally
+    // sized free ranges.
     class MemoryManager 
     {
         std::mutex mMemManagerMutex;
-        std::list<std::pair<uint64_t, uint64_t> > mFreeBufferList;
-        std::list<std::pair<uint64_t, uint64_t> > mBusyBufferList;
+        std::map<uint64_t, uint64_t> mFreeBuffers;              // start -> size
+        std::set<std::pair<uint64_t, uint64_t> > mFreeBySize;   // (size, start)
+        std::map<uint64_t, uint64_t> mBusyBuffers;              // start -> size
         uint64_t mSize;
         uint64_t mStart;
         uint64_t mAlignment;
 	std::string mTag;
-        const unsigned mCoalesceThreshold;
         uint64_t mFreeSize;
 
-        typedef std::list<std::pair<uint64_t, uint64_t> > PairList;
-
     public:
 	static const uint64_t mNull = 0xffffffffffffffffull;
 	std::list<MemoryManager*> mChildMemories;
@@ -64,8 +72,8 @@ static std::string DEFAULT_TAG("");
         std::pair<uint64_t, uint64_t>lookup(uint64_t buf);
 
     private:
-        void coalesce();
-        PairList::iterator find(uint64_t buf);
+        void insertFree(uint64_t start, uint64_t size);
+        void eraseFree(std::map<uint64_t, uint64_t>::iterator it);
     };
 }
 
@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Microbenchmark of xclemulation::MemoryManager compared with the
+// list based allocator it replaced.  Each run allocates a number of
+// buffers of random size, frees half of them in random order, looks up
+// the remaining ones, and allocates again into the fragmented space.
+// The new allocator is also checked for overlapping buffers and free
+// size accounting.
+//
+// % memorymanager_bench [<buffers>]
+#include "memorymanager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// List based allocator as it was before the ordered tree allocator,
+// without child memories
+class list_memory_manager
+{
+  using pair_list = std::list<std::pair<uint64_t, uint64_t>>;
+
+  pair_list m_free;
+  pair_list m_busy;
+  uint64_t m_alignment;
+  const unsigned m_coalesce_threshold = 4;
+
+  pair_list::iterator
+  find(uint64_t buf)
+  {
+    return std::find_if(m_busy.begin(), m_busy.end(), [buf](const auto& s) { return s.first == buf; });
+  }
+
+  void
+  coalesce()
+  {
+    m_free.sort();
+    auto curr = m_free.begin();
+    auto next = std::next(curr);
+    while (next != m_free.end()) {
+      if (curr->first + curr->second != next->first) {
+        curr = next++;
+        continue;
+      }
+      curr->second += next->second;
+      m_free.erase(next);
+      next = std::next(curr);
+    }
+  }
+
+public:
+  list_memory_manager(uint64_t size, uint64_t start, uint64_t alignment)
+    : m_alignment(alignment)
+  {
+    m_free.emplace_back(start, size);
+  }
+
+  uint64_t
+  alloc(size_t& size)
+  {
+    if (size == 0)
+      size = m_alignment;
+    const size_t mod_size = size % m_alignment;
+    size += mod_size ? m_alignment - mod_size : 0;
+
+    for (auto i = m_free.begin(); i != m_free.end(); ++i) {
+      if (i->second < size)
+        continue;
+      auto result = i->first;
+      if (i->second > size) {
+        i->first += size;
+        i->second -= size;
+      }
+      else
+        m_free.erase(i);
+      m_busy.emplace_back(result, size);
+      return result;
+    }
+    return xclemulation::MemoryManager::mNull;
+  }
+
+  void
+  free(uint64_t buf)
+  {
+    auto i = find(buf);
+    if (i == m_busy.end())
+      return;
+    m_free.emplace_back(*i);
+    m_busy.erase(i);
+    if (m_free.size() > m_coalesce_threshold)
+      coalesce();
+  }
+
+  std::pair<uint64_t, uint64_t>
+  lookup(uint64_t buf)
+  {
+    auto i = find(buf);
+    if (i != m_busy.end())
+      return *i;
+    const uint64_t null = xclemulation::MemoryManager::mNull;
+    return {null, null};
+  }
+};
+
+constexpr uint64_t page_size = 0x1000;
+constexpr uint64_t memory_size = 64ull << 30;   // 64GB bank
+constexpr uint64_t memory_start = 0x400000000ull;
+
+std::vector<size_t>
+random_sizes(size_t count)
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> dist(1, 64 * page_size);
+  std::vector<size_t> sizes(count);
+  for (auto& size : sizes)
+    size = dist(gen);
+  return sizes;
+}
+
+std::vector<size_t>
+random_order(size_t count)
+{
+  std::vector<size_t> order(count);
+  for (size_t i = 0; i < count; ++i)
+    order[i] = i;
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+  return order;
+}
+
+template <typename Manager>
+long long
+run(Manager& mm, const std::vector<size_t>& sizes, const std::vector<size_t>& order, std::vector<uint64_t>& bufs)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    size_t size = sizes[i];
+    bufs[i] = mm.alloc(size);
+  }
+
+  // free every other buffer in random order to fragment the memory
+  for (auto i : order)
+    if (i % 2)
+      mm.free(bufs[i]);
+
+  for (size_t i = 0; i < sizes.size(); i += 2)
+    if (Manager::isNullAlloc(mm.lookup(bufs[i])))
+      throw std::runtime_error("lookup failed");
+
+  // reallocate into the freed space
+  for (size_t i = 1; i < sizes.size(); i += 2) {
+    size_t size = sizes[i];
+    bufs[i] = mm.alloc(size);
+  }
+
+  for (auto i : order)
+    mm.free(bufs[i]);
+
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+// isNullAlloc for run() on the legacy allocator
+struct list_manager : list_memory_manager
+{
+  using list_memory_manager::list_memory_manager;
+
+  static bool
+  isNullAlloc(const std::pair<uint64_t, uint64_t>& buf)
+  {
+    return xclemulation::MemoryManager::isNullAlloc(buf);
+  }
+};
+
+// Random alloc and free, verify busy buffers never overlap and the
+// memory is whole again when everything is freed
+bool
+verify(size_t count)
+{
+  xclemulation::MemoryManager mm(count * page_size * 4, memory_start, page_size);
+  std::map<uint64_t, uint64_t> busy;
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<size_t> dist(0, 4 * page_size);
+
+  for (size_t i = 0; i < count * 4; ++i) {
+    if (busy.empty() || gen() % 3) {
+      size_t size = dist(gen);
+      auto buf = mm.alloc(size);
+      if (buf == xclemulation::MemoryManager::mNull)
+        continue;
+      auto next = busy.lower_bound(buf);
+      if ((next != busy.end() && buf + size > next->first) ||
+          (next != busy.begin() && std::prev(next)->first + std::prev(next)->second > buf))
+        return false;
+      if (mm.lookup(buf) != std::make_pair(buf, static_cast<uint64_t>(size)))
+        return false;
+      busy.emplace(buf, size);
+    }
+    else {
+      auto it = std::next(busy.begin(), gen() % busy.size());
+      mm.free(it->first);
+      busy.erase(it);
+    }
+  }
+
+  for (auto& [buf, size] : busy)
+    mm.free(buf);
+
+  // whole memory must be allocatable again in one buffer
+  size_t size = mm.size();
+  return mm.freeSize() == mm.size() && mm.alloc(size) == memory_start;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 20000;
+    auto sizes = random_sizes(count);
+    auto order = random_order(count);
+    std::vector<uint64_t> bufs(count);
+
+    list_manager legacy(memory_size, memory_start, page_size);
+    auto legacy_us = run(legacy, sizes, order, bufs);
+
+    xclemulation::MemoryManager mm(memory_size, memory_start, page_size);
+    auto tree_us = run(mm, sizes, order, bufs);
+
+    std::cout << count << " buffers\n";
+    std::cout << "list allocator: " << legacy_us << " us\n";
+    std::cout << "tree allocator: " << tree_us << " us ("
+              << static_cast<double>(legacy_us) / static_cast<double>(std::max(tree_us, 1LL)) << "x)\n";
+
+    if (!verify(count / 4)) {
+      std::cout << "FAILED TEST" << std::endl;
+      return 1;
+    }
+
+    std::cout << "PASSED TEST" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+}
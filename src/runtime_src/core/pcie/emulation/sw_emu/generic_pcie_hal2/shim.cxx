@@ -849,7 +849,7 @@ namespace xclswemuhal2
     return result;
   }
 
-  uint64_t SwEmuShim::xclAllocDeviceBuffer2(size_t &size, xclMemoryDomains domain, unsigned flags, bool zeroCopy, std::string &sFileName)
+  uint64_t SwEmuShim::xclAllocDeviceBuffer2(size_t &size, xclMemoryDomains domain, unsigned flags, bool zeroCopy, std::string &sFileName, bool sharedMemory)
   {
     if (mLogStream.is_open())
       mLogStream << __func__ << " , " << std::this_thread::get_id() << ", " << size << ", " << domain << ", " << flags << std::endl;
@@ -881,10 +881,12 @@ namespace xclswemuhal2
     }
 
     bool ack = false;
+    // shared device memory requests the buffer to be backed by a file the shim can map
+    bool p2pBuffer = zeroCopy || sharedMemory;
     // Memory Manager Has allocated aligned address,
     // size contains alignement + original size requested.
     // We are passing original size to device process for exact stats.
-    xclAllocDeviceBuffer_RPC_CALL(xclAllocDeviceBuffer, result, size, zeroCopy);
+    xclAllocDeviceBuffer_RPC_CALL(xclAllocDeviceBuffer, result, size, p2pBuffer);
 
     if (!ack)
     {
@@ -892,6 +894,9 @@ namespace xclswemuhal2
       return 0;
     }
 
+    if (sharedMemory && !sFileName.empty())
+      mapSharedDeviceMemory(result, size, sFileName);
+
     DEBUG_MSGS("%s, %d(ENDED)\n", __func__, __LINE__);
     PRINTENDFUNC;
     return result;
@@ -909,6 +914,7 @@ namespace xclswemuhal2
         i->free(offset);
       }
     }
+    unmapSharedDeviceMemory(offset);
     bool ack = true;
     if (sock)
     {
@@ -1115,6 +1121,13 @@ namespace xclswemuhal2
     src = (unsigned char *)src + seek;
     dest += seek;
 
+    if (auto shared = getSharedDeviceMemory(dest, size))
+    {
+      std::memmove(shared, src, size);
+      DEBUG_MSGS("%s, %d(shared device memory ENDED)\n", __func__, __LINE__);
+      return size;
+    }
+
     void *handle = this;
 
     unsigned int messageSize = get_messagesize();
@@ -1160,6 +1173,14 @@ namespace xclswemuhal2
       launchTempProcess();
 
     src += skip;
+
+    if (auto shared = getSharedDeviceMemory(src, size))
+    {
+      std::memmove(dest, shared, size);
+      DEBUG_MSGS("%s, %d(shared device memory ENDED)\n", __func__, __LINE__);
+      return size;
+    }
+
     void *handle = this;
 
     unsigned int messageSize = get_messagesize();
@@ -1188,6 +1209,90 @@ namespace xclswemuhal2
     return size;
   }
 
+  void SwEmuShim::mapSharedDeviceMemory(uint64_t base, size_t size, const std::string &sFileName)
+  {
+    // buffer stays on the RPC data path if the file cannot be mapped
+    int fd = open(sFileName.c_str(), O_RDWR);
+    if (fd == -1)
+    {
+      if (mLogStream.is_open())
+        mLogStream << __func__ << ", failed to open shared device memory " << sFileName << std::endl;
+      return;
+    }
+
+    void *data = MAP_FAILED;
+    size_t pageOffset = 0;
+    auto isSinglemMapDisabled = std::getenv("VITIS_SW_EMU_DISABLE_SINGLE_MMAP");
+    if (isSinglemMapDisabled)
+    {
+      // one file per buffer
+      if (ftruncate(fd, size) != -1)
+        data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    else
+    {
+      // one file for all device memory, buffer is at its device address,
+      // the mapping starts at the page containing the buffer
+      pageOffset = base % getpagesize();
+      data = mmap(0, size + pageOffset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, base - pageOffset);
+    }
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+      std::string msg = "Failed to map shared device memory " + sFileName
+        + " (" + std::strerror(errno) + "), buffer uses the socket data path";
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg);
+      if (mLogStream.is_open())
+        mLogStream << __func__ << ", " << msg << std::endl;
+      return;
+    }
+
+    DEBUG_MSGS("%s, %d(base: %lx size: %zx data: %p)\n", __func__, __LINE__, base, size, data);
+    std::lock_guard lk(mSharedDeviceMemoryMtx);
+    mSharedDeviceMemory[base] = std::make_tuple(size, static_cast<char *>(data) + pageOffset, pageOffset);
+  }
+
+  void SwEmuShim::unmapSharedDeviceMemory(uint64_t base)
+  {
+    std::lock_guard lk(mSharedDeviceMemoryMtx);
+    auto it = mSharedDeviceMemory.find(base);
+    if (it == mSharedDeviceMemory.end())
+      return;
+    auto [size, data, pageOffset] = it->second;
+    munmap(data - pageOffset, size + pageOffset);
+    mSharedDeviceMemory.erase(it);
+  }
+
+  void SwEmuShim::unmapAllSharedDeviceMemory()
+  {
+    std::lock_guard lk(mSharedDeviceMemoryMtx);
+    for (auto &[base, mem] : mSharedDeviceMemory)
+    {
+      auto [size, data, pageOffset] = mem;
+      munmap(data - pageOffset, size + pageOffset);
+    }
+    mSharedDeviceMemory.clear();
+  }
+
+  // Host address of device memory range [addr, addr + size) if the
+  // range is within one shared buffer, nullptr otherwise.  The caller
+  // copies in place without synchronizing with the device process, as
+  // does the socket data path, so XRT must not sync a buffer while a
+  // kernel that accesses it is running.
+  char *SwEmuShim::getSharedDeviceMemory(uint64_t addr, size_t size)
+  {
+    std::lock_guard lk(mSharedDeviceMemoryMtx);
+    auto it = mSharedDeviceMemory.upper_bound(addr);
+    if (it == mSharedDeviceMemory.begin())
+      return nullptr;
+    --it;
+    auto [bufSize, data, pageOffset] = it->second;
+    if (addr + size > it->first + bufSize)
+      return nullptr;
+    return data + (addr - it->first);
+  }
+
   void SwEmuShim::xclOpen(const char *logfileName)
   {
     xclemulation::config::getInstance()->populateEnvironmentSetup(mEnvironmentNameValueMap);
@@ -1267,6 +1372,7 @@ namespace xclswemuhal2
     {
       mFdToFileNameMap.clear();
     }
+    unmapAllSharedDeviceMemory();
 
     if (mLogStream.is_open())
       mLogStream << __func__ << ", " << std::this_thread::get_id() << std::endl;
@@ -1510,8 +1616,15 @@ namespace xclswemuhal2
     if (mLogStream.is_open())
       mLogStream << __func__ << ", " << std::this_thread::get_id() << ", zeroCopy: " << zeroCopy << std::endl;
 
+    // Shared device memory is used only for buffers that the host syncs
+    // and that take more than one message on the socket data path,
+    // other buffers keep the device process allocation they always had
+    bool sharedMemory = xclemulation::config::getInstance()->isSharedDeviceMemory()
+      && !xclemulation::xocl_bo_dev_only(xobj.get()) && !(xobj->flags & XCL_BO_FLAGS_EXECBUF)
+      && size > get_messagesize();
+
     std::string sFileName("");
-    xobj->base = xclAllocDeviceBuffer2(size, XCL_MEM_DEVICE_RAM, ddr, zeroCopy, sFileName);
+    xobj->base = xclAllocDeviceBuffer2(size, XCL_MEM_DEVICE_RAM, ddr, zeroCopy, sFileName, sharedMemory);
     xobj->filename = sFileName;
     xobj->size = size;
     xobj->userptr = NULL;
@@ -1943,22 +2056,60 @@ namespace xclswemuhal2
       return -1;
     }
 
-    int returnVal = 0;
+    int returnVal = syncBufferRange(bo, dir, size, offset);
+    PRINTENDFUNC;
+    DEBUG_MSGS("%s, %d( ENDED )\n", __func__, __LINE__);
+    return returnVal;
+  }
+
+  // Sync a list of ranges of one buffer under a single API lock and
+  // buffer lookup.  With shared device memory each range is a plain
+  // memory copy, otherwise each range is one copy request to the
+  // device process.
+  int SwEmuShim::xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges)
+  {
+    std::lock_guard lk(mApiMtx);
+    if (mLogStream.is_open())
+      mLogStream << __func__ << ", " << std::this_thread::get_id() << ", " << std::hex << boHandle << ", " << std::dec << ranges.size() << std::endl;
+
+    xclemulation::drm_xocl_bo *bo = xclGetBoByHandle(boHandle);
+    if (!bo)
+    {
+      PRINTENDFUNC;
+      return -1;
+    }
+
+    for (const auto& r : ranges)
+    {
+      if (int returnVal = syncBufferRange(bo, dir, r.size, r.offset))
+      {
+        PRINTENDFUNC;
+        return returnVal;
+      }
+    }
+    PRINTENDFUNC;
+    return 0;
+  }
+
+  // Caller holds mApiMtx
+  int SwEmuShim::syncBufferRange(xclemulation::drm_xocl_bo *bo, xclBOSyncDirection dir, size_t size, size_t offset)
+  {
+    // mapped zero copy buffer is the shared device memory itself
+    if (!bo->userptr && bo->buf && xclemulation::is_zero_copy(bo) && getSharedDeviceMemory(bo->base, bo->size))
+      return 0;
+
+    void *buffer = bo->userptr ? bo->userptr : bo->buf;
     if (dir == XCL_BO_SYNC_BO_TO_DEVICE)
     {
-      void *buffer = bo->userptr ? bo->userptr : bo->buf;
       if (xclCopyBufferHost2Device(bo->base, buffer, size, offset) != size)
-        returnVal = EIO;
+        return EIO;
     }
     else
     {
-      void *buffer = bo->userptr ? bo->userptr : bo->buf;
       if (xclCopyBufferDevice2Host(buffer, bo->base, size, offset) != size)
-        returnVal = EIO;
+        return EIO;
     }
-    PRINTENDFUNC;
-    DEBUG_MSGS("%s, %d( ENDED )\n", __func__, __LINE__);
-    return returnVal;
+    return 0;
   }
   /***************************************************************************************/
 
@@ -166,6 +166,13 @@ namespace xclswemuhal2
         m_shim->xclSyncBO(m_hdl, static_cast<xclBOSyncDirection>(dir), size, offset);
       }
 
+      void
+      sync(direction dir, const std::vector<range>& ranges) override
+      {
+        if (auto ret = m_shim->xclSyncBO(m_hdl, static_cast<xclBOSyncDirection>(dir), ranges))
+          throw xrt_core::system_error(ret, "fail to sync bo ranges");
+      }
+
       void
       copy(const buffer_handle* src, size_t size, size_t dst_offset, size_t src_offset) override
       {
@@ -397,6 +404,7 @@ namespace xclswemuhal2
     void* xclMapBO(unsigned int boHandle, bool write);
     int xclUnmapBO(unsigned int boHandle, void *addr);
     int xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset);
+    int xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, const std::vector<xrt_core::buffer_handle::range>& ranges);
     int xclGetBOProperties(unsigned int boHandle, xclBOProperties *properties);
     size_t xclWriteBO(unsigned int boHandle, const void *src, size_t size, size_t seek);
     size_t xclReadBO(unsigned int boHandle, void *dst, size_t size, size_t skip);
@@ -426,11 +434,22 @@ namespace xclswemuhal2
 
     // Buffer management
     uint64_t xclAllocDeviceBuffer(size_t size);
-    uint64_t xclAllocDeviceBuffer2(size_t &size, xclMemoryDomains domain, unsigned flags, bool p2pBuffer, std::string &sFileName);
+    uint64_t xclAllocDeviceBuffer2(size_t &size, xclMemoryDomains domain, unsigned flags, bool p2pBuffer, std::string &sFileName, bool sharedMemory = false);
 
     void xclFreeDeviceBuffer(uint64_t buf);
     size_t xclCopyBufferHost2Device(uint64_t dest, const void *src, size_t size, size_t seek);
     size_t xclCopyBufferDevice2Host(void *dest, uint64_t src, size_t size, size_t skip);
+    int syncBufferRange(xclemulation::drm_xocl_bo *bo, xclBOSyncDirection dir, size_t size, size_t offset);
+
+    // Shared device memory, buffers backed by a file mapped by both the
+    // shim and the device process.  Copies to and from these buffers are
+    // done in place, only control messages go over the socket.  As with
+    // the socket data path there is no handshake with a running kernel,
+    // a buffer must not be synced while a kernel accessing it runs.
+    void mapSharedDeviceMemory(uint64_t base, size_t size, const std::string &sFileName);
+    void unmapSharedDeviceMemory(uint64_t base);
+    void unmapAllSharedDeviceMemory();
+    char *getSharedDeviceMemory(uint64_t addr, size_t size);
     ssize_t xclUnmgdPwrite(unsigned flags, const void *buf, size_t count, uint64_t offset);
     ssize_t xclUnmgdPread(unsigned flags, void *buf, size_t count, uint64_t offset);
 
@@ -823,6 +842,10 @@ namespace xclswemuhal2
     std::map<int, xclemulation::drm_xocl_bo *> mXoclObjMap;
     static unsigned int mBufferCount;
     static std::map<int, std::tuple<std::string, uint64_t, void *>> mFdToFileNameMap;
+    // device address -> (size, host address, offset of host address in
+    // page aligned mapping) of shared device memory
+    std::map<uint64_t, std::tuple<uint64_t, char *, size_t>> mSharedDeviceMemory;
+    std::mutex mSharedDeviceMemoryMtx;
     // HAL2 RELATED member variables end
     std::list<std::tuple<uint64_t, void *, std::map<uint64_t, uint64_t>>> mReqList;
     uint64_t mReqCounter;
@@ -28,6 +28,7 @@
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace { // private implementation details
 
@@ -337,6 +338,15 @@ mark_cmd_handle_complete(xclBufferHandle handle)
   ++completion_count;
 }
 
+struct cmd_list_type
+{
+  std::vector<xclBufferHandle> handles;
+  unsigned long queue_time;
+  cmd_list_type(std::vector<xclBufferHandle> h)
+    : handles(std::move(h)), queue_time(xrt_core::time_ns())
+  {}
+};
+
 static void
 mark_cmd_complete(cmd_type ct)
 {
@@ -344,6 +354,14 @@ mark_cmd_complete(cmd_type ct)
   mark_cmd_handle_complete(ct.handle);
 }
 
+static void
+mark_cmd_list_complete(const cmd_list_type& cl)
+{
+  while (xrt_core::time_ns() - cl.queue_time < completion_delay_us * 1000);
+  for (auto handle : cl.handles)
+    mark_cmd_handle_complete(handle);
+}
+
 static void
 add(xclBufferHandle handle)
 {
@@ -353,6 +371,18 @@ add(xclBufferHandle handle)
     mark_cmd_handle_complete(handle);
 }
 
+// Add a list of commands as one task, commands in the list complete
+// together
+static void
+add(std::vector<xclBufferHandle> handles)
+{
+  if (completion_delay_us)
+    xrt_core::task::createF(running_queue, mark_cmd_list_complete, cmd_list_type(std::move(handles)));
+  else
+    for (auto handle : handles)
+      mark_cmd_handle_complete(handle);
+}
+
 struct X
 {
   X() { init(); }
@@ -528,6 +558,17 @@ public:
       m_shim->exec_buf(cmd->get_xcl_handle());
     }
 
+    size_t
+    exec_buf(const std::vector<xrt_core::buffer_handle*>& cmds) override
+    {
+      std::vector<xclBufferHandle> handles;
+      handles.reserve(cmds.size());
+      for (auto cmd : cmds)
+        handles.push_back(cmd->get_xcl_handle());
+      m_shim->exec_buf(std::move(handles));
+      return cmds.size();
+    }
+
     bool
     is_null() const
     {
@@ -613,6 +654,13 @@ public:
     return 0;
   }
 
+  int
+  exec_buf(std::vector<buffer_handle_type> handles)
+  {
+    cmd::add(std::move(handles));
+    return 0;
+  }
+
   int
   exec_wait(int msec)
   {
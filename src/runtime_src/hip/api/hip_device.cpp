@@ -6,6 +6,7 @@
 #include "hip/core/common.h"
 #include "hip/core/device.h"
 #include "hip/core/memory_pool.h"
+#include "hip/core/stream.h"
 
 #include <cstring>
 #include <mutex>
@@ -129,6 +130,29 @@ hip_device_get_attribute(hipDeviceAttribute_t attr, int device)
 
   throw std::runtime_error("Not implemented");
 }
+
+// Waits for all streams of the current context, after which memory
+// freed in stream order in these streams is no longer in use
+static void
+hip_device_synchronize()
+{
+  auto ctx = get_current_context();
+  throw_context_destroyed_if(!ctx, "context is destroyed, no active context");
+
+  auto streams = ctx->get_stream_handles();
+  for (auto handle : streams) {
+    if (auto hip_stream = stream_cache.get(handle))
+      hip_stream->await_completion();
+  }
+
+  for (auto& mem_pool : memory_pool_db[ctx->get_dev_id()]) {
+    if (!mem_pool)
+      continue;
+    for (auto handle : streams)
+      mem_pool->release_stream(static_cast<stream*>(handle));
+    mem_pool->purge();
+  }
+}
 } // xrt::core::hip
 
 // =========================================================================
@@ -289,3 +313,20 @@ hipDeviceGetAttribute(int* pi, hipDeviceAttribute_t attr, int device)
   }
   return hipErrorUnknown;
 }
+
+hipError_t
+hipDeviceSynchronize()
+{
+  try {
+    xrt::core::hip::hip_device_synchronize();
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "hip/core/common.h"
+#include "hip/core/event.h"
+#include "hip/core/graph.h"
+#include "hip/core/stream.h"
+
+namespace xrt::core::hip {
+
+// Stream capture records kernel launches and memory copies enqueued to
+// a stream into a graph.  An instantiated graph replays the captured
+// operations with one submission per runlist, see graph_exec.
+
+static void
+hip_stream_begin_capture(hipStream_t stream, hipStreamCaptureMode /*mode*/)
+{
+  // legacy null stream synchronizes with other streams and cannot be captured
+  throw_if(!stream, hipErrorStreamCaptureUnsupported, "null stream cannot be captured");
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+
+  // all capture modes behave as relaxed, commands are recorded per stream
+  hip_stream->begin_capture();
+}
+
+static graph_handle
+hip_stream_end_capture(hipStream_t stream)
+{
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+  throw_if(!hip_stream->is_capturing(), hipErrorStreamCaptureUnmatched, "stream is not capturing");
+
+  return insert_in_map(graph_cache, hip_stream->end_capture());
+}
+
+static hipStreamCaptureStatus
+hip_stream_is_capturing(hipStream_t stream)
+{
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+  return hip_stream->is_capturing() ? hipStreamCaptureStatusActive : hipStreamCaptureStatusNone;
+}
+
+static graph_exec_handle
+hip_graph_instantiate(hipGraph_t graph)
+{
+  throw_invalid_value_if(!graph, "graph is nullptr");
+  auto hip_graph = graph_cache.get(graph);
+  throw_invalid_value_if(!hip_graph, "graph is invalid");
+
+  return insert_in_map(graph_exec_cache, std::make_shared<graph_exec>(*hip_graph));
+}
+
+static void
+hip_graph_launch(hipGraphExec_t graph_exec, hipStream_t stream)
+{
+  throw_invalid_value_if(!graph_exec, "graph exec is nullptr");
+  auto hip_graph_exec = graph_exec_cache.get(graph_exec);
+  throw_invalid_value_if(!hip_graph_exec, "graph exec is invalid");
+
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+
+  // ptr to a xrt::core::hip::command object could be shared between global command_cache
+  // and stream::m_top_event::m_chain_of_commands of a stream object
+  auto s_hdl = hip_stream.get();
+  auto cmd_hdl = insert_in_map(command_cache,
+                               std::make_shared<graph_launch>(hip_stream, std::move(hip_graph_exec)));
+  s_hdl->enqueue(command_cache.get(cmd_hdl));
+}
+
+static void
+hip_graph_destroy(hipGraph_t graph)
+{
+  throw_invalid_value_if(!graph, "graph is nullptr");
+  graph_cache.remove(graph);
+}
+
+static void
+hip_graph_exec_destroy(hipGraphExec_t graph_exec)
+{
+  throw_invalid_value_if(!graph_exec, "graph exec is nullptr");
+  // launches in flight keep the executable graph alive
+  graph_exec_cache.remove(graph_exec);
+}
+} // xrt::core::hip
+
+// =========================================================================
+// Graph related apis implementation
+hipError_t
+hipStreamBeginCapture(hipStream_t stream, hipStreamCaptureMode mode)
+{
+  try {
+    xrt::core::hip::hip_stream_begin_capture(stream, mode);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipStreamEndCapture(hipStream_t stream, hipGraph_t* graph)
+{
+  try {
+    throw_invalid_value_if(!graph, "graph passed is nullptr");
+
+    auto handle = xrt::core::hip::hip_stream_end_capture(stream);
+    *graph = reinterpret_cast<hipGraph_t>(handle);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipStreamIsCapturing(hipStream_t stream, hipStreamCaptureStatus* status)
+{
+  try {
+    throw_invalid_value_if(!status, "status passed is nullptr");
+
+    *status = xrt::core::hip::hip_stream_is_capturing(stream);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphInstantiate(hipGraphExec_t* graph_exec, hipGraph_t graph,
+                    hipGraphNode_t* error_node, char* log_buffer, size_t buffer_size)
+{
+  try {
+    throw_invalid_value_if(!graph_exec, "graph exec passed is nullptr");
+    if (error_node)
+      *error_node = nullptr;
+    if (log_buffer && buffer_size)
+      log_buffer[0] = '\0';
+
+    auto handle = xrt::core::hip::hip_graph_instantiate(graph);
+    *graph_exec = reinterpret_cast<hipGraphExec_t>(handle);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphLaunch(hipGraphExec_t graph_exec, hipStream_t stream)
+{
+  try {
+    xrt::core::hip::hip_graph_launch(graph_exec, stream);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphDestroy(hipGraph_t graph)
+{
+  try {
+    xrt::core::hip::hip_graph_destroy(graph);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphExecDestroy(hipGraphExec_t graph_exec)
+{
+  try {
+    xrt::core::hip::hip_graph_exec_destroy(graph_exec);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
 
+#include <algorithm>
 #include <string>
 #include "core/common/error.h"
 #include "core/common/memalign.h"
@@ -376,8 +377,11 @@ namespace xrt::core::hip
     throw_invalid_value_if(!hip_stream, "Invalid stream handle.");
 
     auto dev = hip_stream->get_device();
-    // each device has a default pool in the front
-    auto mem_pool = memory_pool_db[dev->get_device_id()].front();
+    // free into the pool the memory was allocated from, each device has a default pool in the front
+    const auto& mem_pools = memory_pool_db[dev->get_device_id()];
+    throw_invalid_value_if(mem_pools.empty(), "Invalid memory pool.");
+    auto itr = std::find_if(mem_pools.begin(), mem_pools.end(), [dev_ptr](const auto& pool) { return pool && pool->owns(dev_ptr); });
+    auto mem_pool = itr != mem_pools.end() ? *itr : mem_pools.front();
     throw_invalid_value_if(!mem_pool, "Invalid memory pool.");
 
     // ptr to a xrt::core::hip::command object could be shared between global command_cache and stream::m_top_event::m_chain_of_commands of a stream object
@@ -3,6 +3,7 @@
 
 #include "hip/core/common.h"
 #include "hip/core/event.h"
+#include "hip/core/memory_pool.h"
 #include "hip/core/stream.h"
 
 namespace xrt::core::hip {
@@ -68,6 +69,15 @@ hip_stream_destroy(hipStream_t stream)
   ///we should override clang-tidy warning by adding NOLINT since hipStreamPerThread coming from hip, we dont have control
   throw_invalid_resource_if(stream == hipStreamPerThread, "Stream per thread can't be destroyed"); //NOLINT
 
+  // memory freed in stream order must not stay cached under the address of a destroyed stream,
+  // the stream is drained first as its commands may still use that memory
+  if (auto hip_stream = stream_cache.get(stream)) {
+    hip_stream->await_completion();
+    for (auto& mem_pool : memory_pool_db[hip_stream->get_device()->get_device_id()])
+      if (mem_pool)
+        mem_pool->release_stream(hip_stream.get());
+  }
+
   stream_cache.remove(stream);
 }
 
@@ -76,6 +86,7 @@ hip_stream_synchronize(hipStream_t stream)
 {
   auto hip_stream = get_stream(stream);
   throw_invalid_handle_if(!hip_stream, "stream is invalid");
+  throw_if(hip_stream->is_capturing(), hipErrorStreamCaptureUnsupported, "stream is capturing");
   hip_stream->synchronize();
 }
 
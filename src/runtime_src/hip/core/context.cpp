@@ -65,6 +65,14 @@ get_null_stream()
   return m_null_stream.lock();
 }
 
+copy_engine&
+context::
+get_copy_engine()
+{
+  std::call_once(m_copy_engine_flag, [this] { m_copy_engine = m_device->get_copy_engine(); });
+  return *m_copy_engine;
+}
+
 device*
 get_current_device()
 {
@@ -22,6 +22,8 @@ class context : public std::enable_shared_from_this<context>
   std::weak_ptr<stream> m_null_stream;
   std::vector<stream_handle> m_stream_handles;
   mutable std::mutex m_ctx_stream_lock;
+  std::once_flag m_copy_engine_flag;
+  std::shared_ptr<copy_engine> m_copy_engine;
 
 public:
   context() = default;
@@ -49,6 +51,11 @@ public:
   std::shared_ptr<stream>
   get_null_stream();
 
+  // Device copy engine, acquired on first use and released with
+  // this context
+  copy_engine&
+  get_copy_engine();
+
   void
   add_stream(stream_handle stream)
   {
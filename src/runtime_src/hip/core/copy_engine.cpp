@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "copy_engine.h"
+
+#include <algorithm>
+
+namespace xrt::core::hip {
+
+void
+copy_engine::job::
+complete()
+{
+  // Notify under lock, the job may be destroyed as soon as the
+  // waiter observes completion
+  std::lock_guard lk(m_mutex);
+  m_done = true;
+  m_cv.notify_all();
+}
+
+bool
+copy_engine::job::
+wait()
+{
+  std::unique_lock lk(m_mutex);
+  m_cv.wait(lk, [this] { return m_done; });
+  return !m_error;
+}
+
+std::exception_ptr
+copy_engine::job::
+error()
+{
+  // m_error is written before completion and reset by post()
+  std::lock_guard lk(m_mutex);
+  return m_done ? m_error : nullptr;
+}
+
+bool
+copy_engine::job::
+done()
+{
+  std::lock_guard lk(m_mutex);
+  return m_done;
+}
+
+copy_engine::
+copy_engine(unsigned int workers, size_t chunk_size)
+  : m_chunk_size{std::max<size_t>(chunk_size, 1)}
+{
+  workers = std::max(workers, 1U);
+  m_workers.reserve(workers);
+  for (unsigned int i = 0; i < workers; ++i)
+    m_workers.emplace_back([this] { worker(); });
+}
+
+copy_engine::
+~copy_engine()
+{
+  {
+    std::lock_guard lk(m_mutex);
+    m_stop = true;
+  }
+  m_work.notify_all();
+  for (auto& w : m_workers)
+    w.join();
+}
+
+void
+copy_engine::
+schedule(queue* q)
+{
+  q->m_ready = true;
+  m_ready.push_back(q);
+  m_work.notify_one();
+}
+
+void
+copy_engine::
+post(queue& q, job& j, size_t size)
+{
+  {
+    std::lock_guard lk(j.m_mutex);
+    j.m_done = false;
+  }
+
+  std::lock_guard lk(m_mutex);
+  j.m_size = size;
+  j.m_chunk_size = m_chunk_size;
+  j.m_chunks = std::max<size_t>((size + m_chunk_size - 1) / m_chunk_size, 1);
+  j.m_next = 0;
+  j.m_pending = 0;
+  j.m_error = nullptr;
+  q.m_jobs.push_back(&j);
+
+  // An empty queue is never in the ready list, otherwise the job
+  // is scheduled when the jobs before it complete
+  if (q.m_jobs.size() == 1)
+    schedule(&q);
+}
+
+void
+copy_engine::
+worker()
+{
+  std::unique_lock lk(m_mutex);
+  while (true) {
+    m_work.wait(lk, [this] { return m_stop || !m_ready.empty(); });
+    if (m_ready.empty())
+      return; // stopped and drained
+
+    // Claim next chunk of the job at the head of the queue. The queue
+    // stays in the ready list while the job has unclaimed chunks so
+    // that other workers can copy them concurrently.
+    auto q = m_ready.front();
+    m_ready.pop_front();
+    auto j = q->m_jobs.front();
+    auto idx = j->m_next++;
+    ++j->m_pending;
+    if (j->m_next < j->m_chunks) {
+      m_ready.push_back(q);
+      m_work.notify_one();
+    }
+    else
+      q->m_ready = false;
+
+    auto offset = idx * j->m_chunk_size;
+    auto size = std::min(j->m_chunk_size, j->m_size - std::min(offset, j->m_size));
+
+    lk.unlock();
+    std::exception_ptr error;
+    try {
+      j->copy_chunk(offset, size);
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+    lk.lock();
+
+    if (error && !j->m_error)
+      j->m_error = error;
+
+    if (--j->m_pending || j->m_next < j->m_chunks)
+      continue;
+
+    // Last chunk of job copied, the next job in the queue can start
+    q->m_jobs.pop_front();
+    if (!q->m_jobs.empty())
+      schedule(q);
+
+    lk.unlock();
+    j->complete();
+    lk.lock();
+  }
+}
+
+} // xrt::core::hip
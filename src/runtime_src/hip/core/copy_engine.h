@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrthip_copy_engine_h
+#define xrthip_copy_engine_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xrt::core::hip {
+
+// Copies larger than this are split into chunks that are copied
+// concurrently by the copy engine workers
+const size_t COPY_ENGINE_CHUNK_SIZE = (static_cast<size_t>(4) << 20); // 4MB
+const unsigned int COPY_ENGINE_MAX_WORKERS = 4;
+
+// class copy_engine - persistent worker threads for asynchronous copies
+//
+// There is one copy engine per device that executes the asynchronous
+// copies of all streams on the device.  The engine is held by the
+// contexts that have posted copies, streams hold their context, so
+// the workers are joined when the last such context is destroyed and
+// not from the destructor of the global device cache.  Copies are
+// posted to the queue of the stream that issued them.  A copy starts
+// only after the previous copy posted to the same queue has completed,
+// copies in different queues execute concurrently.  The chunks of a
+// copy are claimed by any idle worker, so a large copy is pipelined
+// across workers.
+class copy_engine
+{
+public:
+  // class job - a copy to be executed by the engine
+  //
+  // The job is embedded in the object that posts it, and its
+  // completion state is reset when posted, so no allocation is
+  // required per copy.  A posted job must not be destroyed before
+  // it has completed.
+  class job
+  {
+    friend class copy_engine;
+
+    // Managed by the engine under the engine lock
+    size_t m_size = 0;
+    size_t m_chunk_size = 0;
+    size_t m_chunks = 0;         // number of chunks
+    size_t m_next = 0;           // index of next unclaimed chunk
+    size_t m_pending = 0;        // claimed chunks not yet copied
+    std::exception_ptr m_error;  // first chunk error
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_done = true;
+
+    void
+    complete();
+
+  protected:
+    // copy_chunk() - Copy size bytes at offset of this job
+    //
+    // Called concurrently for different chunks of the same job.
+    virtual void
+    copy_chunk(size_t offset, size_t size) = 0;
+
+  public:
+    job() = default;
+    virtual ~job() = default;
+    job(const job&) = delete;
+    job& operator=(const job&) = delete;
+
+    // wait() - Wait for the job to complete
+    //
+    // Return false if any chunk failed to copy
+    bool
+    wait();
+
+    // error() - First exception thrown by copy_chunk(), if any
+    std::exception_ptr
+    error();
+
+    // done() - Check if the job has completed
+    bool
+    done();
+  };
+
+  // class queue - ordered sequence of posted jobs, one per stream
+  class queue
+  {
+    friend class copy_engine;
+
+    std::deque<job*> m_jobs;
+    bool m_ready = false;        // in engine ready list
+  };
+
+  explicit
+  copy_engine(unsigned int workers, size_t chunk_size = COPY_ENGINE_CHUNK_SIZE);
+
+  ~copy_engine();
+
+  copy_engine(const copy_engine&) = delete;
+  copy_engine& operator=(const copy_engine&) = delete;
+
+  // post() - Post a job of size bytes to a queue
+  void
+  post(queue& q, job& j, size_t size);
+
+private:
+  void
+  worker();
+
+  // Add queue with claimable chunks to ready list, engine lock held
+  void
+  schedule(queue* q);
+
+  size_t m_chunk_size;
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::deque<queue*> m_ready;
+  bool m_stop = false;
+  std::vector<std::thread> m_workers;
+};
+
+} // xrt::core::hip
+
+#endif
@@ -3,6 +3,9 @@
 
 #include "device.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace xrt::core::hip {
 // Implementation
 //we should override clang-tidy warning by adding NOLINT since device_cache is non-const parameter
@@ -14,4 +17,18 @@ device(uint32_t device_id)
   , m_xrt_device{device_id}
   , m_flags{0}
 {}
+
+std::shared_ptr<copy_engine>
+device::
+get_copy_engine()
+{
+  std::lock_guard lk(m_copy_engine_mutex);
+  if (auto engine = m_copy_engine.lock())
+    return engine;
+
+  auto workers = std::min(std::max(std::thread::hardware_concurrency(), 1U), COPY_ENGINE_MAX_WORKERS);
+  auto engine = std::make_shared<copy_engine>(workers);
+  m_copy_engine = engine;
+  return engine;
+}
 }
@@ -10,7 +10,11 @@
 #include "core/common/api/handle.h"
 #include "xrt/xrt_device.h"
 
+#include "copy_engine.h"
+
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace xrt::core::hip {
@@ -27,6 +31,8 @@ class device
   xrt::device m_xrt_device;
   unsigned int m_flags;
   std::weak_ptr<context> pri_ctx;
+  std::mutex m_copy_engine_mutex;
+  std::weak_ptr<copy_engine> m_copy_engine;
 
 public:
   device() = default;
@@ -65,6 +71,13 @@ public:
   {
     return pri_ctx.lock(); // may return nullptr
   }
+
+  // Copy engine for asynchronous copies of all streams on this
+  // device, started on first use.  The engine is shared by the
+  // contexts on this device that have posted copies and is shut down
+  // with the last of these contexts, the device does not keep it alive
+  std::shared_ptr<copy_engine>
+  get_copy_engine();
 };
 
 // Global map of devices
@@ -125,8 +125,10 @@ kernel_start::kernel_start(std::shared_ptr<stream> s, std::shared_ptr<function>
           throw std::runtime_error("failed to get memory from arg at index - " + std::to_string(idx));
 
         // NPU device is not coherent. We need to sync the buffer objects before launching kernel
-        if (hip_mem->get_type() != memory_type::device)
+        if (hip_mem->get_type() != memory_type::device) {
           hip_mem->sync(xclBOSyncDirection::XCL_BO_SYNC_BO_TO_DEVICE);
+          host_mems.push_back(hip_mem);
+        }
         r.set_arg(arg->index, hip_mem->get_xrt_bo());
         break;
       }
@@ -170,28 +172,49 @@ bool kernel_start::wait()
   return false;
 }
 
+memcpy_command::~memcpy_command()
+{
+  // the copy engine references this command until the copy completes
+  if (get_state() == state::running)
+    job::wait();
+}
+
 bool memcpy_command::submit()
 {
-  m_handle = std::async(std::launch::async, &hipMemcpy, m_dst, m_src, m_size, m_kind);
+  if (get_state() != state::init)
+    return get_state() == state::running;
+
+  set_state(state::running);
+  cstream->post_copy(*this, m_size);
   return true;
 }
 
 bool memcpy_command::wait()
 {
-  m_handle.wait();
-  set_state(state::completed);
+  if (get_state() != state::running)
+    return get_state() == state::completed;
+
+  set_state(job::wait() ? state::completed : state::error);
   return true;
 }
 
+void memcpy_command::copy_chunk(size_t offset, size_t size)
+{
+  auto dst = static_cast<char*>(m_dst) + offset;
+  auto src = static_cast<const char*>(m_src) + offset;
+  auto err = hipMemcpy(dst, src, size, m_kind);
+  throw_if(err != hipSuccess, err, "asynchronous memory copy failed");
+}
+
 bool memory_pool_command::submit()
 {
   switch (m_type)
   {
   case alloc:
-    m_mem_pool->malloc(m_ptr, m_size);
+    m_mem_pool->malloc(m_ptr, m_size, cstream.get());
     break;
   case free:
-    m_mem_pool->free(m_ptr);
+    m_mem_pool->free(m_ptr, cstream.get());
     break;
   
   default:
@@ -208,6 +231,25 @@ bool memory_pool_command::wait()
   return true;
 }
 
+bool graph_launch::submit()
+{
+  if (get_state() != state::init)
+    return get_state() == state::running;
+
+  m_exec->launch(*cstream);
+  set_state(state::running);
+  return true;
+}
+
+bool graph_launch::wait()
+{
+  if (get_state() != state::running)
+    return get_state() == state::completed;
+
+  set_state(m_exec->wait() ? state::completed : state::error);
+  return true;
+}
+
 // Global map of commands
 xrt_core::handle_map<command_handle, std::shared_ptr<command>> command_cache;
 
@@ -4,6 +4,8 @@
 #define xrthip_event_h
 
 #include "common.h"
+#include "copy_engine.h"
+#include "graph.h"
 #include "memory.h"
 #include "memory_pool.h"
 #include "module.h"
@@ -41,7 +43,8 @@ public:
     event,
     kernel_start,
     mem_cpy,
-    mem_pool_op
+    mem_pool_op,
+    graph_launch
   };
 
 protected:
@@ -123,34 +126,61 @@ class kernel_start : public command
 private:
   std::shared_ptr<function> func;
   xrt::run r;
+  std::vector<std::shared_ptr<memory>> host_mems; // synced to device before start
 
 public:
   kernel_start(std::shared_ptr<stream> s, std::shared_ptr<function> f, void** args);
   bool submit() override;
   bool wait() override;
+
+  const std::shared_ptr<function>&
+  get_function() const
+  {
+    return func;
+  }
+
+  const xrt::run&
+  get_run() const
+  {
+    return r;
+  }
+
+  const std::vector<std::shared_ptr<memory>>&
+  get_host_mems() const
+  {
+    return host_mems;
+  }
 };
 
-// memcpy command for hipMemcpyAsync
-class memcpy_command : public command
+// memcpy command for hipMemcpyAsync, executed by the copy engine of
+// the stream's device
+class memcpy_command : public command, private copy_engine::job
 {
 public:
   memcpy_command(std::shared_ptr<stream> s, void* dst, const void* src, size_t size, hipMemcpyKind kind)
     : command(command::type::mem_cpy, std::move(s)), m_dst(dst), m_src(src), m_size(size), m_kind(kind)
   {}
+  ~memcpy_command() override;
   bool submit() override;
   bool wait() override;
 
+  void* get_dst() const { return m_dst; }
+  const void* get_src() const { return m_src; }
+  size_t get_size() const { return m_size; }
+  hipMemcpyKind get_kind() const { return m_kind; }
+
 protected:
+  void copy_chunk(size_t offset, size_t size) override;
+
   void* m_dst; 
   const void* m_src; 
   size_t m_size;
   hipMemcpyKind m_kind;
-  std::future<hipError_t> m_handle;
 };
 
 // copy command for copying data from a source only host buffer of type std::vector<uint8|uint16|uint32>
 template<class T>
-class copy_from_host_buffer_command : public command
+class copy_from_host_buffer_command : public command, private copy_engine::job
 {
 public:
   copy_from_host_buffer_command(std::shared_ptr<stream> s, std::shared_ptr<memory> buf, std::vector<T>&& vec, size_t size, size_t offset)
@@ -158,27 +188,45 @@ public:
   {
   }
 
+  ~copy_from_host_buffer_command() override
+  {
+    if (get_state() == state::running)
+      job::wait();
+  }
+
   bool
   submit() override
   {
-    handle = std::async(std::launch::async, &memory::write, buffer, host_vec.data(), copy_size, 0, dev_offset);
+    if (get_state() != state::init)
+      return get_state() == state::running;
+
+    set_state(state::running);
+    cstream->post_copy(*this, copy_size);
     return true;
   }
 
   bool
   wait() override
   {
-    handle.wait();
-    set_state(state::completed);
+    if (get_state() != state::running)
+      return get_state() == state::completed;
+
+    set_state(job::wait() ? state::completed : state::error);
     return true;
   }
 
+protected:
+  void
+  copy_chunk(size_t offset, size_t size) override
+  {
+    buffer->write(host_vec.data(), size, offset, dev_offset + offset);
+  }
+
 private:
   std::shared_ptr<memory> buffer; // device buffer
   std::vector<T> host_vec; // host buffer (source only, not valid as destination)
   size_t copy_size;
   size_t dev_offset; // offset for device memory
-  std::future<void> handle;
 };
 
 class memory_pool_command : public command
@@ -206,6 +254,20 @@ private:
   std::future<void> m_handle;
 };
 
+// launch command for hipGraphLaunch
+class graph_launch : public command
+{
+public:
+  graph_launch(std::shared_ptr<stream> s, std::shared_ptr<graph_exec> exec)
+    : command(command::type::graph_launch, std::move(s)), m_exec(std::move(exec))
+  {}
+  bool submit() override;
+  bool wait() override;
+
+private:
+  std::shared_ptr<graph_exec> m_exec;
+};
+
 // Global map of commands
 extern xrt_core::handle_map<command_handle, std::shared_ptr<command>> command_cache;
 
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "graph.h"
+#include "event.h"
+#include "module.h"
+#include "stream.h"
+#include "core/common/api/kernel_int.h"
+
+namespace xrt::core::hip {
+
+void
+graph::
+capture(const command& cmd)
+{
+  if (auto ks = dynamic_cast<const kernel_start*>(&cmd)) {
+    m_nodes.emplace_back(kernel_node{ks->get_run(), ks->get_function()->get_module()->get_hw_context(), ks->get_host_mems()});
+    return;
+  }
+
+  if (auto mc = dynamic_cast<const memcpy_command*>(&cmd)) {
+    m_nodes.emplace_back(memcpy_node{mc->get_dst(), mc->get_src(), mc->get_size(), mc->get_kind()});
+    return;
+  }
+
+  throw xrt_core::system_error(hipErrorStreamCaptureUnsupported, "operation not supported in stream capture");
+}
+
+graph_exec::
+graph_exec(const graph& g)
+{
+  for (const auto& node : g.get_nodes()) {
+    if (auto kn = std::get_if<graph::kernel_node>(&node)) {
+      auto rs = m_steps.empty() ? nullptr : std::get_if<runlist_step>(&m_steps.back());
+      if (!rs || rs->hwctx.get_handle() != kn->hwctx.get_handle())
+        rs = &std::get<runlist_step>(m_steps.emplace_back(runlist_step{kn->hwctx, xrt::runlist{kn->hwctx}, {}}));
+
+      // A run object can be part of one runlist only, every instantiation
+      // gets its own copy of the captured run
+      rs->runlist.add(xrt_core::kernel_int::clone(kn->run));
+      rs->host_mems.insert(rs->host_mems.end(), kn->host_mems.begin(), kn->host_mems.end());
+      continue;
+    }
+
+    m_steps.emplace_back(std::get<graph::memcpy_node>(node));
+  }
+}
+
+graph_exec::
+~graph_exec()
+{
+  std::lock_guard lk(m_mutex);
+  wait_launch();
+}
+
+static void
+start_runlist(xrt::runlist& runlist, const std::vector<std::shared_ptr<memory>>& host_mems)
+{
+  // NPU device is not coherent, host memory may have changed since capture
+  for (const auto& mem : host_mems)
+    mem->sync(xclBOSyncDirection::XCL_BO_SYNC_BO_TO_DEVICE);
+  runlist.execute();
+}
+
+void
+graph_exec::
+copy_chunk(size_t, size_t)
+{
+  for (auto& s : m_steps) {
+    if (auto rs = std::get_if<runlist_step>(&s)) {
+      start_runlist(rs->runlist, rs->host_mems);
+      rs->runlist.wait();
+      continue;
+    }
+
+    const auto& mc = std::get<graph::memcpy_node>(s);
+    auto err = hipMemcpy(mc.dst, mc.src, mc.size, mc.kind);
+    throw_if(err != hipSuccess, err, "graph memory copy failed");
+  }
+}
+
+void
+graph_exec::
+wait_launch()
+{
+  auto launched = m_launched;
+  m_launched = launch_type::none;
+  switch (launched) {
+  case launch_type::direct:
+    try {
+      std::get<runlist_step>(m_steps.front()).runlist.wait();
+    }
+    catch (...) {
+      m_error = std::current_exception();
+    }
+    break;
+  case launch_type::engine:
+    if (!job::wait())
+      m_error = error();
+    break;
+  case launch_type::none:
+    break;
+  }
+}
+
+void
+graph_exec::
+launch(stream& s)
+{
+  std::lock_guard lk(m_mutex);
+  wait_launch();
+
+  // report failure of previous launch not yet reported by wait()
+  if (auto error = std::exchange(m_error, nullptr))
+    std::rethrow_exception(error);
+
+  if (m_steps.empty())
+    return;
+
+  if (m_steps.size() == 1) {
+    if (auto rs = std::get_if<runlist_step>(&m_steps.front())) {
+      start_runlist(rs->runlist, rs->host_mems);
+      m_launched = launch_type::direct;
+      return;
+    }
+  }
+
+  s.post_copy(*this, 0);
+  m_launched = launch_type::engine;
+}
+
+bool
+graph_exec::
+wait()
+{
+  std::lock_guard lk(m_mutex);
+  wait_launch();
+
+  auto error = std::exchange(m_error, nullptr);
+  if (!error)
+    return true;
+
+  try {
+    std::rethrow_exception(error);
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(std::string("graph launch failed - ") + ex.what());
+  }
+  catch (...) {
+  }
+  return false;
+}
+
+// Global map of graphs
+xrt_core::handle_map<graph_handle, std::shared_ptr<graph>> graph_cache;
+
+// Global map of executable graphs
+xrt_core::handle_map<graph_exec_handle, std::shared_ptr<graph_exec>> graph_exec_cache;
+
+} // xrt::core::hip
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrthip_graph_h
+#define xrthip_graph_h
+
+#include "common.h"
+#include "copy_engine.h"
+#include "memory.h"
+#include "experimental/xrt_kernel.h"
+#include "xrt/xrt_hw_context.h"
+#include "xrt/xrt_kernel.h"
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <variant>
+#include <vector>
+
+namespace xrt::core::hip {
+
+// graph_handle - opaque graph handle
+using graph_handle = void*;
+
+// graph_exec_handle - opaque executable graph handle
+using graph_exec_handle = void*;
+
+// forward declarations
+class command;
+class stream;
+
+// class graph - operations captured from a stream
+//
+// Kernel launches and memory copies enqueued to a stream between
+// hipStreamBeginCapture and hipStreamEndCapture are recorded as nodes
+// instead of being executed.  The nodes form a single chain in the
+// order they were captured.
+class graph
+{
+public:
+  struct kernel_node
+  {
+    xrt::run run;                                   // arguments as captured
+    xrt::hw_context hwctx;
+    std::vector<std::shared_ptr<memory>> host_mems; // synced to device before start
+  };
+
+  struct memcpy_node
+  {
+    void* dst;
+    const void* src;
+    size_t size;
+    hipMemcpyKind kind;
+  };
+
+  using node = std::variant<kernel_node, memcpy_node>;
+
+  // capture() - Record an enqueued command as a node of this graph
+  //
+  // Throws hipErrorStreamCaptureUnsupported for commands other than
+  // kernel launches and memory copies
+  void
+  capture(const command& cmd);
+
+  const std::vector<node>&
+  get_nodes() const
+  {
+    return m_nodes;
+  }
+
+private:
+  std::vector<node> m_nodes;
+};
+
+// class graph_exec - executable graph instantiated from a graph
+//
+// Consecutive kernel nodes of the same hardware context are lowered
+// into one xrt::runlist of cloned run objects, such that all kernels
+// are submitted with one call per launch.  Memory copy nodes become
+// copy steps executed in order between runlists.  A graph that lowers
+// to a single runlist is submitted directly by launch(), otherwise
+// the steps are executed as one job by the copy engine of the device
+// of the launching stream.
+class graph_exec : private copy_engine::job
+{
+  struct runlist_step
+  {
+    xrt::hw_context hwctx;
+    xrt::runlist runlist;
+    std::vector<std::shared_ptr<memory>> host_mems;
+  };
+
+  using step = std::variant<runlist_step, graph::memcpy_node>;
+
+  enum class launch_type { none, direct, engine };
+
+  std::vector<step> m_steps;
+  std::mutex m_mutex;
+  launch_type m_launched = launch_type::none;
+  std::exception_ptr m_error; // failed launch not yet reported
+
+  // Wait for outstanding launch and record its failure, m_mutex held
+  void
+  wait_launch();
+
+  // Execute all steps in order, called by copy engine
+  void
+  copy_chunk(size_t offset, size_t size) override;
+
+public:
+  explicit
+  graph_exec(const graph& g);
+
+  ~graph_exec() override;
+
+  // launch() - Start execution of the graph
+  //
+  // Waits for a previous launch of this graph to complete.  Throws
+  // the error of a previous launch that failed and was not reported
+  // by wait(), in which case the graph is not launched.
+  void
+  launch(stream& s);
+
+  // wait() - Wait for the last launch to complete
+  //
+  // Return false if the last launch, or a previous launch that was
+  // not yet reported, failed
+  bool
+  wait();
+};
+
+// Global map of graphs
+extern xrt_core::handle_map<graph_handle, std::shared_ptr<graph>> graph_cache;
+
+// Global map of executable graphs
+extern xrt_core::handle_map<graph_exec_handle, std::shared_ptr<graph_exec>> graph_exec_cache;
+
+} // xrt::core::hip
+
+#endif
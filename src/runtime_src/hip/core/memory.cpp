@@ -103,7 +103,9 @@ namespace xrt::core::hip
     auto src_ptr = reinterpret_cast<const unsigned char*>(src);
     src_ptr += src_offset;
     m_bo.write(src_ptr, size, offset);
-    m_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    // sync only the written range, chunks of an asynchronous copy
+    // write disjoint ranges of the same buffer
+    m_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, size, offset);
   }
 
   void
@@ -117,7 +119,7 @@ namespace xrt::core::hip
     auto dst_ptr = reinterpret_cast<unsigned char *>(dst);
     dst_ptr += dst_offset;
     if (m_bo) {
-      m_bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+      m_bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE, size, offset);
       m_bo.read(dst_ptr, size, offset);
     }
   }
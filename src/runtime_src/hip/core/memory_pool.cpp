@@ -1,12 +1,17 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
 
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
 #include "core/common/unistd.h"
 #include "hip/config.h"
 #include "hip/hip_runtime_api.h"
 
 #include "common.h"
 #include "memory_pool.h"
+#include "stream.h"
+
+#include <algorithm>
 
 namespace xrt::core::hip
 {
@@ -17,87 +22,15 @@ namespace xrt::core::hip
   // Global map of memory_pool associated with its handle.
   xrt_core::handle_map<mem_pool_handle, std::shared_ptr<memory_pool>> mem_pool_cache;
 
-  static void
-  dlinkedlist_delete(std::shared_ptr<memory_pool_slot>& head, std::shared_ptr<memory_pool_slot>& node)
-  {
-    if (node->m_prev == nullptr) {
-      head = node->m_next;
-      if (node->m_next != nullptr)
-        node->m_next->m_prev = nullptr;
-    } 
-    else {
-      node->m_prev->m_next = node->m_next;
-      if (node->m_next!= nullptr)
-        node->m_next->m_prev = node->m_prev;
-    }
-  }
-
-  static void
-  dlinkedlist_insert(std::shared_ptr<memory_pool_slot>& head, std::shared_ptr<memory_pool_slot>& node)
-  {    
-    node->m_prev = nullptr;
-    node->m_next = head;
-    if (head != nullptr)
-      head->m_prev = node;
-    head = node;
-  }
-
-  memory_pool_slot::memory_pool_slot(size_t start, size_t size)
-      : m_start(start), m_size(size), m_prev(nullptr), m_next(nullptr), m_is_free(true)
-  {
-  }
-
-  memory_pool_node::memory_pool_node(device* device, size_t size, int id)
-      : m_id(id), m_used(0), m_free_list(nullptr), m_alloc_list(nullptr)
-  {
-    m_memory = std::make_shared<memory>(device, size);
-    m_free_list = std::make_shared<memory_pool_slot>(0, size);
-  }
-
-  // merge adjacent free slots as one slot
-  void
-  memory_pool_node::merge_free_slots(std::shared_ptr<memory_pool_slot> new_free_slot)
-  {
-    std::shared_ptr<memory_pool_slot> p0 = new_free_slot;
-    std::shared_ptr<memory_pool_slot> p1 = new_free_slot;
-
-    while (p0 && p0->is_free()) {
-      p1 = p0;
-      if (p0->start() == 0)
-        break;
-      p0 = p0->prev();
-    }
-
-    p0 = p1->next();
-    while (p0 && p0->start() < m_memory->get_size() && p0->is_free()) {
-      dlinkedlist_delete(m_free_list, p0);
-      p1->set_size(p1->get_size() + p0->get_size());
-      p0 = p0->next();
-    }
-  }
-
-  size_t
-  memory_pool_node::free(size_t start)
+  static size_t
+  to_pages(size_t size)
   {
-    size_t size_freed = 0;
-    auto used_slot = m_alloc_list;
-    while (used_slot) {
-      if (used_slot->m_start == start ) {
-        size_freed = used_slot->get_size();
-        m_used -= size_freed;
-        dlinkedlist_delete(m_alloc_list, used_slot);
-        dlinkedlist_insert(m_free_list, used_slot);
-        used_slot->m_is_free = true;
-        merge_free_slots(used_slot);
-        break;
-      }
-      used_slot = used_slot->m_next;
-    }
-    return size_freed;
+    return size / xrt_core::getpagesize();
   }
 
   memory_pool::memory_pool(device* device, size_t max_total_size, size_t pool_size)
-      : m_device(device), m_last_id(0), m_auto_extend(true), m_max_total_size(max_total_size), m_pool_size(pool_size), m_list(), m_mutex(),
+      : m_device(device), m_auto_extend(true), m_max_total_size(max_total_size), m_pool_size(pool_size),
+        m_bins(MEMORY_POOL_MAX_BIN_PAGES + 1), m_cached_mem(0), m_mutex(),
         m_reuse_follow_event_dependencies(1), m_reuse_allow_opportunistic(1), m_reuse_allow_internal_dependencies(1),
         m_release_threshold(0), m_reserved_mem_current(0), m_reserved_mem_high(0), m_used_mem_current(0), m_used_mem_high(0)
   {
@@ -109,20 +42,19 @@ namespace xrt::core::hip
   {
     std::lock_guard lock(m_mutex);
 
-    m_reserved_mem_current = m_pool_size;
-
     if (m_pool_size > m_max_total_size)
       throw std::runtime_error("mem poolsize is too big.");
     else if (m_pool_size == m_max_total_size)
       m_auto_extend = false;
 
-    m_list.emplace(m_list.end(), std::make_shared<memory_pool_node>(m_device, m_pool_size, m_last_id++));
+    if (m_blocks.empty())
+      extend_memory_pool();
   }
 
   void
   memory_pool::get_attribute(hipMemPoolAttr attr, void* value)
   {
-    if (m_list.size() == 0)
+    if (m_blocks.empty())
       init();
 
     switch (attr)
@@ -164,7 +96,7 @@ namespace xrt::core::hip
   void
   memory_pool::set_attribute(hipMemPoolAttr attr, void* value)
   {
-    if (m_list.size() == 0) {
+    if (m_blocks.empty()) {
       init();
     }
 
@@ -204,37 +136,171 @@ namespace xrt::core::hip
     };
   }
 
+  // add one block to the memory pool
   bool
-  memory_pool::extend_memory_list(size_t size)
+  memory_pool::extend_memory_pool()
   {
-    m_list.insert(m_list.begin(), std::make_shared<memory_pool_node>(m_device, size, m_last_id++));
+    if (m_reserved_mem_current >= m_max_total_size)
+      return false;
+
+    size_t add_mem_sz = std::min<size_t>(m_pool_size, m_max_total_size - m_reserved_mem_current);
+    auto& blk = m_blocks.emplace_back();
+    blk.mem = std::make_shared<memory>(m_device, add_mem_sz);
+    blk.size = add_mem_sz;
+    release_free({&blk, 0, add_mem_sz});
+
+    m_reserved_mem_current += add_mem_sz;
+    m_reserved_mem_high = std::max(m_reserved_mem_high, m_reserved_mem_current);
     return true;
   }
 
-  // add one block to the memory pool
   bool
-  memory_pool::extend_memory_pool(size_t aligned_size)
+  memory_pool::take_free(size_t size, span& sp)
   {
-    if (m_pool_size + aligned_size > m_max_total_size)
+    auto itr = m_free_by_size.lower_bound({size, nullptr, 0});
+    if (itr == m_free_by_size.end())
       return false;
 
-    size_t add_mem_sz = m_max_total_size - m_pool_size;
-    add_mem_sz = add_mem_sz >= m_pool_size ? m_pool_size : add_mem_sz;
+    auto [free_size, blk, offset] = *itr;
+    m_free_by_size.erase(itr);
+    blk->free_spans.erase(offset);
 
-    // add additional block
-    if (!extend_memory_list(add_mem_sz))
+    // the remainder is bounded by the allocation and the next used
+    // span, so it needs no coalescing
+    if (free_size > size) {
+      blk->free_spans.emplace(offset + size, free_size - size);
+      m_free_by_size.emplace(free_size - size, blk, offset + size);
+    }
+
+    sp = {blk, offset, size};
+    return true;
+  }
+
+  bool
+  memory_pool::take_cached(size_t size, const stream* s, span& sp)
+  {
+    // spans freed in the allocating stream are safe to reuse in stream order
+    if (s) {
+      if (auto sitr = m_stream_cache.find(s); sitr != m_stream_cache.end()) {
+        if (auto citr = sitr->second.find(size); citr != sitr->second.end() && !citr->second.empty()) {
+          sp = citr->second.back();
+          citr->second.pop_back();
+          m_cached_mem -= size;
+          return true;
+        }
+      }
+    }
+
+    auto pages = to_pages(size);
+    if (pages >= m_bins.size() || m_bins[pages].empty())
       return false;
 
-    m_reserved_mem_current += add_mem_sz;
-    m_reserved_mem_high = m_reserved_mem_current;
+    sp = m_bins[pages].back();
+    m_bins[pages].pop_back();
+    m_cached_mem -= size;
     return true;
   }
 
-  // create allocation from a free slot in the memory pool
   void
-  memory_pool::malloc(void* ptr, size_t size)
+  memory_pool::release_free(const span& sp)
   {
-    if (m_list.size() == 0)
+    auto blk = sp.blk;
+    auto offset = sp.offset;
+    auto size = sp.size;
+    auto& spans = blk->free_spans;
+
+    // merge with following free span
+    auto next = spans.lower_bound(offset);
+    if (next != spans.end() && offset + size == next->first) {
+      m_free_by_size.erase({next->second, blk, next->first});
+      size += next->second;
+      next = spans.erase(next);
+    }
+
+    // merge with preceding free span
+    if (next != spans.begin()) {
+      auto prev = std::prev(next);
+      if (prev->first + prev->second == offset) {
+        m_free_by_size.erase({prev->second, blk, prev->first});
+        offset = prev->first;
+        size += prev->second;
+        spans.erase(prev);
+      }
+    }
+
+    spans.emplace(offset, size);
+    m_free_by_size.emplace(size, blk, offset);
+  }
+
+  void
+  memory_pool::recycle(const span& sp)
+  {
+    auto pages = to_pages(sp.size);
+    if (pages < m_bins.size()) {
+      m_bins[pages].push_back(sp);
+      m_cached_mem += sp.size;
+      return;
+    }
+
+    release_free(sp);
+  }
+
+  void
+  memory_pool::flush_bins()
+  {
+    for (auto& bin : m_bins) {
+      for (const auto& sp : bin) {
+        m_cached_mem -= sp.size;
+        release_free(sp);
+      }
+      bin.clear();
+    }
+  }
+
+  // The spans of stream s are reusable in stream order, the spans of
+  // other streams only after their commands have completed.  Streams
+  // that cannot be waited on without blocking on their command lock,
+  // which may be held by the caller that submitted this allocation,
+  // keep their spans.  Destroyed streams were drained before removal.
+  void
+  memory_pool::reclaim_streams(std::unique_lock<std::mutex>& lock, const stream* s)
+  {
+    auto caches = std::move(m_stream_cache);
+    m_stream_cache.clear();
+
+    lock.unlock();
+    std::vector<const stream*> busy;
+    for (const auto& [cs, cache] : caches) {
+      if (cs == s)
+        continue;
+      auto hip_stream = stream_cache.get(const_cast<stream*>(cs)); // NOLINT
+      if (hip_stream && !hip_stream->try_await_completion())
+        busy.push_back(cs);
+    }
+    lock.lock();
+
+    for (auto& [cs, cache] : caches) {
+      if (std::find(busy.begin(), busy.end(), cs) != busy.end()) {
+        auto& scache = m_stream_cache[cs];
+        for (auto& [size, spans] : cache)
+          scache[size].insert(scache[size].end(), spans.begin(), spans.end());
+        continue;
+      }
+
+      for (auto& [size, spans] : cache) {
+        for (const auto& sp : spans) {
+          m_cached_mem -= sp.size;
+          release_free(sp);
+        }
+      }
+    }
+  }
+
+  // create allocation from free space in the memory pool
+  void
+  memory_pool::malloc(void* ptr, size_t size, const stream* s)
+  {
+    if (m_blocks.empty())
       init();
 
     assert(ptr);
@@ -247,138 +313,106 @@ namespace xrt::core::hip
     // every allocation from pool has page size alignment
     size_t aligned_size = get_page_aligned_size(size);
 
-    std::lock_guard lock(m_mutex);
+    std::unique_lock lock(m_mutex);
 
     if (aligned_size > m_pool_size)
       throw std::runtime_error("requested size is greater than memory pool block size.");
 
-    std::shared_ptr<memory_pool_node> mm;
-
-    uint32_t num_tries = 0;
-    // find first free slot that fits, if none is found, enlarge the pool and try one more time
-    while (num_tries <= 2) {
-      ++ num_tries;
-      auto mp_itr = m_list.begin();
-      while (mp_itr != m_list.end()){
-        mm = *mp_itr;
-        // skip blocks with too liitle memory left to fit the required aligned_size
-        if (m_pool_size - mm->m_used < aligned_size) {
-          mp_itr++;
+    span sp {};
+    if (!take_cached(aligned_size, s, sp) && !take_free(aligned_size, sp)) {
+      // coalesce binned spans, if still no fit enlarge the pool, if the
+      // pool is at its limit coalesce spans freed in stream order
+      flush_bins();
+      bool reclaimed = false;
+      while (!take_free(aligned_size, sp)) {
+        if (m_auto_extend && extend_memory_pool())
           continue;
-        }
-
-        auto free_slot = mm->m_free_list;
-        auto alloc_slot = free_slot;
-
-        // find the free slot large enough from the free list (m_free_list), mark it as "not free"
-        // and move it to m_alloc_list
-        while (free_slot != nullptr) {
-          if (free_slot->m_size >= aligned_size) {
-            // found a slot that is large enough
-            if (free_slot->m_size > aligned_size) {
-              // if the slot found is large than require aligned_size, divide it into two slots:
-              // use the first one (alloc_slot) for the current requested allocation
-              // save the other one (free_slot) for future use
-              alloc_slot = free_slot;
-              free_slot = std::make_shared<memory_pool_slot>(alloc_slot->start() + aligned_size, alloc_slot->m_size - aligned_size);
-
-              // update m_free_list,remove alloc_slot from double linked m_free_list
-              if (free_slot->m_prev == nullptr) {
-                mm->m_free_list = free_slot;
-              }
-              else {
-                free_slot->m_prev->m_next = free_slot;
-              }
-              if (free_slot->m_next) {
-                free_slot->m_next->m_prev = free_slot;
-              }
-
-              alloc_slot->m_is_free = false;
-              alloc_slot->m_size = aligned_size;
-            }
-            else {
-              // if the free slot found has exactly the same size as required aligned_size
-              // there is no need to divide the slot, just remove the slot from m_free_list
-              alloc_slot = free_slot;
-              dlinkedlist_delete(mm->m_free_list, alloc_slot);
-              alloc_slot->m_is_free = false;
-            }
-
-            // move the newly found slot to m_alloc_list
-            dlinkedlist_insert(mm->m_alloc_list, alloc_slot);
-
-            // keep track of the total allocated size
-            mm->m_used += alloc_slot->m_size;
-            m_used_mem_current += alloc_slot->m_size;
-            m_used_mem_high = m_used_mem_current;
-
-            // init the sub_mem with bo/offset fro the newly found slot
-            sub_mem->init(mm->m_memory, size, alloc_slot->m_start);
-            memory_database::instance().insert(reinterpret_cast<uint64_t>(ptr),
-                                                            sub_mem->get_size(), sub_mem);
-            return;
-          }
-          free_slot = free_slot->m_next;
-        }
-
-        mp_itr++;
-        mm = *mp_itr;
+        throw_if(reclaimed || m_stream_cache.empty(), hipErrorOutOfMemory, "memory pool is out of memory");
+        reclaim_streams(lock, s);
+        reclaimed = true;
       }
-      
-      // we have already tried enlarging the pool and still no free slot is found
-      if (num_tries == 2)
-        break;
-      
-      if (m_auto_extend) {
-        // no free slot has been found, add one additional block to the pool and try one more time
-        if (extend_memory_pool(aligned_size) == false) {
-          // enlarging pool failed
-          break;
-        }
-      }
-    };
+    }
+
+    sp.blk->used += sp.size;
+    m_used_mem_current += sp.size;
+    m_used_mem_high = std::max(m_used_mem_high, m_used_mem_current);
+    m_allocs.emplace(ptr, sp);
 
-    // allocation failed
-    return;
+    // init the sub_mem with bo/offset from the newly found span
+    sub_mem->init(sp.blk->mem, size, sp.offset);
+    memory_database::instance().insert(reinterpret_cast<uint64_t>(ptr), sub_mem->get_size(), sub_mem);
   }
 
-  // lookup the memory pool node from address (ptr)
-  std::shared_ptr<memory_pool_node>
-  memory_pool::find_memory_pool_node(void* ptr, uint64_t &start)
+  // free a previous allocation
+  void
+  memory_pool::free(void* ptr, const stream* s)
   {
-    auto mem_info = memory_database::instance().get_hip_mem_from_addr(ptr);
-    auto hip_mem = mem_info.first;
-    size_t offset = mem_info.second;
-
-    for (auto & node : m_list) {
-      if (hip_mem == node->m_memory) {
-        start = offset;
-        return node;
+    if (!ptr)
+      return;
+
+    std::lock_guard lock(m_mutex);
+
+    if (auto itr = m_allocs.find(ptr); itr != m_allocs.end()) {
+      auto sp = itr->second;
+      m_allocs.erase(itr);
+      sp.blk->used -= sp.size;
+      m_used_mem_current -= sp.size;
+
+      if (s) {
+        m_stream_cache[s][sp.size].push_back(sp);
+        m_cached_mem += sp.size;
       }
+      else
+        recycle(sp);
     }
 
-    return nullptr;
+    memory_database::instance().remove(reinterpret_cast<uint64_t>(ptr));
   }
 
-  // free a previous allocation
-  void
-  memory_pool::free(void* ptr)
+  bool
+  memory_pool::owns(void* ptr)
   {
-    if (!ptr || m_list.size() == 0)
-      return;
+    std::lock_guard lock(m_mutex);
+    return m_allocs.count(ptr) > 0;
+  }
 
+  void
+  memory_pool::release_stream(const stream* s)
+  {
     std::lock_guard lock(m_mutex);
 
-    uint64_t start = 0;
-    auto mm = find_memory_pool_node(reinterpret_cast<void*>(ptr), start);
-    if (mm != nullptr)
-    {
-      // return the slot to free_list and merge it with ajacent free slot
-      auto size_freed = mm->free(start);
-      m_used_mem_current -= size_freed;
+    auto sitr = m_stream_cache.find(s);
+    if (sitr == m_stream_cache.end())
+      return;
+
+    for (auto& [size, spans] : sitr->second) {
+      for (const auto& sp : spans) {
+        m_cached_mem -= sp.size;
+        recycle(sp);
+      }
     }
+    m_stream_cache.erase(sitr);
+  }
 
-    memory_database::instance().remove(reinterpret_cast<uint64_t>(ptr));
+  memory_pool::stats
+  memory_pool::get_stats()
+  {
+    std::lock_guard lock(m_mutex);
+
+    stats st {};
+    st.reserved = m_reserved_mem_current;
+    st.reserved_high = m_reserved_mem_high;
+    st.used = m_used_mem_current;
+    st.used_high = m_used_mem_high;
+    st.cached = m_cached_mem;
+    st.free_spans = m_free_by_size.size();
+    st.allocations = m_allocs.size();
+    for (const auto& [size, blk, offset] : m_free_by_size)
+      st.free += size;
+    if (!m_free_by_size.empty())
+      st.largest_free = std::get<0>(*m_free_by_size.rbegin());
+    st.fragmentation = st.free ? 1.0 - static_cast<double>(st.largest_free) / static_cast<double>(st.free) : 0.0;
+    return st;
   }
 
   // trim memory pool by releasing unused blocks back to system until
@@ -389,24 +423,35 @@ namespace xrt::core::hip
     if (m_reserved_mem_current < min_bytes_to_hold)
       return;
 
-    std::lock_guard lock(m_mutex);
+    {
+      std::lock_guard lock(m_mutex);
 
-    bool node_deleted = false;
-    do {
-      node_deleted = false;
-      auto itr = m_list.begin();
-      while (itr != m_list.end()) {
-        // delete pool block if it is free
-        auto node = *itr;
-        if (node->m_alloc_list == nullptr) {
-          m_reserved_mem_current -= node->get_size();
-          m_list.remove(node);
-          node_deleted = true;
-          break;
+      // binned spans must be coalesced for blocks to appear unused
+      flush_bins();
+
+      for (auto itr = m_blocks.begin(); itr != m_blocks.end() && m_reserved_mem_current >= min_bytes_to_hold;) {
+        // delete pool block if it is one free span
+        auto& blk = *itr;
+        if (blk.used || blk.free_spans.size() != 1 || blk.free_spans.begin()->second != blk.size) {
+          ++itr;
+          continue;
         }
-        ++ itr;
-      };
-    } while (node_deleted && m_reserved_mem_current >= min_bytes_to_hold);
+
+        m_free_by_size.erase({blk.size, &blk, 0});
+        m_reserved_mem_current -= blk.size;
+        itr = m_blocks.erase(itr);
+      }
+    }
+
+    if (xrt_core::config::get_verbosity() >= static_cast<unsigned int>(xrt_core::message::severity_level::debug)) {
+      auto st = get_stats();
+      xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT",
+        "memory pool: reserved " + std::to_string(st.reserved) + " (high " + std::to_string(st.reserved_high) +
+        "), used " + std::to_string(st.used) + " (high " + std::to_string(st.used_high) +
+        "), free " + std::to_string(st.free) + " in " + std::to_string(st.free_spans) +
+        " spans, cached " + std::to_string(st.cached) +
+        ", fragmentation " + std::to_string(st.fragmentation));
+    }
   }
 
   // trim memory pool by releasing unused blocks back to system until
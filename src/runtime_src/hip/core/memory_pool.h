@@ -7,6 +7,10 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/device.h"
 #include "experimental/xrt_bo.h"
@@ -24,81 +28,49 @@ namespace xrt::core::hip
   const size_t MEMORY_POOL_BLOCK_SIZE_NPU = (static_cast<size_t>(1) << 30); // 1GB
   const size_t MAX_MEMORY_POOL_SIZE_NPU = 4*(static_cast<size_t>(1) << 30); // 4GB
 
+  // Freed allocations up to this many pages are kept in exact size
+  // bins for O(1) reuse instead of being coalesced immediately
+  const size_t MEMORY_POOL_MAX_BIN_PAGES = 64;
+
   // opaque memory pool handle
   using mem_pool_handle = void*;
 
-  class memory_pool_slot
-  {
-  public:
-    memory_pool_slot(size_t start, size_t size);
-
-    size_t start() { return m_start; }
-    size_t end() { return m_start + m_size; }
-    
-    bool
-    is_free()
-    {
-      return m_is_free;
-    }
-
-    std::shared_ptr<memory_pool_slot>
-    prev()
-    {
-      return m_prev;
-    }
-
-    std::shared_ptr<memory_pool_slot>
-    next()
-    {
-      return m_next;
-    }
-
-    size_t
-    get_size() const
-    {
-      return m_size;
-    }
-
-    void
-    set_size(size_t size)
-    {
-      m_size = size;
-    }
-
-    size_t m_start;
-    size_t m_size;
-    std::shared_ptr<memory_pool_slot> m_prev;
-    std::shared_ptr<memory_pool_slot> m_next;
-    bool m_is_free;
-  };
-
-  class memory_pool_node
-  {
-  public:
-    memory_pool_node(device* device, size_t size, int id);
-
-    size_t
-    get_size() const
-    {
-      return m_memory->get_size();
-    }
-
-    size_t
-    free(size_t start);
-
-    void
-    merge_free_slots(std::shared_ptr<memory_pool_slot> new_free_slot);
-
-    int m_id;
-    size_t m_used;    
-    std::shared_ptr<memory> m_memory;
-    std::shared_ptr<memory_pool_slot> m_free_list;
-    std::shared_ptr<memory_pool_slot> m_alloc_list;
-  };
-
+  // forward declaration
+  class stream;
+
+  // class memory_pool - stream ordered sub-allocator of device memory
+  //
+  // The pool reserves device memory in blocks and sub-allocates page
+  // aligned spans from the blocks.  Free space of each block is kept
+  // coalesced by offset, and indexed by size across blocks for best
+  // fit allocation in O(log n).  Small freed spans are kept in bins by
+  // size and are coalesced only when the pool runs out of space or is
+  // trimmed.
+  //
+  // A span freed in stream order (hipFreeAsync) may be reused right
+  // away by allocations in the same stream, but becomes available to
+  // other streams only after the freeing stream is synchronized or
+  // destroyed, after hipDeviceSynchronize, or when the pool is out of
+  // memory and the freeing stream has been waited on.
   class memory_pool
   {
   public:
+    // struct stats - allocator statistics
+    //
+    // @fragmentation: 1 - largest free span / total free space
+    struct stats
+    {
+      uint64_t reserved;         // backing memory of all blocks
+      uint64_t reserved_high;
+      uint64_t used;             // allocated by application
+      uint64_t used_high;
+      uint64_t free;             // coalesced free space
+      uint64_t largest_free;
+      uint64_t cached;           // in bins and stream caches
+      size_t free_spans;
+      size_t allocations;
+      double fragmentation;
+    };
 
     memory_pool(device* device, size_t max_total_size, size_t pool_size);
 
@@ -112,11 +84,31 @@ namespace xrt::core::hip
     void
     trim_to(size_t min_bytes_to_hold);
 
+    // malloc() - Allocate into the sub memory identified by ptr
+    //
+    // The allocation is ordered in stream s if not null.  Throws
+    // hipErrorOutOfMemory if the pool cannot fit the allocation.
     void
-    malloc(void* ptr, size_t size);
-    
+    malloc(void* ptr, size_t size, const stream* s = nullptr);
+
+    // free() - Free a previous allocation
+    //
+    // The free is ordered in stream s if not null.
     void
-    free(void* ptr);
+    free(void* ptr, const stream* s = nullptr);
+
+    // owns() - Check if ptr is allocated from this pool
+    bool
+    owns(void* ptr);
+
+    // release_stream() - Make spans freed in stream order available
+    //
+    // Called when all work of the stream has completed
+    void
+    release_stream(const stream* s);
+
+    stats
+    get_stats();
 
     void
     get_attribute(hipMemPoolAttr attr, void* value);
@@ -131,23 +123,60 @@ namespace xrt::core::hip
     }
 
   protected:
-    
-    bool
-    extend_memory_list(size_t size);
+    struct block
+    {
+      std::shared_ptr<memory> mem;
+      size_t size;
+      size_t used = 0;
+      std::map<size_t, size_t> free_spans; // offset -> size, coalesced
+    };
+
+    struct span
+    {
+      block* blk;
+      size_t offset;
+      size_t size;
+    };
 
     // add one block to the memory pool
     bool
-    extend_memory_pool(size_t aligned_size);
+    extend_memory_pool();
+
+    // Take best fitting span from coalesced free space
+    bool
+    take_free(size_t size, span& sp);
+
+    // Take span from size bin or stream cache
+    bool
+    take_cached(size_t size, const stream* s, span& sp);
 
-    std::shared_ptr<memory_pool_node>
-    find_memory_pool_node(void* ptr, uint64_t &start);
+    // Return span to coalesced free space
+    void
+    release_free(const span& sp);
+
+    // Return span to size bin or coalesced free space
+    void
+    recycle(const span& sp);
+
+    // Coalesce all binned spans
+    void
+    flush_bins();
+
+    // Coalesce spans freed in stream order when out of memory, lock
+    // is released while waiting for the streams
+    void
+    reclaim_streams(std::unique_lock<std::mutex>& lock, const stream* s);
 
     device* m_device;
-    int m_last_id;
     bool m_auto_extend;
     size_t m_max_total_size;
     size_t m_pool_size;
-    std::list<std::shared_ptr<memory_pool_node>> m_list;
+    std::list<block> m_blocks;
+    std::set<std::tuple<size_t, block*, size_t>> m_free_by_size; // size, block, offset
+    std::vector<std::vector<span>> m_bins;                       // index is number of pages
+    std::map<const stream*, std::map<size_t, std::vector<span>>> m_stream_cache;
+    std::unordered_map<void*, span> m_allocs;
+    uint64_t m_cached_mem; // bytes in bins and stream caches
     std::mutex m_mutex;
 
     int m_reuse_follow_event_dependencies;
@@ -6,8 +6,23 @@
 
 #include "common.h"
 #include "event.h"
+#include "graph.h"
 #include "stream.h"
 
+namespace {
+// Depth of command completion on this thread, commands completed by
+// a stream can submit commands of other streams through events
+thread_local unsigned int completing = 0; //NOLINT
+
+struct completion_scope
+{
+  completion_scope() { ++completing; }
+  ~completion_scope() { --completing; }
+  completion_scope(const completion_scope&) = delete;
+  completion_scope& operator=(const completion_scope&) = delete;
+};
+}
+
 namespace xrt::core::hip {
 stream::
 stream(std::shared_ptr<context> ctx, unsigned int flags, bool is_null)
@@ -29,6 +44,17 @@ void
 stream::
 enqueue(std::shared_ptr<command> cmd)
 {
+  // commands enqueued during capture are recorded, not executed,
+  // the capture graph is checked and updated under the command lock
+  // as capture can begin or end concurrently with enqueue
+  {
+    std::lock_guard<std::mutex> lock(m_cmd_lock);
+    if (m_capture_graph) {
+      capture(cmd);
+      return;
+    }
+  }
+
   // if there is top event add command chain list of this event
   // else submit the command
   if (m_top_event)
@@ -109,9 +135,9 @@ synchronize_streams()
 
 void
 stream::
-await_completion()
+complete_commands()
 {
-  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  completion_scope scope;
   while(!m_cmd_queue.empty()) {
     auto cmd = m_cmd_queue.front();
     cmd->wait();
@@ -123,6 +149,30 @@ await_completion()
   }
 }
 
+void
+stream::
+await_completion()
+{
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  complete_commands();
+}
+
+bool
+stream::
+try_await_completion()
+{
+  // this thread may hold the command lock of this stream
+  if (completing)
+    return false;
+
+  std::unique_lock<std::mutex> lk(m_cmd_lock, std::try_to_lock);
+  if (!lk.owns_lock())
+    return false;
+
+  complete_commands();
+  return true;
+}
+
 void
 stream::
 synchronize()
@@ -133,12 +183,15 @@ synchronize()
   // complete commands in this stream
   await_completion();
 
+  // memory freed in this stream is no longer in use by its commands and can be reused by other streams.
   // stream synchronization requires mem pools associated with its device to release all unused memory back to the system. 
   auto dev_id = get_device()->get_device_id();
   for (auto& mem_pool : memory_pool_db[dev_id])
   {
-    if (mem_pool)
+    if (mem_pool) {
+      mem_pool->release_stream(this);
       mem_pool->purge();
+    }
   }
 }
 
@@ -150,6 +203,61 @@ record_top_event(event* ev)
   m_top_event = ev;
 }
 
+void
+stream::
+capture(const std::shared_ptr<command>& cmd)
+{
+  // called with m_cmd_lock held, the graph copies what it needs from
+  // the command, which is never submitted and has no destroy call, so
+  // remove it from the cache
+  auto remove = [&cmd] {
+    if (cmd->get_type() != command::type::event)
+      command_cache.remove(cmd.get());
+  };
+
+  try {
+    m_capture_graph->capture(*cmd);
+  }
+  catch (...) {
+    remove();
+    throw;
+  }
+  remove();
+}
+
+void
+stream::
+begin_capture()
+{
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  throw_if(m_capture_graph != nullptr, hipErrorIllegalState, "stream is already capturing");
+  m_capture_graph = std::make_shared<graph>();
+}
+
+std::shared_ptr<graph>
+stream::
+end_capture()
+{
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  throw_if(m_capture_graph == nullptr, hipErrorIllegalState, "stream is not capturing");
+  return std::move(m_capture_graph);
+}
+
+bool
+stream::
+is_capturing() const
+{
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  return m_capture_graph != nullptr;
+}
+
+void
+stream::
+post_copy(copy_engine::job& job, size_t size)
+{
+  m_ctx->get_copy_engine().post(m_copy_queue, job, size);
+}
+
 std::shared_ptr<stream>
 get_stream(hipStream_t stream)
 {
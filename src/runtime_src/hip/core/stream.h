@@ -4,6 +4,7 @@
 #define xrthip_stream_h
 
 #include "context.h"
+#include "copy_engine.h"
 
 #include <list>
 
@@ -12,6 +13,7 @@ namespace xrt::core::hip {
 // forward declarations
 class event;
 class command;
+class graph;
 
 class stream
 {
@@ -20,8 +22,17 @@ class stream
   bool m_null;
 
   std::list<std::shared_ptr<command>> m_cmd_queue;
-  std::mutex m_cmd_lock;
+  mutable std::mutex m_cmd_lock;
   event* m_top_event{nullptr};
+  copy_engine::queue m_copy_queue;
+  std::shared_ptr<graph> m_capture_graph;
+
+  void
+  capture(const std::shared_ptr<command>& cmd);
+
+  // Wait for and remove all commands, m_cmd_lock held
+  void
+  complete_commands();
 
 public:
   stream() = default;
@@ -65,11 +76,32 @@ public:
   void
   await_completion();
 
+  // Wait for completion of all commands unless the stream is already
+  // being waited on or changed by a caller holding its command lock.
+  // Returns false if the stream was not waited on.
+  bool
+  try_await_completion();
+
   void
   synchronize();
 
   void
   record_top_event(event* ev);
+
+  // Start capturing enqueued commands into a new graph
+  void
+  begin_capture();
+
+  // Stop capturing and return the captured graph
+  std::shared_ptr<graph>
+  end_capture();
+
+  bool
+  is_capturing() const;
+
+  // Post an asynchronous copy of this stream to the device copy engine
+  void
+  post_copy(copy_engine::job& job, size_t size);
 };
 
 // Global map of streams
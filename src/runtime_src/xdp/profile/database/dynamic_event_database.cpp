@@ -64,6 +64,12 @@ namespace xdp {
     host->addUnsortedEvent(event);
   }
 
+  // This function is called from plugins once the ID has been issued
+  void VPDynamicDatabase::addHostRecord(const HostEventRecord& record)
+  {
+    host->addRecord(record);
+  }
+
   // Lookup the device database corresponding with the device ID.  If
   // the device database does not yet exist, create it here.
   DeviceDB* VPDynamicDatabase::getDeviceDB(uint64_t deviceId)
@@ -200,6 +206,13 @@ namespace xdp {
     return device_db->moveEvents();
   }
 
+  std::vector<std::unique_ptr<VTFEvent>>
+  VPDynamicDatabase::moveDeviceEventsBefore(uint64_t deviceId, double timestamp)
+  {
+    auto device_db = getDeviceDB(deviceId);
+    return device_db->moveEventsBefore(timestamp);
+  }
+
   void VPDynamicDatabase::setCounterResults(const uint64_t deviceId,
                                             xrt_core::uuid uuid,
                                             xdp::CounterResults& values)
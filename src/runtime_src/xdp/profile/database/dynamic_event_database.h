@@ -94,6 +94,12 @@ namespace xdp {
     // Add an event to the database to be sorted later when we write
     XDP_CORE_EXPORT void addUnsortedEvent(VTFEvent* event);
 
+    // Issue an event id ahead of adding a compact host event record
+    inline uint64_t issueEventId() { return eventId++; }
+
+    // Add a compact native API record to be sorted later when we write
+    XDP_CORE_EXPORT void addHostRecord(const HostEventRecord& record);
+
     // For API events, find the event id of the start event for an end event
     XDP_CORE_EXPORT void markStart(uint64_t functionID, uint64_t eventID) ;
     XDP_CORE_EXPORT uint64_t matchingStart(uint64_t functionID) ;
@@ -141,6 +147,8 @@ namespace xdp {
     XDP_CORE_EXPORT std::vector<std::unique_ptr<VTFEvent>> moveSortedHostEvents(std::function<bool(VTFEvent*)> filter);
     XDP_CORE_EXPORT std::vector<VTFEvent*> moveUnsortedHostEvents(std::function<bool(VTFEvent*)> filter);
     XDP_CORE_EXPORT std::vector<std::unique_ptr<VTFEvent>> moveDeviceEvents(uint64_t deviceId);
+    // Only move the device events that happened before the timestamp
+    XDP_CORE_EXPORT std::vector<std::unique_ptr<VTFEvent>> moveDeviceEventsBefore(uint64_t deviceId, double timestamp);
 
     XDP_CORE_EXPORT bool deviceEventsExist(uint64_t deviceId);
     XDP_CORE_EXPORT bool hostEventsExist(std::function<bool(VTFEvent*)> filter);
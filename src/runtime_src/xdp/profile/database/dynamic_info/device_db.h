@@ -62,6 +62,8 @@ namespace xdp {
 
     inline std::vector<std::unique_ptr<VTFEvent>> moveEvents()
     { return pl_db.moveEvents(); }
+    inline std::vector<std::unique_ptr<VTFEvent>> moveEventsBefore(double timestamp)
+    { return pl_db.moveEventsBefore(timestamp); }
 
     inline void markStart(uint64_t monitorId, const DeviceEventInfo& info)
     {  pl_db.markStart(monitorId, info);  }
@@ -14,30 +14,104 @@
  * under the License.
  */
 
+
 #define XDP_CORE_SOURCE
 
 #include "xdp/profile/database/dynamic_info/host_db.h"
+#include "xdp/profile/database/events/native_events.h"
 #include "xdp/profile/database/events/vtf_event.h"
 #include <algorithm>
+#include <atomic>
+#include <queue>
+#include <thread>
+
+namespace {
+
+  std::atomic<uint64_t> nextInstanceId {1};
+
+  // The shard of the host database last used by this thread
+  struct ThreadShard
+  {
+    uint64_t instanceId = 0;
+    void* shard = nullptr;
+  };
+
+  thread_local ThreadShard threadShard;
+
+  bool timestampLess(const std::pair<double, xdp::VTFEvent*>& l,
+                     const std::pair<double, xdp::VTFEvent*>& r)
+  {
+    return l.first < r.first;
+  }
+
+} // end anonymous namespace
 
 namespace xdp {
 
+  HostDB::HostDB() : instanceId(nextInstanceId++)
+  {
+  }
+
   HostDB::~HostDB()
   {
-    // Delete sorted events still in the database and not moved
-    {
-      std::lock_guard<std::mutex> lock(sortedLock);
-      for (auto& iter : sortedEvents) {
-        auto event = iter.second;
+    // Delete events still in the database and not moved
+    std::lock_guard<std::mutex> lock(shardLock);
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardEventsLock(shard->lock);
+      for (auto& iter : shard->sortedEvents)
+        delete iter.second;
+      for (auto event : shard->unsortedEvents)
         delete event;
-      }
     }
-    // Delete unsorted events still in the database and not moved
-    {
-      std::lock_guard<std::mutex> lock(unsortedLock);
-      for (auto event : unsortedEvents)
-        delete event;
+  }
+
+  HostDB::EventShard* HostDB::getShard()
+  {
+    if (threadShard.instanceId == instanceId)
+      return static_cast<EventShard*>(threadShard.shard);
+
+    auto shard = std::make_unique<EventShard>();
+    threadShard.instanceId = instanceId;
+    threadShard.shard = shard.get();
+
+    std::lock_guard<std::mutex> lock(shardLock);
+    shards.push_back(std::move(shard));
+    return shards.back().get();
+  }
+
+  std::vector<VTFEvent*>
+  HostDB::mergeSorted(std::vector<std::vector<std::pair<double, VTFEvent*>>>& lists)
+  {
+    size_t total = 0;
+    for (auto& list : lists) {
+      // Events are appended in creation order which is mostly, but
+      // not necessarily, timestamp order
+      if (!std::is_sorted(list.begin(), list.end(), timestampLess))
+        std::stable_sort(list.begin(), list.end(), timestampLess);
+      total += list.size();
+    }
+
+    // K-way merge, ties are resolved by shard for a stable order
+    using cursor = std::pair<double, size_t>; // timestamp, list index
+    std::priority_queue<cursor, std::vector<cursor>, std::greater<cursor>> heads;
+    std::vector<size_t> positions(lists.size(), 0);
+    for (size_t idx = 0; idx < lists.size(); ++idx) {
+      if (!lists[idx].empty())
+        heads.emplace(lists[idx][0].first, idx);
     }
+
+    std::vector<VTFEvent*> merged;
+    merged.reserve(total);
+    while (!heads.empty()) {
+      auto idx = heads.top().second;
+      heads.pop();
+
+      auto& list = lists[idx];
+      merged.push_back(list[positions[idx]].second);
+      if (++positions[idx] < list.size())
+        heads.emplace(list[positions[idx]].first, idx);
+    }
+    return merged;
   }
 
   void HostDB::addSortedEvent(VTFEvent* event)
@@ -45,8 +119,9 @@ namespace xdp {
     if (event == nullptr)
       return;
 
-    std::lock_guard<std::mutex> lock(sortedLock);
-    sortedEvents.emplace(event->getTimestamp(), event);
+    auto shard = getShard();
+    std::lock_guard<std::mutex> lock(shard->lock);
+    shard->sortedEvents.emplace_back(event->getTimestamp(), event);
   }
 
   void HostDB::addUnsortedEvent(VTFEvent* event)
@@ -54,17 +129,33 @@ namespace xdp {
     if (event == nullptr)
       return;
 
-    std::lock_guard<std::mutex> lock(unsortedLock);
-    unsortedEvents.push_back(event);
+    auto shard = getShard();
+    std::lock_guard<std::mutex> lock(shard->lock);
+    shard->unsortedEvents.push_back(event);
+  }
+
+  void HostDB::addRecord(const HostEventRecord& record)
+  {
+    auto shard = getShard();
+    std::lock_guard<std::mutex> lock(shard->lock);
+
+    auto offset = shard->numRecords % recordChunkSize;
+    if (offset == 0 && shard->numRecords / recordChunkSize == shard->recordChunks.size())
+      shard->recordChunks.emplace_back(new HostEventRecord[recordChunkSize]);
+
+    shard->recordChunks[shard->numRecords / recordChunkSize][offset] = record;
+    ++shard->numRecords;
   }
 
   bool HostDB::sortedEventsExist(std::function<bool (VTFEvent*)>& filter)
   {
-    std::lock_guard<std::mutex> lock(sortedLock);
-    for (auto& iter : sortedEvents) {
-      auto event = iter.second;
-      if (filter(event))
-        return true;
+    std::lock_guard<std::mutex> lock(shardLock);
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardEventsLock(shard->lock);
+      for (auto& iter : shard->sortedEvents) {
+        if (filter(iter.second))
+          return true;
+      }
     }
     return false;
   }
@@ -72,26 +163,33 @@ namespace xdp {
   std::vector<VTFEvent*>
   HostDB::filterSortedEvents(std::function<bool (VTFEvent*)>& filter)
   {
-    std::lock_guard<std::mutex> lock(sortedLock);
-
-    std::vector<VTFEvent*> collected;
-    for (auto& iter : sortedEvents) {
-      auto event = iter.second;
-      if (filter(event))
-        collected.push_back(event);
+    std::vector<std::vector<std::pair<double, VTFEvent*>>> lists;
+    {
+      std::lock_guard<std::mutex> lock(shardLock);
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> shardEventsLock(shard->lock);
+        auto& list = lists.emplace_back();
+        for (auto& iter : shard->sortedEvents) {
+          if (filter(iter.second))
+            list.push_back(iter);
+        }
+      }
     }
-    return collected;
+    return mergeSorted(lists);
   }
 
   std::vector<VTFEvent*>
   HostDB::filterUnsortedEvents(std::function<bool (VTFEvent*)>& filter)
   {
-    std::lock_guard<std::mutex> lock(unsortedLock);
+    std::lock_guard<std::mutex> lock(shardLock);
 
     std::vector<VTFEvent*> collected;
-    for (auto event : unsortedEvents) {
-      if (filter(event))
-        collected.push_back(event);
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardEventsLock(shard->lock);
+      for (auto event : shard->unsortedEvents) {
+        if (filter(event))
+          collected.push_back(event);
+      }
     }
     return collected;
   }
@@ -99,39 +197,75 @@ namespace xdp {
   std::vector<std::unique_ptr<VTFEvent>>
   HostDB::moveSortedEvents(std::function<bool (VTFEvent*)>& filter)
   {
-    std::lock_guard<std::mutex> lock(sortedLock);
-
-    std::vector<std::unique_ptr<VTFEvent>> collected;
-
-    for (auto iter = sortedEvents.begin(); iter != sortedEvents.end(); ) {
-      auto event = (*iter).second;
-      if (filter(event)) {
-        collected.emplace_back(event);
-        iter = sortedEvents.erase(iter);
+    std::vector<std::vector<std::pair<double, VTFEvent*>>> lists;
+    {
+      std::lock_guard<std::mutex> lock(shardLock);
+      for (auto& shard : shards) {
+        std::lock_guard<std::mutex> shardEventsLock(shard->lock);
+        auto& list = lists.emplace_back();
+        auto& events = shard->sortedEvents;
+        auto newEnd = std::remove_if(events.begin(), events.end(), [&filter, &list](const auto& iter) {
+            if (filter(iter.second)) {
+              list.push_back(iter);
+              return true;
+            }
+            return false;
+        });
+        events.erase(newEnd, events.end());
       }
-      else
-        ++iter;
     }
+
+    std::vector<std::unique_ptr<VTFEvent>> collected;
+    for (auto event : mergeSorted(lists))
+      collected.emplace_back(event);
     return collected;
   }
 
   std::vector<VTFEvent*>
   HostDB::moveUnsortedEvents(std::function<bool (VTFEvent*)>& filter)
   {
-    std::lock_guard<std::mutex> lock(unsortedLock);
+    std::lock_guard<std::mutex> lock(shardLock);
 
     std::vector<VTFEvent*> collected;
 
-    auto newEnd = std::remove_if(unsortedEvents.begin(), unsortedEvents.end(), [&filter, &collected](VTFEvent* event) {
-        if (filter(event)) {
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> shardEventsLock(shard->lock);
+      auto& events = shard->unsortedEvents;
+
+      // Turn the native API records into events before filtering
+      events.reserve(events.size() + shard->numRecords);
+      for (size_t idx = 0; idx < shard->numRecords; ++idx) {
+        const auto& record = shard->recordChunks[idx / recordChunkSize][idx % recordChunkSize];
+        VTFEvent* event = nullptr;
+        switch (record.kind) {
+        case HostEventRecord::NATIVE_SYNC_READ:
+          event = new NativeSyncRead(record.startId, record.timestamp, record.name);
+          break;
+        case HostEventRecord::NATIVE_SYNC_WRITE:
+          event = new NativeSyncWrite(record.startId, record.timestamp, record.name);
+          break;
+        case HostEventRecord::NATIVE_API:
+        default:
+          event = new NativeAPICall(record.startId, record.timestamp, record.name);
+          break;
+        }
+        event->setEventId(record.id);
+        events.push_back(event);
+      }
+      shard->recordChunks.clear();
+      shard->numRecords = 0;
+
+      auto newEnd = std::remove_if(events.begin(), events.end(), [&filter, &collected](VTFEvent* event) {
+          if (filter(event)) {
             collected.push_back(event);
             return true;  // Mark the event for removal from unsortedEvents vector
-        }
-        return false; // Keep event in the unsortedEvents vector
-    });
+          }
+          return false; // Keep event in the unsortedEvents vector
+      });
 
-    // Resize the UnsortedEvents vector to keep only the remaining unfiltered events
-    unsortedEvents.erase(newEnd, unsortedEvents.end());
+      // Resize the unsortedEvents vector to keep only the remaining unfiltered events
+      events.erase(newEnd, events.end());
+    }
 
     return collected;
   }
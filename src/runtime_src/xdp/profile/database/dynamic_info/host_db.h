@@ -34,20 +34,53 @@ namespace xdp {
   // Forward declarations
   class VTFEvent;
 
+  // Native API calls are the highest rate host events.  They are
+  // stored as compact records and only turned into VTFEvent objects
+  // when a writer moves them out of the database.
+  struct HostEventRecord
+  {
+    enum Kind : uint32_t {
+      NATIVE_API        = 0,
+      NATIVE_SYNC_READ  = 1,
+      NATIVE_SYNC_WRITE = 2
+    };
+
+    uint64_t id;
+    uint64_t startId;
+    double   timestamp;
+    uint32_t name; // Index into the string table
+    Kind     kind;
+  };
+
   // The HostDB contains all the dynamic event information related
   // to the different host tracing and anything higher level (like user events)
   class HostDB
   {
   private:
     static constexpr uint64_t eventThreshold = 10000000;
-
-    // Before all events are printed in a CSV, they have to be sorted.
-    // The multimap sorts them as we create and insert them.
-    std::multimap<double, VTFEvent*> sortedEvents;
-
-    // For host events that will be sorted later (when printed), we
-    // can store them away in a simple vector
-    std::vector<VTFEvent*> unsortedEvents;
+    static constexpr size_t recordChunkSize = 4096;
+
+    // Host events are appended to a shard owned by the thread that
+    // created them, so adding an event never contends with other
+    // threads.  The shard lock is only contended when a writer
+    // collects the events.
+    struct EventShard
+    {
+      std::mutex lock;
+
+      // Before all events are printed in a CSV, they have to be
+      // sorted.  Events are appended in creation order and merged
+      // across shards by timestamp when they are collected.
+      std::vector<std::pair<double, VTFEvent*>> sortedEvents;
+
+      // For host events that will be sorted later (when printed), we
+      // can store them away in a simple vector
+      std::vector<VTFEvent*> unsortedEvents;
+
+      // Append only arena of native API records
+      std::vector<std::unique_ptr<HostEventRecord[]>> recordChunks;
+      size_t numRecords = 0;
+    };
 
     // This object keeps track of matching start events with end events
     APIMatch<uint64_t, uint64_t> eventStarts;
@@ -69,16 +102,28 @@ namespace xdp {
     // Different host layers can have dependencies between events
     DependencyManager openclDependencies;
 
-    std::mutex sortedLock; // Protects the "sortedEvents" multimap
-    std::mutex unsortedLock; // Protects the "unsortedEvents" vector
+    // Unique per database so thread local shard pointers are never
+    // used with the wrong database
+    uint64_t instanceId;
+
+    std::mutex shardLock; // Protects the "shards" vector
+    std::vector<std::unique_ptr<EventShard>> shards;
+
+    EventShard* getShard();
+
+    // Merge the per shard events, each already in creation order,
+    // into a single vector sorted by timestamp
+    std::vector<VTFEvent*>
+    mergeSorted(std::vector<std::vector<std::pair<double, VTFEvent*>>>& lists);
 
   public:
-    HostDB() = default;
+    XDP_CORE_EXPORT HostDB();
     XDP_CORE_EXPORT ~HostDB();
 
     // Functions to add host events to the database
     void addSortedEvent(VTFEvent* event);
     void addUnsortedEvent(VTFEvent* event);
+    void addRecord(const HostEventRecord& record);
 
     // A function to check the sorted events to see if any events that
     // fit the filter exist are currently stored in the database.
@@ -104,6 +149,7 @@ namespace xdp {
     // creates a vector of the events that fit the filter.  This
     // transfers ownership of the events to the caller.
     // Not a unique pointer because it needs to be sorted later.
+    // Native API records are converted to events first.
     std::vector<VTFEvent*>
     moveUnsortedEvents(std::function<bool (VTFEvent*)>& filter);
 
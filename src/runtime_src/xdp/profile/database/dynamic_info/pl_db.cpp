@@ -57,6 +57,21 @@ namespace xdp {
     return collected;
   }
 
+  // Move the events that are older than the timestamp, which lets
+  // streaming writers flush closed time windows while trace is
+  // still being processed.
+  std::vector<std::unique_ptr<VTFEvent>> PLDB::moveEventsBefore(double timestamp)
+  {
+    std::lock_guard<std::mutex> lock(eventLock);
+
+    std::vector<std::unique_ptr<VTFEvent>> collected;
+    auto end = events.lower_bound(timestamp);
+    for (auto iter = events.begin(); iter != end; ++iter)
+      collected.emplace_back(iter->second);
+    events.erase(events.begin(), end);
+    return collected;
+  }
+
   void PLDB::markStart(uint64_t monitorId, const DeviceEventInfo& info)
   {
     std::lock_guard<std::mutex> lock(startLock);
@@ -79,6 +79,7 @@ namespace xdp {
     bool eventsExist();
 
     std::vector<std::unique_ptr<VTFEvent>> moveEvents();
+    std::vector<std::unique_ptr<VTFEvent>> moveEventsBefore(double timestamp);
 
     void markStart(uint64_t monitorId, const DeviceEventInfo& info);
     DeviceEventInfo findMatchingStart(uint64_t monitorId, VTFEventType type);
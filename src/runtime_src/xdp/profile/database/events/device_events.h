@@ -109,6 +109,7 @@ namespace xdp {
     XDP_CORE_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket);
 
     virtual int32_t getCUId() { return cuId; }
+    inline uint64_t getMemoryName() { return memoryName; }
 
     void setBurstLength(uint16_t length) { burstLength = length; }
   } ;
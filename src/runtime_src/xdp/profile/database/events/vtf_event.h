@@ -101,6 +101,7 @@ namespace xdp {
     inline void         setTimestamp(double ts) { timestamp = ts ; }
     inline uint64_t     getEventId()            { return id ; }
     inline void         setEventId(uint64_t i)  { id = i ; }
+    inline uint64_t     getStartId()            { return start_id ; }
     inline VTFEventType getEventType()          { return type; }
 
     // Functions that can be used as filters
@@ -15,6 +15,8 @@
  * under the License.
  */
 
+#include <atomic>
+#include <cstring>
 #include <vector>
 #include <thread>
 #include <iostream>
@@ -23,10 +25,41 @@
 
 #include "xdp/profile/database/statistics_database.h"
 
+namespace {
+
+  std::atomic<uint64_t> nextInstanceId {1} ;
+
+  // Per thread cache of the call shard and the interned function
+  //  ids of the statistics database instance last used by the thread.
+  //  Function names are looked up by address and verified by
+  //  content, so callers passing transient strings are still counted
+  //  correctly.
+  struct ThreadCallCache
+  {
+    uint64_t instanceId = 0 ;
+    void* shard = nullptr ;
+    std::unordered_map<const char*, std::pair<uint32_t, const std::string*>> ids ;
+  } ;
+
+  ThreadCallCache& getThreadCallCache(uint64_t instanceId)
+  {
+    static thread_local ThreadCallCache cache ;
+    if (cache.instanceId != instanceId) {
+      cache.instanceId = instanceId ;
+      cache.shard = nullptr ;
+      cache.ids.clear() ;
+    }
+    return cache ;
+  }
+
+} // end anonymous namespace
+
 namespace xdp {
 
   VPStatisticsDatabase::VPStatisticsDatabase(VPDatabase* d) :
-    db(d), numMigrateMemCalls(0), numHostP2PTransfers(0),
+    db(d), instanceId(nextInstanceId++),
+    migrateMemFunctionId(internFunction("clEnqueueMigrateMemObjects").first),
+    numMigrateMemCalls(0), numHostP2PTransfers(0),
     numObjectsReleased(0), contextEnabled(false),
     totalHostReadTime(0), totalHostWriteTime(0), totalBufferStartTime(0),
     totalBufferEndTime(0), firstKernelStartTime(0.0), lastKernelEndTime(0.0)
@@ -206,57 +239,130 @@ namespace xdp {
     }
   }
 
-  void VPStatisticsDatabase::logFunctionCallStart(const std::string& name,
-                                                  double timestamp)
+  std::pair<uint32_t, const std::string*>
+  VPStatisticsDatabase::internFunction(const char* name)
+  {
+    std::lock_guard<std::mutex> lock(functionLock) ;
+
+    auto iter = functionIds.find(name) ;
+    if (iter != functionIds.end())
+      return { iter->second, &functionNames[iter->second] } ;
+
+    auto id = static_cast<uint32_t>(functionNames.size()) ;
+    functionNames.emplace_back(name) ;
+    functionIds.emplace(functionNames.back(), id) ;
+    return { id, &functionNames.back() } ;
+  }
+
+  uint32_t VPStatisticsDatabase::getFunctionId(const char* name)
   {
-    std::lock_guard<std::mutex> lock(dbLock);
+    auto& cache = getThreadCallCache(instanceId) ;
+    auto iter = cache.ids.find(name) ;
+    if (iter != cache.ids.end() &&
+        std::strcmp(iter->second.second->c_str(), name) == 0)
+      return iter->second.first ;
+
+    auto entry = internFunction(name) ;
+    cache.ids[name] = entry ;
+    return entry.first ;
+  }
 
+  VPStatisticsDatabase::CallShard* VPStatisticsDatabase::getCallShard()
+  {
+    auto& cache = getThreadCallCache(instanceId) ;
+    if (cache.shard)
+      return static_cast<CallShard*>(cache.shard) ;
+
+    auto shard = std::make_unique<CallShard>() ;
+    shard->threadId = std::this_thread::get_id() ;
+    cache.shard = shard.get() ;
+
+    std::lock_guard<std::mutex> lock(shardLock) ;
+    callShards.push_back(std::move(shard)) ;
+    return callShards.back().get() ;
+  }
+
+  std::map<std::pair<std::string, std::thread::id>,
+           std::vector<std::pair<double, double>>>
+  VPStatisticsDatabase::getCallCount()
+  {
+    // Build the thread specific view of all calls from the shards.
+    //  The view is returned by value so concurrent callers each get
+    //  their own copy.
+    std::map<std::pair<std::string, std::thread::id>,
+             std::vector<std::pair<double, double>>> callCount ;
+
+    std::lock_guard<std::mutex> shardsLock(shardLock) ;
+    for (auto& shard : callShards) {
+      std::lock_guard<std::mutex> callsLock(shard->lock) ;
+      for (uint32_t id = 0 ; id < shard->calls.size() ; ++id) {
+        if (shard->calls[id].empty())
+          continue ;
+
+        std::string name ;
+        {
+          std::lock_guard<std::mutex> namesLock(functionLock) ;
+          name = functionNames[id] ;
+        }
+        // A thread id can be reused by the OS after its thread exits,
+        //  so shards with the same id are merged, not replaced
+        auto& calls = callCount[std::make_pair(std::move(name), shard->threadId)] ;
+        calls.insert(calls.end(), shard->calls[id].begin(),
+                     shard->calls[id].end()) ;
+      }
+    }
+    return callCount ;
+  }
+
+  void VPStatisticsDatabase::logFunctionCallStart(const char* name,
+                                                  double timestamp)
+  {
     // Each function that we are tracking will have two distinct entry
     // points that we need to keep track of, the starting point
     // and the ending point.  In this function, we log the starting point
     // of a function call.  Since the calls could be coming in simultaneously
-    // from different threads, we also use the thread id to create
-    // a unique identifier.
+    // from different threads, each thread logs into its own shard.
 
-    auto threadId = std::this_thread::get_id();
-    auto key      = std::make_pair(name, threadId);
-    std::pair<double, double>value {timestamp, 0.0};
+    auto id    = getFunctionId(name) ;
+    auto shard = getCallShard() ;
 
     // Since a single thread can call a function multiple times, we store
     // the starts in a vector.  If the thread makes a recursive call, we'll
     // have multiple elements where the start value is set but the end value
     // needs to be filled in.
-    if (callCount.find(key) == callCount.end()) {
-      std::vector<std::pair<double, double>> newVector;
-      newVector.push_back(value);
-      callCount[key] = newVector;
+    {
+      std::lock_guard<std::mutex> lock(shard->lock) ;
+      if (shard->calls.size() <= id)
+        shard->calls.resize(id + 1) ;
+      shard->calls[id].emplace_back(timestamp, 0.0) ;
     }
-    else
-      callCount[key].push_back(value);
 
     // OpenCL specific information 
-    if (name == "clEnqueueMigrateMemObjects")
-      addMigrateMemCall();
+    if (id == migrateMemFunctionId) {
+      std::lock_guard<std::mutex> lock(dbLock) ;
+      addMigrateMemCall() ;
+    }
   }
 
-  void VPStatisticsDatabase::logFunctionCallEnd(const std::string& name,
+  void VPStatisticsDatabase::logFunctionCallEnd(const char* name,
                                                 double timestamp)
   {
-    std::lock_guard<std::mutex> lock(dbLock);
+    auto id    = getFunctionId(name) ;
+    auto shard = getCallShard() ;
 
-    auto threadId = std::this_thread::get_id();
-    auto key      = std::make_pair(name, threadId);
+    std::lock_guard<std::mutex> lock(shard->lock) ;
+    if (shard->calls.size() <= id)
+      return ;
 
     // Since some calls might be recursive, we must go backwards to find
-    // the first call that has a start time set but no end time.  Since we've
-    // incorporated the thread id as part of our key, we will match recursive
+    // the first call that has a start time set but no end time.  Since
+    // the shard is specific to this thread, we will match recursive
     // calls correctly
-    for (auto iter = callCount[key].rbegin();
-         iter != callCount[key].rend();
-         ++iter) {
+    auto& calls = shard->calls[id] ;
+    for (auto iter = calls.rbegin() ; iter != calls.rend() ; ++iter) {
       if ((*iter).second == 0) {
-        (*iter).second = timestamp;
-        break;
+        (*iter).second = timestamp ;
+        break ;
       }
     }
   }
@@ -448,7 +554,7 @@ namespace xdp {
     //  the number of calls
     std::map<std::string, uint64_t> counts ;
 
-    for (const auto& c : callCount)
+    for (const auto& c : getCallCount())
     {
       if (counts.find(c.first.first) == counts.end())
       {
@@ -18,13 +18,16 @@
 #ifndef VP_STATISTICS_DATABASE_DOT_H
 #define VP_STATISTICS_DATABASE_DOT_H
 
+#include <deque>
 #include <fstream>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 // For the device results structures
@@ -175,9 +178,31 @@ namespace xdp {
     VPDatabase* db ;
 
   private:
-    // Statistics on API calls (OpenCL and HAL) have to be thread specific
-    std::map<std::pair<std::string, std::thread::id>,
-             std::vector<std::pair<double, double>>> callCount ;
+    // Statistics on API calls (OpenCL and HAL) have to be thread specific.
+    //  Each thread logs its calls into its own shard, indexed by an
+    //  interned function id, so logging a call never takes a lock
+    //  shared with other threads.  The shards are merged into a
+    //  new map each time the statistics are requested.
+    struct CallShard
+    {
+      std::thread::id threadId ;
+      std::mutex lock ; // Only contended while merging
+      std::vector<std::vector<std::pair<double, double>>> calls ;
+    } ;
+
+    // Unique per database instance so thread local shard pointers
+    //  are never used with the wrong database
+    uint64_t instanceId ;
+
+    std::mutex shardLock ;
+    std::vector<std::unique_ptr<CallShard>> callShards ;
+
+    // Function names interned to ids.  The deque keeps the names
+    //  stable so their addresses can be cached per thread.
+    std::mutex functionLock ;
+    std::deque<std::string> functionNames ;
+    std::unordered_map<std::string, uint32_t> functionIds ;
+    uint32_t migrateMemFunctionId ;
 
     // **** User Level Event Statistics ****
     std::map<std::string, uint64_t> eventCounts ;
@@ -248,14 +273,19 @@ namespace xdp {
     void addTopHostWrite(BufferTransferStats& transfer) ;
     void addTopKernelExecution(KernelExecutionStats& exec) ;
 
+    // Helper functions for API call statistics
+    std::pair<uint32_t, const std::string*> internFunction(const char* name) ;
+    uint32_t getFunctionId(const char* name) ;
+    CallShard* getCallShard() ;
+
   public:
     XDP_CORE_EXPORT VPStatisticsDatabase(VPDatabase* d) ;
     XDP_CORE_EXPORT ~VPStatisticsDatabase() ;
 
     // Getters and setters
-    inline const std::map<std::pair<std::string, std::thread::id>,
-                    std::vector<std::pair<double, double>>>& getCallCount() 
-      { return callCount ; }
+    XDP_CORE_EXPORT
+    std::map<std::pair<std::string, std::thread::id>,
+             std::vector<std::pair<double, double>>> getCallCount() ;
     inline const std::map<uint64_t, DeviceMemoryStatistics>& getMemoryStats() 
       { return memoryStats ; }
     inline const std::map<std::string, TimeStatistics>& getKernelExecutionStats() 
@@ -332,10 +362,14 @@ namespace xdp {
       { return totalRangeDurations; }
 
     // Logging Functions
-    XDP_CORE_EXPORT void logFunctionCallStart(const std::string& name, 
-                                         double timestamp) ;
-    XDP_CORE_EXPORT void logFunctionCallEnd(const std::string& name, 
-                                       double timestamp) ;
+    XDP_CORE_EXPORT void logFunctionCallStart(const char* name,
+                                              double timestamp) ;
+    XDP_CORE_EXPORT void logFunctionCallEnd(const char* name,
+                                            double timestamp) ;
+    inline void logFunctionCallStart(const std::string& name, double timestamp)
+      { logFunctionCallStart(name.c_str(), timestamp) ; }
+    inline void logFunctionCallEnd(const std::string& name, double timestamp)
+      { logFunctionCallEnd(name.c_str(), timestamp) ; }
 
     XDP_CORE_EXPORT void logMemoryTransfer(uint64_t deviceId, 
                                       DeviceMemoryStatistics::ChannelType channelType,
@@ -17,11 +17,16 @@
 
 #define XDP_CORE_SOURCE
 
+#include <algorithm>
+#include <map>
+
 #include "xdp/profile/database/static_info/pl_constructs.h"
 #include "xdp/profile/device/pl_device_trace_logger.h"
+#include "xdp/profile/device/tracedefs.h"
 #include "xdp/profile/plugin/vp_base/utility.h"
 #include "xdp/profile/database/static_info/xclbin_info.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/message.h"
 #include "experimental/xrt_profile.h"
 
@@ -59,6 +64,135 @@ namespace xdp {
     //  any configured for just trace.
     aimLastTrans.resize((db->getStaticInfo()).getNumUserAIM(deviceId, xclbin));
     asmLastTrans.resize((db->getStaticInfo()).getNumUserASM(deviceId, xclbin));
+
+    assignLanes();
+  }
+
+  PLDeviceTraceLogger::~PLDeviceTraceLogger()
+  {
+    {
+      std::lock_guard<std::mutex> lock(laneLock);
+      stopLanes = true;
+    }
+    laneReady.notify_all();
+    for (auto& worker : laneWorkers)
+      worker.join();
+  }
+
+  void PLDeviceTraceLogger::assignLanes()
+  {
+    // Every trace ID that processTraceData logs
+    traceIdLanes.assign(util::max_trace_id_asm, 0);
+
+    // Each monitor covers a range of trace IDs
+    struct TraceIdRange {
+      uint64_t first;
+      uint64_t count;
+      int32_t cuId;
+    };
+    std::vector<TraceIdRange> ranges;
+
+    for (uint64_t slot = 0; slot < amLastTrans.size(); ++slot) {
+      Monitor* mon = db->getStaticInfo().getAMonitor(deviceId, xclbin, slot);
+      if (mon)
+        ranges.push_back({util::min_trace_id_am + slot * 16, 16, mon->cuIndex});
+    }
+    for (uint64_t slot = 0; slot < aimLastTrans.size(); ++slot) {
+      Monitor* mon = db->getStaticInfo().getAIMonitor(deviceId, xclbin, slot);
+      if (mon)
+        ranges.push_back({slot * 2, 2, mon->cuIndex});
+    }
+    for (uint64_t slot = 0; slot < asmLastTrans.size(); ++slot) {
+      Monitor* mon = db->getStaticInfo().getASMonitor(deviceId, xclbin, slot);
+      if (mon)
+        ranges.push_back({util::min_trace_id_asm + slot, 1, mon->cuIndex});
+    }
+
+    // Floating monitors are grouped together as compute unit -1
+    std::map<int32_t, uint32_t> cuIndices;
+    for (auto& range : ranges)
+      cuIndices.emplace(range.cuId, 0);
+    uint32_t index = 0;
+    for (auto& cu : cuIndices)
+      cu.second = index++;
+
+    uint32_t numThreads = xrt_core::config::get_device_trace_decode_threads();
+    if (numThreads == 0)
+      numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    numLanes = std::min({static_cast<uint32_t>(cuIndices.size()), numThreads,
+                         static_cast<uint32_t>(TRACE_DECODE_MAX_LANES)});
+    numLanes = std::max(numLanes, 1u);
+
+    for (auto& range : ranges) {
+      auto lane = static_cast<uint8_t>(cuIndices[range.cuId] % numLanes);
+      for (uint64_t id = range.first;
+           id < range.first + range.count && id < traceIdLanes.size(); ++id)
+        traceIdLanes[id] = lane;
+    }
+    laneBatches.resize(numLanes);
+  }
+
+  void PLDeviceTraceLogger::logPacket(uint64_t trace, double hostTimestamp)
+  {
+    auto traceId = getTraceId(trace);
+    if (traceId >= util::min_trace_id_am && traceId <= util::max_trace_id_am)
+      addAMEvent(trace, hostTimestamp);
+    if (traceId <= util::max_trace_id_aim) // min trace id aim == 0
+      addAIMEvent(trace, hostTimestamp);
+    if (traceId >= util::min_trace_id_asm && traceId < util::max_trace_id_asm)
+      addASMEvent(trace, hostTimestamp);
+  }
+
+  void PLDeviceTraceLogger::logLane(uint32_t lane)
+  {
+    for (auto& decoded : laneBatches[lane])
+      logPacket(decoded.trace, decoded.hostTimestamp);
+    laneBatches[lane].clear();
+  }
+
+  // Log all lanes of the current buffer and wait for them to finish.
+  //  Lanes have to finish before the next buffer is decoded as the
+  //  approximations use the current clock training.
+  void PLDeviceTraceLogger::logLanes()
+  {
+    if (laneWorkers.empty()) {
+      for (uint32_t lane = 1; lane < numLanes; ++lane)
+        laneWorkers.emplace_back(&PLDeviceTraceLogger::laneWorker, this, lane);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(laneLock);
+      lanesPending = numLanes - 1;
+      ++laneGeneration;
+    }
+    laneReady.notify_all();
+
+    logLane(0);
+
+    std::unique_lock<std::mutex> lock(laneLock);
+    laneDone.wait(lock, [this] { return lanesPending == 0; });
+  }
+
+  void PLDeviceTraceLogger::laneWorker(uint32_t lane)
+  {
+    uint64_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(laneLock);
+        laneReady.wait(lock, [this, generation] {
+          return stopLanes || laneGeneration != generation;
+        });
+        if (stopLanes)
+          return;
+        generation = laneGeneration;
+      }
+
+      logLane(lane);
+
+      std::lock_guard<std::mutex> lock(laneLock);
+      if (--lanesPending == 0)
+        laneDone.notify_one();
+    }
   }
 
   void PLDeviceTraceLogger::addCUEndEvent(double hostTimestamp,
@@ -79,6 +213,8 @@ namespace xdp {
                                  hostTimestamp, KERNEL, deviceId, s, cuId);
     event->setDeviceTimestamp(deviceTimestamp);
     db->getDynamicInfo().addEvent(event);
+
+    std::lock_guard<std::mutex> lock(statsLock);
     (db->getStats()).setLastKernelEndTime(hostTimestamp);
 
     // Log a CU execution in our statistics database
@@ -130,6 +266,7 @@ namespace xdp {
       if(1 == cuStarts[slot].size()) {
         traceIDs[slot] = 0; // When current CU starts, reset stall status
       }
+      std::lock_guard<std::mutex> lock(statsLock);
       if (db->getStats().getFirstKernelStartTime() == 0.0)
         (db->getStats()).setFirstKernelStartTime(hostTimestamp);
     }
@@ -468,10 +605,8 @@ namespace xdp {
         continue; // nothing to do? what about unmatched start?
       }
       const char* msg = "Incomplete CU profile trace detected. Timeline trace will have approximate CU End.";
-      if (!warnCUIncomplete) {
+      if (!warnCUIncomplete.exchange(true))
         xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg);
-        warnCUIncomplete = true;
-      }
 
       // end event
       double hostTimestamp = convertDeviceToHostTimestamp(cuLastTimestamp);
@@ -814,20 +949,17 @@ namespace xdp {
       }
 
       double hostTimestamp = convertDeviceToHostTimestamp(deviceTimestamp);
-      if (AMPacket) {
-        addAMEvent(packet, hostTimestamp);
-      }
-      if (AIMPacket) {
-        addAIMEvent(packet, hostTimestamp);
-      }
-      if (ASMPacket) {
-        addASMEvent(packet, hostTimestamp);
-      }
+      if (numLanes > 1)
+        laneBatches[traceIdLanes[traceId]].push_back({packet, hostTimestamp});
+      else
+        logPacket(packet, hostTimestamp);
 
       // keep track of latest timestamp that comes through trace
       mLatestHostTimestampMs = hostTimestamp;
     }
 
+    if (numLanes > 1)
+      logLanes();
   }
 
   void PLDeviceTraceLogger::endProcessTraceData()
@@ -18,6 +18,11 @@
 #ifndef _XDP_PROFILE_DEVICE_BASE_TRACE_LOGGER_H
 #define _XDP_PROFILE_DEVICE_BASE_TRACE_LOGGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "xdp/config.h"
@@ -44,6 +49,29 @@ namespace xdp {
     std::vector<uint64_t> aimLastTrans;
     std::vector<uint64_t> asmLastTrans;
 
+    // Decoded packets are logged by lanes.  All monitors of a compute
+    //  unit map to the same lane, so the per-slot state above and the
+    //  matching start events in the database are only touched by one
+    //  lane.  Lane 0 runs on the decoding thread.
+    struct DecodedPacket {
+      uint64_t trace;
+      double hostTimestamp;
+    };
+    uint32_t numLanes = 1;
+    std::vector<uint8_t> traceIdLanes;
+    std::vector<std::vector<DecodedPacket>> laneBatches;
+
+    std::vector<std::thread> laneWorkers;
+    std::mutex laneLock;
+    std::condition_variable laneReady;
+    std::condition_variable laneDone;
+    uint64_t laneGeneration = 0;
+    uint32_t lanesPending = 0;
+    bool stopLanes = false;
+
+    // Protects the compute unit statistics updated from all lanes
+    std::mutex statsLock;
+
     // Parsing functions for getting different parts of a device event packet
     inline uint64_t getDeviceTimestamp(uint64_t trace)
       { return (trace & 0x1FFFFFFFFFFF) - firstTimestamp; }
@@ -62,7 +90,14 @@ namespace xdp {
     double traceClockRateMHz;
     double clockTrainSlope;
 
-    bool warnCUIncomplete=false;
+    // Set by any of the parallel lanes
+    std::atomic<bool> warnCUIncomplete{false};
+
+    void assignLanes();
+    void logPacket(uint64_t trace, double hostTimestamp);
+    void logLane(uint32_t lane);
+    void logLanes();
+    void laneWorker(uint32_t lane);
 
     void trainDeviceHostTimestamps(uint64_t deviceTimestamp, uint64_t hostTimestamp);
     double convertDeviceToHostTimestamp(uint64_t deviceTimestamp);
@@ -111,11 +146,14 @@ namespace xdp {
   public:
 
     XDP_CORE_EXPORT PLDeviceTraceLogger(uint64_t devId);
-    XDP_CORE_EXPORT ~PLDeviceTraceLogger() = default;
+    XDP_CORE_EXPORT ~PLDeviceTraceLogger();
 
     XDP_CORE_EXPORT void processTraceData(void* data, uint64_t numBytes);
     XDP_CORE_EXPORT void endProcessTraceData();
     XDP_CORE_EXPORT void addEventMarkers(bool isFIFOFull, bool isTS2MMFull);
+
+    inline double getLatestHostTimestamp() { return mLatestHostTimestampMs; }
+    inline uint32_t getNumDecodeLanes() { return numLanes; }
   } ;
 
 }
@@ -125,35 +125,23 @@ process_trace()
   if (!has_ts2mm())
     return;
 
-  bool q_read = false;
-  bool q_empty = true;
   std::unique_ptr<unsigned char[]> buf;
   uint64_t size = 0;
-  do {
-    q_read=false;
-    ts2mm_info.process_queue_lock.lock();
-    if (!ts2mm_info.data_queue.empty()) {
-      buf = std::move(ts2mm_info.data_queue.front());
-      size = ts2mm_info.size_queue.front();
-      ts2mm_info.data_queue.pop();
-      ts2mm_info.size_queue.pop();
-      q_read = true;
-      q_empty = ts2mm_info.data_queue.empty();
-    }
-    if (ts2mm_info.size_queue.size() > TS2MM_QUEUE_SZ_WARN_THRESHOLD) {
+  while (ts2mm_info.process_queue.pop(buf, size)) {
+    if (ts2mm_info.process_queue.size() > TS2MM_QUEUE_SZ_WARN_THRESHOLD) {
       std::call_once(ts2mm_queue_warning_flag, [](){
         xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", TS2MM_WARN_MSG_QUEUE_SZ);
       });
     }
-    ts2mm_info.process_queue_lock.unlock();
 
     // Processing takes a lot more time compared to everything else
-    if (q_read) {
-      debug_stream << "Process " << size << " bytes of trace" << std::endl;
-      deviceTraceLogger->processTraceData(buf.get(), size) ;
-      buf.reset();
-    }
-  } while (!q_empty);
+    debug_stream << "Process " << size << " bytes of trace" << std::endl;
+    deviceTraceLogger->processTraceData(buf.get(), size) ;
+    buf.reset();
+
+    if (m_event_stream)
+      m_event_stream(deviceTraceLogger->getLatestHostTimestamp() - TRACE_STREAM_WINDOW_MS);
+  }
 }
 
 bool PLDeviceTraceOffload::
@@ -396,10 +384,7 @@ sync_and_log(uint64_t index)
   auto tmp = std::make_unique<unsigned char[]>(nBytes);
   std::memcpy(tmp.get(), host_buf, nBytes);
   // Push new data into queue for processing
-  ts2mm_info.process_queue_lock.lock();
-  ts2mm_info.data_queue.push(std::move(tmp));
-  ts2mm_info.size_queue.push(nBytes);
-  ts2mm_info.process_queue_lock.unlock();
+  ts2mm_info.process_queue.push(std::move(tmp), nBytes);
 
   // Print warning if processing large amount of trace
   if (nBytes > TS2MM_WARN_BIG_BUF_SIZE && !bd.big_trace_warn_done) {
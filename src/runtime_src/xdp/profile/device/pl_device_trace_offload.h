@@ -33,7 +33,6 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 
 namespace xdp {
@@ -77,6 +76,63 @@ struct TraceBufferInfo {
        
 };
 
+// Raw trace buffers handed from the offload thread to the processing
+// thread.  There is a single producer and a single consumer, so the
+// hand-off is a lock-free linked list that never blocks the offload.
+class TraceBufferQueue {
+  struct Node {
+    std::unique_ptr<unsigned char[]> data;
+    uint64_t size = 0;
+    std::atomic<Node*> next{nullptr};
+  };
+
+  Node* head;  // Owned by the consumer, always a consumed node
+  Node* tail;  // Owned by the producer
+  std::atomic<size_t> count{0};
+
+public:
+  TraceBufferQueue() : head(new Node), tail(head) {}
+
+  ~TraceBufferQueue()
+  {
+    while (head) {
+      Node* next = head->next.load(std::memory_order_relaxed);
+      delete head;
+      head = next;
+    }
+  }
+
+  TraceBufferQueue(const TraceBufferQueue&) = delete;
+  TraceBufferQueue& operator=(const TraceBufferQueue&) = delete;
+
+  void push(std::unique_ptr<unsigned char[]> data, uint64_t size)
+  {
+    auto node = new Node;
+    node->data = std::move(data);
+    node->size = size;
+    // Count before publishing, the consumer can pop the node as soon
+    // as it is linked and the count must never underflow
+    count.fetch_add(1, std::memory_order_relaxed);
+    tail->next.store(node, std::memory_order_release);
+    tail = node;
+  }
+
+  bool pop(std::unique_ptr<unsigned char[]>& data, uint64_t& size)
+  {
+    Node* next = head->next.load(std::memory_order_acquire);
+    if (!next)
+      return false;
+    data = std::move(next->data);
+    size = next->size;
+    delete head;
+    head = next;
+    count.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  size_t size() const { return count.load(std::memory_order_relaxed); }
+};
+
 struct Ts2mmInfo {
   size_t   num_ts2mm;
   uint64_t full_buf_size;
@@ -89,9 +145,7 @@ struct Ts2mmInfo {
   uint64_t circ_buf_min_rate = TS2MM_DEF_BUF_SIZE * 100;
   uint64_t circ_buf_cur_rate;
 
-  std::queue<std::unique_ptr<unsigned char[]>> data_queue;
-  std::queue<uint64_t> size_queue;
-  std::mutex process_queue_lock;
+  TraceBufferQueue process_queue;
 
   Ts2mmInfo()
     : num_ts2mm(0),
@@ -157,6 +211,11 @@ public:
   inline bool continuous_offload() { return continuous ; }
   inline void set_continuous(bool value = true) { continuous = value ; }
 
+  // Called with a timestamp before which all device events are
+  // complete each time a batch of trace has been processed
+  inline void set_event_stream(std::function<void(double)> stream)
+  { m_event_stream = std::move(stream); }
+
 private:
   void read_trace_fifo(bool force=true);
   void read_trace_s2mm(bool force=true);
@@ -191,6 +250,8 @@ private:
   std::thread process_thread;
   bool continuous = false;
 
+  std::function<void(double)> m_event_stream;
+
   // Clock Training Params
   bool m_force_clk_train = true;
   std::chrono::time_point<std::chrono::system_clock> m_prev_clk_train_time;
@@ -55,6 +55,13 @@
 // Use some arbitrary large number here
 #define TS2MM_QUEUE_SZ_WARN_THRESHOLD 5000
 
+// Events older than this many milliseconds before the latest processed
+// trace are considered closed and can be streamed out of the database
+#define TRACE_STREAM_WINDOW_MS 100.0
+
+// Upper limit on the threads logging decoded PL trace packets
+#define TRACE_DECODE_MAX_LANES 8
+
 // In some cases, we cannot use coarse mode
 #define COARSE_MODE_UNSUPPORTED "Coarse mode cannot be enabled. Defaulting to fine mode. Please check compilation for details."
 
@@ -136,13 +136,14 @@ namespace xdp {
     std::string filename = 
       "device_trace_" + std::to_string(deviceId) + ".csv" ;
 
-    VPWriter* writer = new DeviceTraceWriter(filename.c_str(),
-                                             deviceId,
-                                             version,
-                                             creationTime,
-                                             xrtVersion,
-                                             toolVersion);
+    DeviceTraceWriter* writer = new DeviceTraceWriter(filename.c_str(),
+                                                      deviceId,
+                                                      version,
+                                                      creationTime,
+                                                      xrtVersion,
+                                                      toolVersion);
     writers.push_back(writer);
+    traceWriters[deviceId] = writer;
     (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "VP_TRACE") ;
 
     if (continuous_trace)
@@ -266,6 +267,16 @@ namespace xdp {
           return ;
         }
       }
+
+      // Closed time windows are written out as soon as they are
+      //  processed so the database does not hold the whole trace
+      auto iter = traceWriters.find(deviceId);
+      if (device_trace && iter != traceWriters.end() && iter->second->isStreaming()) {
+        DeviceTraceWriter* writer = iter->second;
+        offloader->set_event_stream([writer](double timestamp) {
+          writer->streamEvents(timestamp);
+        });
+      }
     }
 
     offloaders[deviceId] = std::make_tuple(offloader, logger, devInterface) ;
@@ -29,6 +29,7 @@
 namespace xdp {
 
   // Forward declarations
+  class DeviceTraceWriter;
   class PLDeviceTraceLogger;
 
   // This plugin should be completely agnostic of what the host code profiling
@@ -61,6 +62,10 @@ namespace xdp {
 
     std::map<uint64_t, DeviceData> offloaders;
 
+    // The trace writer of each device, used to stream events
+    //  as they are offloaded when the binary trace format is used
+    std::map<uint64_t, DeviceTraceWriter*> traceWriters;
+
     void addDevice(const std::string& sysfsPath) ;
     void configureDataflow(uint64_t deviceId, PLDeviceIntf* devInterface) ;
     void configureFa(uint64_t deviceId, PLDeviceIntf* devInterface) ;
@@ -37,6 +37,17 @@ namespace xdp {
   static std::mutex timestampLock;
   static std::map<uint64_t, uint64_t> nativeTimestamps;
 
+  // Native API events are stored as compact records that are turned
+  // into events only when the trace is written
+  static void addNativeRecord(VPDatabase* db, uint64_t id, uint64_t startId,
+                              uint64_t timestamp, uint64_t name,
+                              HostEventRecord::Kind kind)
+  {
+    HostEventRecord record { id, startId, static_cast<double>(timestamp),
+                             static_cast<uint32_t>(name), kind };
+    db->getDynamicInfo().addHostRecord(record);
+  }
+
 } // end namespace xdp
 
 // The functionID is the unique identifier from the XRT side that we
@@ -50,22 +61,19 @@ void native_function_start(const char* functionName,
 
   // Don't include the profiling overhead in the time that we show.
   // That means there will be "empty gaps" in the timeline trace when
-  // the profiling overhead exists.  That means we create the event
-  // and add it to the database first, and set the timestamp as close as
+  // the profiling overhead exists.  That means we issue the event id
+  // and do the bookkeeping first, and take the timestamp as close as
   // possible to the true start of the observed function.
   xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase();
 
-  xdp::VTFEvent* event =
-    new xdp::NativeAPICall(0,
-                           0,
-                           db->getDynamicInfo().addString(functionName));
-  db->getDynamicInfo().addUnsortedEvent(event);
-  db->getDynamicInfo().markStart(static_cast<uint64_t>(functionID),
-                                 event->getEventId());
+  auto functionStr = db->getDynamicInfo().addString(functionName);
+  auto eventId = db->getDynamicInfo().issueEventId();
+  db->getDynamicInfo().markStart(static_cast<uint64_t>(functionID), eventId);
 
   db->getStats().logFunctionCallStart(functionName,
                                       static_cast<double>(xrt_core::time_ns()));
-  event->setTimestamp(static_cast<double>(xrt_core::time_ns()));
+  xdp::addNativeRecord(db, eventId, 0, xrt_core::time_ns(), functionStr,
+                       xdp::HostEventRecord::NATIVE_API);
 }
 
 // In order to not show profiling overhead in the timeline, we have
@@ -88,11 +96,9 @@ void native_function_end(const char* functionName,
   uint64_t start =
     db->getDynamicInfo().matchingStart(static_cast<uint64_t>(functionID));
 
-  xdp::VTFEvent* event =
-    new xdp::NativeAPICall(start,
-                           static_cast<double>(timestamp),
-                           db->getDynamicInfo().addString(functionName));
-  db->getDynamicInfo().addUnsortedEvent(event);
+  xdp::addNativeRecord(db, db->getDynamicInfo().issueEventId(), start,
+                       timestamp, db->getDynamicInfo().addString(functionName),
+                       xdp::HostEventRecord::NATIVE_API);
 }
 
 // Callbacks for sync functions will create two separate events to be displayed
@@ -115,22 +121,14 @@ void native_sync_start(const char* functionName,
 
   // Create two different events.  One for capturing the API to be put
   // on the API row, and one for the read/write data transfer rows.
-  xdp::VTFEvent* APIEvent      = nullptr;
-  xdp::VTFEvent* transferEvent = nullptr;
-
   auto functionStr = db->getDynamicInfo().addString(functionName);
-  APIEvent = new xdp::NativeAPICall(0, 0, functionStr);
-  if (isWrite)
-    transferEvent = new xdp::NativeSyncWrite(0, 0, functionStr);
-  else
-    transferEvent = new xdp::NativeSyncRead(0, 0, functionStr);
-
-  db->getDynamicInfo().addUnsortedEvent(APIEvent);
-  db->getDynamicInfo().addUnsortedEvent(transferEvent);
+  auto transferKind = isWrite ? xdp::HostEventRecord::NATIVE_SYNC_WRITE
+                              : xdp::HostEventRecord::NATIVE_SYNC_READ;
 
   // We need to store both events for lookup as we will only get one
   // "stop" event from the XRT side for this particular functionID.
-  xdp::EventPair events = { APIEvent->getEventId(), transferEvent->getEventId() };
+  xdp::EventPair events = { db->getDynamicInfo().issueEventId(),
+                            db->getDynamicInfo().issueEventId() };
   db->getDynamicInfo().markEventPairStart(static_cast<uint64_t>(functionID), events);
 
   {
@@ -141,8 +139,11 @@ void native_sync_start(const char* functionName,
   }
 
   db->getStats().logFunctionCallStart(functionName, static_cast<double>(xrt_core::time_ns()));
-  APIEvent->setTimestamp(static_cast<double>(xrt_core::time_ns()));
-  transferEvent->setTimestamp(static_cast<double>(xrt_core::time_ns()));
+  auto timestamp = xrt_core::time_ns();
+  xdp::addNativeRecord(db, events.APIEventId, 0, timestamp, functionStr,
+                       xdp::HostEventRecord::NATIVE_API);
+  xdp::addNativeRecord(db, events.transferEventId, 0, timestamp, functionStr,
+                       transferKind);
 }
 
 extern "C"
@@ -167,29 +168,16 @@ void native_sync_end(const char* functionName, unsigned long long int functionID
   auto startEvents =
     db->getDynamicInfo().matchingEventPairStart(static_cast<uint64_t>(functionID));
 
-  xdp::VTFEvent* APIEvent = nullptr;
-  xdp::VTFEvent* transferEvent = nullptr;
-
   auto functionStr = db->getDynamicInfo().addString(functionName);
-
-  APIEvent = new xdp::NativeAPICall(startEvents.APIEventId,
-                                    static_cast<double>(timestamp),
-                                    functionStr);
-
-  if (isWrite) {
-    transferEvent =
-      new xdp::NativeSyncWrite(startEvents.transferEventId,
-                               static_cast<double>(timestamp),
-                               functionStr);
-  }
-  else {
-    transferEvent =
-      new xdp::NativeSyncRead(startEvents.transferEventId,
-                              static_cast<double>(timestamp),
-                              db->getDynamicInfo().addString(functionName));
-  }
-  db->getDynamicInfo().addUnsortedEvent(APIEvent);
-  db->getDynamicInfo().addUnsortedEvent(transferEvent);
+  auto transferKind = isWrite ? xdp::HostEventRecord::NATIVE_SYNC_WRITE
+                              : xdp::HostEventRecord::NATIVE_SYNC_READ;
+
+  xdp::addNativeRecord(db, db->getDynamicInfo().issueEventId(),
+                       startEvents.APIEventId, timestamp, functionStr,
+                       xdp::HostEventRecord::NATIVE_API);
+  xdp::addNativeRecord(db, db->getDynamicInfo().issueEventId(),
+                       startEvents.transferEventId, timestamp, functionStr,
+                       transferKind);
 
   if (isWrite)
     db->getStats().logHostWrite(0, 0, size, startTimestamp, transferTime, 0, 0);
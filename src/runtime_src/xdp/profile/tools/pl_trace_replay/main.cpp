@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Replay a recorded raw PL trace through PLDeviceTraceLogger and
+// report the decoding throughput.  The trace is fed in chunks the
+// size of a TS2MM offload so the measurement matches continuous
+// offload.  The number of decoding threads is controlled by
+// Debug.device_trace_decode_threads in xrt.ini.
+//
+// % trace_replay <Raw Trace File> <Xclbin> [chunk bytes]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xdp/profile/database/database.h"
+#include "xdp/profile/device/pl_device_trace_logger.h"
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3 && argc != 4) {
+    std::cout << "Usage: " << argv[0] << " <Raw Trace File> <Xclbin> [chunk bytes]\n";
+    return 0;
+  }
+
+  std::string traceFile  = argv[1];
+  std::string xclbinFile = argv[2];
+  uint64_t chunkBytes = (argc == 4) ? std::stoull(argv[3]) : 0x100000;
+  chunkBytes = std::max<uint64_t>(chunkBytes / sizeof(uint64_t), 1) * sizeof(uint64_t);
+
+  std::ifstream fin(traceFile, std::ios::binary|std::ios::in);
+  if (!fin) {
+    std::cerr << "Cannot open raw trace file " << traceFile << std::endl;
+    return 0;
+  }
+
+  std::vector<uint64_t> traceData;
+  uint64_t packet = 0;
+  char* ch = reinterpret_cast<char*>(&packet);
+  while(fin.read(ch, 8)) {
+    traceData.push_back(packet);
+  }
+  fin.close();
+
+  xdp::VPDatabase* db = xdp::VPDatabase::Instance();
+  auto deviceId = db->addDevice("local");
+  db->getStaticInfo().updateDevice(deviceId, xclbinFile);
+
+  xdp::PLDeviceTraceLogger logger(deviceId);
+
+  // Chunks are handed over directly from the recorded buffer
+  auto data = reinterpret_cast<unsigned char*>(traceData.data());
+  uint64_t totalBytes = sizeof(uint64_t) * traceData.size();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (uint64_t offset = 0; offset < totalBytes; offset += chunkBytes)
+    logger.processTraceData(data + offset, std::min(chunkBytes, totalBytes - offset));
+  logger.endProcessTraceData();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  auto numEvents = db->getDynamicInfo().moveDeviceEvents(deviceId).size();
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  double seconds = std::max<double>(us, 1) / 1e6;
+
+  std::cout << "Decode lanes: " << logger.getNumDecodeLanes() << "\n"
+            << "Packets: " << traceData.size() << " in " << us << "us ("
+            << static_cast<uint64_t>(traceData.size() / seconds) << " packets/s)\n"
+            << "Events: " << numEvents << " ("
+            << static_cast<uint64_t>(numEvents / seconds) << " events/s)\n";
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Convert a binary device trace file into the csv device trace format.
+//
+// When Debug.device_trace_file_format=binary, device_trace_<n>.csv
+// only contains the header, structure, and string table sections and
+// the events are streamed to device_trace_<n>.bin while the application
+// runs.  This tool merges the two into a regular csv trace file.
+//
+// % xrt_device_trace_convert device_trace_0.csv device_trace_0.bin out.csv
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "xdp/profile/database/events/device_events.h"
+#include "xdp/profile/writer/device_trace/device_trace_record.h"
+#include "xdp/profile/writer/vp_base/BinaryDataHeader.h"
+
+namespace {
+
+  void usage()
+  {
+    std::cout << "usage: xrt_device_trace_convert <trace.csv> <trace.bin> <output.csv>\n";
+  }
+
+  std::vector<xdp::DeviceTraceRecord> readRecords(const std::string& fileName)
+  {
+    using namespace xdp::AIEBinaryData;
+
+    std::ifstream fin(fileName, std::ios::binary);
+    if (!fin)
+      throw std::runtime_error("Unable to open " + fileName);
+
+    BinaryDataHeader header;
+    fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!fin || !header.isHeaderMatched())
+      throw std::runtime_error(fileName + " is not a binary trace file");
+
+    std::vector<xdp::DeviceTraceRecord> records;
+    std::vector<char> content;
+    PacketHeader packet;
+    while (fin.read(reinterpret_cast<char*>(&packet), sizeof(packet))) {
+      if (!packet.isMagicNumberMatched() || packet.m_content_size > header.m_packageSize)
+        throw std::runtime_error(fileName + " contains a corrupted packet");
+
+      content.resize(packet.m_content_size);
+      fin.read(content.data(), packet.m_content_size);
+
+      const char* data = content.data();
+      uint32_t remaining = packet.m_content_size;
+      while (remaining > 0) {
+        xdp::DeviceTraceRecord record;
+        auto consumed = record.readFields(data, remaining);
+        if (consumed == 0)
+          break;
+        records.push_back(record);
+        data += consumed;
+        remaining -= consumed;
+      }
+
+      // Packets are padded to the packet size
+      fin.ignore(header.m_packageSize - sizeof(packet) - packet.m_content_size);
+    }
+
+    // Events are streamed in the order they were closed, which
+    //  is not necessarily the order of their timestamps
+    std::stable_sort(records.begin(), records.end(),
+                     [](const xdp::DeviceTraceRecord& l, const xdp::DeviceTraceRecord& r)
+                     { return l.timestamp < r.timestamp; });
+    return records;
+  }
+
+  void writeRecords(std::ofstream& fout, const std::vector<xdp::DeviceTraceRecord>& records)
+  {
+    for (const auto& record : records) {
+      // All device events print the same fields, so use a kernel event
+      //  which does not end the line and print the extras after it
+      xdp::KernelEvent event(record.startId, record.timestamp,
+                             static_cast<xdp::VTFEventType>(record.type), 0, 0, -1);
+      event.setEventId(record.id);
+      event.dump(fout, record.bucket);
+      for (uint32_t i = 0; i < record.numExtras; ++i)
+        fout << "," << record.extras[i];
+      fout << "\n";
+    }
+  }
+
+  int run(int argc, char** argv)
+  {
+    if (argc != 4) {
+      usage();
+      return EXIT_FAILURE;
+    }
+
+    std::ifstream skeleton(argv[1]);
+    if (!skeleton)
+      throw std::runtime_error(std::string("Unable to open ") + argv[1]);
+
+    auto records = readRecords(argv[2]);
+
+    std::ofstream fout(argv[3]);
+    if (!fout)
+      throw std::runtime_error(std::string("Unable to open ") + argv[3]);
+
+    // The events go right after the EVENTS marker of the csv file
+    std::string line;
+    bool inserted = false;
+    while (std::getline(skeleton, line)) {
+      fout << line << "\n";
+      if (!inserted && line == "EVENTS") {
+        writeRecords(fout, records);
+        inserted = true;
+      }
+    }
+
+    if (!inserted)
+      throw std::runtime_error(std::string(argv[1]) + " has no EVENTS section");
+
+    std::cout << "Converted " << records.size() << " events to " << argv[3] << "\n";
+    return 0;
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "xrt_device_trace_convert: " << ex.what() << "\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_PLUGIN_SOURCE
+
+#include <cstring>
+#include <iostream>
+
+#include "xdp/profile/writer/device_trace/device_trace_record.h"
+#include "xdp/profile/writer/vp_base/IBinaryDataWriter.h"
+
+namespace xdp {
+
+  DeviceTraceRecord::DeviceTraceRecord() : IBinaryDataEvent(EventTypeID())
+  {
+  }
+
+  DeviceTraceRecord::~DeviceTraceRecord() = default;
+
+  void DeviceTraceRecord::clear()
+  {
+    id = 0;
+    startId = 0;
+    timestamp = 0.0;
+    bucket = 0;
+    type = 0;
+    numExtras = 0;
+    extras[0] = extras[1] = 0;
+  }
+
+  void DeviceTraceRecord::print() const
+  {
+    std::cout << id << "," << startId << "," << timestamp << ","
+              << bucket << "," << type;
+    for (uint32_t i = 0; i < numExtras; ++i)
+      std::cout << "," << extras[i];
+    std::cout << std::endl;
+  }
+
+  uint32_t DeviceTraceRecord::getSize() const
+  {
+    uint32_t eventSize = IBinaryDataEvent::getTypeIDSize();
+    eventSize += sizeof(id);
+    eventSize += sizeof(startId);
+    eventSize += sizeof(timestamp);
+    eventSize += sizeof(bucket);
+    eventSize += sizeof(type);
+    eventSize += sizeof(numExtras);
+    eventSize += sizeof(extras);
+    return eventSize;
+  }
+
+  void DeviceTraceRecord::writeFields(AIEBinaryData::IBinaryDataWriter& writer) const
+  {
+    IBinaryDataEvent::writeTypeID(writer);
+    writer.writeField((const char*) &id,        sizeof(id));
+    writer.writeField((const char*) &startId,   sizeof(startId));
+    writer.writeField((const char*) &timestamp, sizeof(timestamp));
+    writer.writeField((const char*) &bucket,    sizeof(bucket));
+    writer.writeField((const char*) &type,      sizeof(type));
+    writer.writeField((const char*) &numExtras, sizeof(numExtras));
+    writer.writeField((const char*) extras,     sizeof(extras));
+  }
+
+  uint32_t DeviceTraceRecord::readFields(const char* data, uint32_t size)
+  {
+    auto eventSize = getSize();
+    if (size < eventSize)
+      return 0;
+
+    uint32_t typeId = 0;
+    std::memcpy(&typeId, data, sizeof(typeId));
+    if (typeId != EventTypeID())
+      return 0;
+
+    const char* field = data + sizeof(typeId);
+    auto read = [&field](void* dst, size_t bytes) {
+      std::memcpy(dst, field, bytes);
+      field += bytes;
+    };
+    read(&id,        sizeof(id));
+    read(&startId,   sizeof(startId));
+    read(&timestamp, sizeof(timestamp));
+    read(&bucket,    sizeof(bucket));
+    read(&type,      sizeof(type));
+    read(&numExtras, sizeof(numExtras));
+    read(extras,     sizeof(extras));
+    if (numExtras > maxExtras)
+      numExtras = maxExtras;
+
+    return eventSize;
+  }
+
+  uint32_t DeviceTraceRecord::EventTypeID()
+  {
+    return 301;
+  }
+
+} // end namespace xdp
@@ -0,0 +1,62 @@
+/**
+ * Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef DEVICE_TRACE_RECORD_DOT_H
+#define DEVICE_TRACE_RECORD_DOT_H
+
+#include <cstdint>
+
+#include "xdp/profile/writer/vp_base/IBinaryDataEvent.h"
+
+namespace xdp {
+
+  // A single device trace event in the binary device trace file.  The
+  // bucket is resolved when the event is streamed so the event can
+  // be printed without the static information of the run.  Extra
+  // fields are string table ids printed after the event type, like
+  // kernel tool tips or memory names.
+  class DeviceTraceRecord : public AIEBinaryData::IBinaryDataEvent
+  {
+  public:
+    static constexpr uint32_t maxExtras = 2;
+
+    uint64_t id = 0;
+    uint64_t startId = 0;
+    double   timestamp = 0.0;
+    uint32_t bucket = 0;
+    uint32_t type = 0;
+    uint32_t numExtras = 0;
+    uint64_t extras[maxExtras] = {0, 0};
+
+    DeviceTraceRecord();
+    ~DeviceTraceRecord() override;
+
+    void clear() override;
+    void print() const override;
+    [[nodiscard]] uint32_t getSize() const override;
+    void writeFields(AIEBinaryData::IBinaryDataWriter& writer) const override;
+
+    // Read the fields of a record written by writeFields.  Returns
+    // the number of bytes consumed, 0 if this is not a device trace
+    // record or the data is too short.
+    uint32_t readFields(const char* data, uint32_t size);
+
+    static uint32_t EventTypeID();
+  };
+
+} // end namespace xdp
+
+#endif
@@ -17,11 +17,15 @@
 
 #define XDP_PLUGIN_SOURCE
 
+#include <limits>
+
+#include "core/common/config_reader.h"
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/database/events/device_events.h"
 #include "xdp/profile/database/static_info/pl_constructs.h"
 #include "xdp/profile/database/static_info/xclbin_info.h"
 #include "xdp/profile/plugin/vp_base/utility.h"
+#include "xdp/profile/writer/device_trace/device_trace_record.h"
 #include "xdp/profile/writer/device_trace/device_trace_writer.h"
 
 namespace xdp {
@@ -36,6 +40,25 @@ namespace xdp {
       toolVersion(toolV),
       deviceId(devId)
   {
+    if (xrt_core::config::get_device_trace_file_format() != "binary")
+      return;
+
+    // The binary file is named after the csv file
+    std::string binaryFileName = getcurrentFileName();
+    auto pos = binaryFileName.rfind(".csv");
+    if (pos != std::string::npos)
+      binaryFileName.erase(pos);
+    binaryFileName += ".bin";
+
+    binaryStream.open(binaryFileName, std::fstream::in | std::fstream::out
+                                      | std::fstream::binary | std::fstream::trunc);
+    if (!binaryStream.is_open())
+      return;
+
+    // Device events are in host time, so there is no clock frequency
+    const uint32_t PACKETSIZE = 65536;
+    binaryWriter = std::make_unique<AIEBinaryData::BinaryDataWriter>
+      (binaryStream, (db->getStaticInfo()).getDeviceName(deviceId), 0, 0.0, PACKETSIZE);
   }
 
   DeviceTraceWriter::~DeviceTraceWriter()
@@ -144,10 +167,6 @@ namespace xdp {
            << "," << cu->getName() << "\n";
     }
 
-    std::pair<XclbinInfo*, int32_t> index =
-      std::make_pair(xclbin, cu->getIndex());
-    cuBucketIdMap[index] = rowCount;
-
     // Generate wave group for Kernel Stall if Stall monitoring is enabled in CU
     if (cu->getStallEnabled()) {
       fout << "Group_Summary_Start,Stall,Stalls in accelerator " << cu->getName() << "\n";
@@ -172,8 +191,7 @@ namespace xdp {
       if (nullptr == aim)
         continue;
 
-      std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, cuAIM);
-      aimBucketIdMap[index] = ++rowCount;
+      ++rowCount;
 
       size_t pos = aim->name.find('/');
       std::string portAndArgs = (std::string::npos != pos) ? aim->name.substr(pos+1) : aim->name;
@@ -209,8 +227,7 @@ namespace xdp {
       if (nullptr == ASM)
         continue;
 
-      std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, cuASM);
-      asmBucketIdMap[index] = ++rowCount;
+      ++rowCount;
 
       // KERNEL_STREAM_READ/WRITE
       fout << "Group_Start," << ASM->name << ",AXI Stream transaction over " << ASM->name << "\n";
@@ -241,8 +258,7 @@ namespace xdp {
         ++i;
         continue;
       }
-      std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, static_cast<uint32_t>(i));
-      aimBucketIdMap[index] = ++rowCount;
+      ++rowCount;
 
       std::string portAndArgs = aim->name;
       if (aim->cuPort && !aim->cuPort->args.empty()) {
@@ -286,8 +302,7 @@ namespace xdp {
         continue;
       }
 
-      std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, static_cast<uint32_t>(i));
-      asmBucketIdMap[index] = ++rowCount;
+      ++rowCount;
       fout << "Group_Start," << asM->name << ",AXI Stream transactions over " << asM->name << "\n";
       fout << "Static_Row," << rowCount << ",Stream Activity,AXI Stream transactions over " << asM->name << "\n";
       fout << "Static_Row," << ++rowCount << ",Link Stall" << "\n";
@@ -313,15 +328,155 @@ namespace xdp {
     fout << "Group_End," << deviceName << "\n";
   }
 
+  // Assign the rows of the STRUCTURE section to the monitors of the
+  //  xclbins loaded since the last update.  The rows are numbered in
+  //  the same order as the structure writers above number them, but
+  //  nothing is written, so the rows are computed once per xclbin load
+  //  and shared by the csv and binary event writers.
+  void DeviceTraceWriter::updateBucketIds()
+  {
+    auto& configs =
+      (db->getStaticInfo()).getLoadedConfigs(deviceId);
+
+    for (; bucketConfigCount < configs.size(); ++bucketConfigCount) {
+      XclbinInfo* xclbin = configs[bucketConfigCount]->getPlXclbin();
+      if (xclbin)
+        addXclbinBucketIds(xclbin, bucketRowCount);
+    }
+  }
+
+  void DeviceTraceWriter::addXclbinBucketIds(XclbinInfo* xclbin,
+                                             uint32_t& rowCount)
+  {
+    for (const auto& iter : xclbin->pl.cus) {
+      ComputeUnitInstance* cu = iter.second;
+
+      // Executions and stalls
+      if (-1 != cu->getAccelMon()) {
+        cuBucketIdMap[std::make_pair(xclbin, cu->getIndex())] = ++rowCount;
+        if (cu->getStallEnabled())
+          rowCount += (KERNEL_STALL_PIPE - KERNEL);
+      }
+
+      // Read and write channels
+      if (cu->getDataTransferTraceEnabled()) {
+        for (auto cuAIM : *(cu->getAIMsWithTrace())) {
+          if (nullptr == (db->getStaticInfo()).getAIMonitor(deviceId, xclbin, cuAIM))
+            continue;
+          aimBucketIdMap[std::make_pair(xclbin, cuAIM)] = ++rowCount;
+          ++rowCount;
+        }
+      }
+
+      // Stream activity, stall, and starve
+      if (cu->getStreamTraceEnabled()) {
+        for (auto cuASM : *(cu->getASMsWithTrace())) {
+          if (nullptr == (db->getStaticInfo()).getASMonitor(deviceId, xclbin, cuASM))
+            continue;
+          asmBucketIdMap[std::make_pair(xclbin, cuASM)] = ++rowCount;
+          rowCount += 2;
+        }
+      }
+    }
+
+    // Floating monitors are indexed by their position in the monitor list
+    if (db->getStaticInfo().hasFloatingAIMWithTrace(deviceId, xclbin)) {
+      uint32_t i = 0;
+      for (auto aim : *(db->getStaticInfo().getAIMonitors(deviceId, xclbin))) {
+        if (nullptr == aim)
+          continue;
+        if (-1 == aim->cuIndex) {
+          aimBucketIdMap[std::make_pair(xclbin, i)] = ++rowCount;
+          ++rowCount;
+        }
+        ++i;
+      }
+    }
+
+    if (db->getStaticInfo().hasFloatingASMWithTrace(deviceId, xclbin)) {
+      uint32_t i = 0;
+      for (auto asM : *(db->getStaticInfo().getASMonitors(deviceId, xclbin))) {
+        if (nullptr == asM)
+          continue;
+        if (-1 == asM->cuIndex) {
+          asmBucketIdMap[std::make_pair(xclbin, i)] = ++rowCount;
+          rowCount += 2;
+        }
+        ++i;
+      }
+    }
+  }
+
   void DeviceTraceWriter::writeStringTable()
   {
     fout << "MAPPING\n";
     (db->getDynamicInfo()).dumpStringTable(fout);
   }
 
+  bool DeviceTraceWriter::getBucket(VTFDeviceEvent* deviceEvent,
+                                    XclbinInfo* xclbin, uint32_t& bucket)
+  {
+    VTFEventType eventType = deviceEvent->getEventType();
+    int32_t cuId = deviceEvent->getCUId();
+
+    if (KERNEL == eventType) {
+      if (dynamic_cast<KernelEvent*>(deviceEvent) == nullptr)
+        return false; // Coverity - In case dynamic cast fails
+      bucket = cuBucketIdMap[std::make_pair(xclbin, cuId)] + eventType - KERNEL;
+      return true;
+    }
+
+    if (KERNEL_STALL_EXT_MEM == eventType
+        || KERNEL_STALL_DATAFLOW == eventType
+        || KERNEL_STALL_PIPE == eventType) {
+      bucket = cuBucketIdMap[std::make_pair(xclbin, cuId)] + eventType - KERNEL;
+      return true;
+    }
+
+    // Memory or Stream Acceses
+    uint32_t monId = deviceEvent->getMonitorId();
+    std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, monId);
+    if (dynamic_cast<DeviceMemoryAccess*>(deviceEvent)) {
+      bucket = aimBucketIdMap[index] + eventType - KERNEL_READ;
+      return true;
+    }
+    if (dynamic_cast<DeviceStreamAccess*>(deviceEvent)) {
+      if (KERNEL_STREAM_READ == eventType || KERNEL_STREAM_READ_STALL == eventType
+                                          || KERNEL_STREAM_READ_STARVE == eventType)
+        bucket = asmBucketIdMap[index] + eventType - KERNEL_STREAM_READ;
+      else
+        bucket = asmBucketIdMap[index] + eventType - KERNEL_STREAM_WRITE;
+      return true;
+    }
+    // host read/write ??
+    return false;
+  }
+
+  // The tool tips of kernel events are the kernel and compute unit names
+  std::vector<uint64_t> DeviceTraceWriter::getToolTips(XclbinInfo* xclbin, int32_t cuId)
+  {
+    std::vector<uint64_t> toolTips;
+    for (const auto& iter : xclbin->pl.cus) {
+      ComputeUnitInstance* cu = iter.second;
+      if (cu->getAccelMon() == cuId) {
+        toolTips.push_back(db->getDynamicInfo().addString(cu->getKernelName()));
+        toolTips.push_back(db->getDynamicInfo().addString(cu->getName()));
+      }
+    }
+    return toolTips;
+  }
+
   void DeviceTraceWriter::writeTraceEvents()
   {
     fout << "EVENTS\n";
+
+    // In binary mode all remaining events go to the binary file
+    if (binaryWriter) {
+      streamEventsBefore(std::numeric_limits<double>::max());
+      binaryWriter->flush();
+      return;
+    }
+
     auto DeviceEvents = db->getDynamicInfo().moveDeviceEvents(deviceId);
 
     auto& loadedConfigs =
@@ -329,6 +484,7 @@ namespace xdp {
     if (loadedConfigs.size() <= 0) {
       return;
     }
+    updateBucketIds();
 
     int configIndex = 0;
     ConfigInfo* config = loadedConfigs[configIndex].get();
@@ -341,7 +497,6 @@ namespace xdp {
       if(!deviceEvent)
         continue;
       
-      int32_t cuId = deviceEvent->getCUId();
       VTFEventType eventType = deviceEvent->getEventType();
       if (XCLBIN_END == eventType) {
         // If we hit the end of an xclbin's execution, then increment xclbins
@@ -351,55 +506,92 @@ namespace xdp {
           xclbin = config->getPlXclbin();
         }
         // TODO: Check if expect invalid PL xclbin here?
+        continue;
+      }
+
+      uint32_t bucket = 0;
+      if (!getBucket(deviceEvent, xclbin, bucket))
+        continue;
 
-      } else if (KERNEL == eventType) {
-        KernelEvent* kernelEvent = dynamic_cast<KernelEvent*>(deviceEvent);
-        if (kernelEvent == nullptr)
-          continue; // Coverity - In case dynamic cast fails
-        std::pair<XclbinInfo*, int32_t> index =
-          std::make_pair(xclbin, cuId);
-        kernelEvent->dump(fout, cuBucketIdMap[index] + eventType - KERNEL);
+      deviceEvent->dump(fout, bucket);
+      if (KERNEL == eventType) {
         // Also output the tool tips
-        for (const auto& iter : xclbin->pl.cus) {
-          ComputeUnitInstance* cu = iter.second;
-          if (cu->getAccelMon() == cuId) {
-            fout << "," << db->getDynamicInfo().addString(cu->getKernelName());
-            fout << "," << db->getDynamicInfo().addString(cu->getName());
-          }
-        }
+        for (auto toolTip : getToolTips(xclbin, deviceEvent->getCUId()))
+          fout << "," << toolTip;
         fout << "\n";
-      } else if(KERNEL_STALL_EXT_MEM == eventType
-                || KERNEL_STALL_DATAFLOW == eventType
-                || KERNEL_STALL_PIPE == eventType) {
-        std::pair<XclbinInfo*, int32_t> index =
-          std::make_pair(xclbin, cuId);
-        deviceEvent->dump(fout, cuBucketIdMap[index] + eventType - KERNEL);
-      } else {
-        // Memory or Stream Acceses
-        uint32_t monId = deviceEvent->getMonitorId();
-        DeviceMemoryAccess* memoryEvent = dynamic_cast<DeviceMemoryAccess*>(e.get());
-        if (memoryEvent) {
-          std::pair<XclbinInfo*, uint32_t> index =std::make_pair(xclbin, monId);
-          deviceEvent->dump(fout, aimBucketIdMap[index] + eventType - KERNEL_READ);
-          continue;
-        }
-        DeviceStreamAccess* streamEvent = dynamic_cast<DeviceStreamAccess*>(e.get());
-        if (streamEvent) {
-          std::pair<XclbinInfo*, uint32_t> index = std::make_pair(xclbin, monId);
-          if (KERNEL_STREAM_READ == eventType || KERNEL_STREAM_READ_STALL == eventType
-                                              || KERNEL_STREAM_READ_STARVE == eventType) {
-            deviceEvent->dump(fout, asmBucketIdMap[index] + eventType - KERNEL_STREAM_READ);
-          } else {
-            deviceEvent->dump(fout, asmBucketIdMap[index] + eventType - KERNEL_STREAM_WRITE);
-          }
-          continue;
-        }
-        // host read/write ??
       }
     }
 
   }
 
+  void DeviceTraceWriter::streamEvents(double timestamp)
+  {
+    if (!binaryWriter)
+      return;
+
+    std::lock_guard<std::mutex> lock(streamLock);
+    streamEventsBefore(timestamp);
+  }
+
+  // Stream the closed device events to the binary file.  The bucket
+  //  ids only depend on the xclbins loaded so far.
+  void DeviceTraceWriter::streamEventsBefore(double timestamp)
+  {
+    auto DeviceEvents =
+      db->getDynamicInfo().moveDeviceEventsBefore(deviceId, timestamp);
+    if (DeviceEvents.empty())
+      return;
+
+    auto& loadedConfigs =
+      (db->getStaticInfo()).getLoadedConfigs(deviceId);
+    if (streamConfigIndex >= loadedConfigs.size())
+      return;
+
+    updateBucketIds();
+
+    XclbinInfo* xclbin = loadedConfigs[streamConfigIndex]->getPlXclbin();
+    DeviceTraceRecord record;
+
+    for (auto& e : DeviceEvents) {
+      VTFDeviceEvent* deviceEvent = dynamic_cast<VTFDeviceEvent*>(e.get());
+      if (!deviceEvent)
+        continue;
+
+      VTFEventType eventType = deviceEvent->getEventType();
+      if (XCLBIN_END == eventType) {
+        // If we hit the end of an xclbin's execution, then increment xclbins
+        if (streamConfigIndex + 1 < loadedConfigs.size())
+          xclbin = loadedConfigs[++streamConfigIndex]->getPlXclbin();
+        continue;
+      }
+
+      uint32_t bucket = 0;
+      if (!xclbin || !getBucket(deviceEvent, xclbin, bucket))
+        continue;
+
+      record.clear();
+      record.id = deviceEvent->getEventId();
+      record.startId = deviceEvent->getStartId();
+      record.timestamp = deviceEvent->getTimestamp();
+      record.bucket = bucket;
+      record.type = eventType;
+
+      if (KERNEL == eventType) {
+        for (auto toolTip : getToolTips(xclbin, deviceEvent->getCUId())) {
+          if (record.numExtras == DeviceTraceRecord::maxExtras)
+            break;
+          record.extras[record.numExtras++] = toolTip;
+        }
+      }
+      else if (auto memoryEvent = dynamic_cast<DeviceMemoryAccess*>(deviceEvent)) {
+        record.extras[record.numExtras++] = memoryEvent->getMemoryName();
+      }
+
+      binaryWriter->writeEvent(static_cast<AIEBinaryData::IBinaryDataEvent::Time>(record.timestamp * 1e6),
+                               record);
+    }
+  }
+
   void DeviceTraceWriter::writeDependencies()
   {
     fout << "DEPENDENCIES\n";
@@ -416,6 +608,8 @@ namespace xdp {
     if (openNewFile && !traceEventsExist())
       return false;
 
+    std::lock_guard<std::mutex> lock(streamLock);
+
     initialize();
 
     writeHeader();
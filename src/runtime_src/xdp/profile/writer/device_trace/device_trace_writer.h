@@ -18,14 +18,22 @@
 #ifndef HAL_DEVICE_TRACE_WRITER_DOT_H
 #define HAL_DEVICE_TRACE_WRITER_DOT_H
 
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/device/pl_device_intf.h"
+#include "xdp/profile/writer/vp_base/BinaryDataWriter.h"
 #include "xdp/profile/writer/vp_base/vp_trace_writer.h"
 
 namespace xdp {
 
+  // Forward declarations
+  class VTFDeviceEvent ;
+
   class DeviceTraceWriter : public VPTraceWriter
   {
   private:
@@ -39,13 +47,36 @@ namespace xdp {
     std::map<std::pair<XclbinInfo*, uint32_t>, uint32_t> aimBucketIdMap;
     std::map<std::pair<XclbinInfo*, uint32_t>, uint32_t> asmBucketIdMap;
 
+    // Number of loaded configs and rows covered by the bucket id maps
+    size_t bucketConfigCount = 0;
+    uint32_t bucketRowCount = 0;
+
     uint64_t deviceId;
 
+    // In binary mode, events are streamed to a separate binary file
+    //  while the application runs and the csv file only contains the
+    //  header, structure, and string table.  xrt_device_trace_convert
+    //  combines the two into the csv format.
+    std::fstream binaryStream;
+    std::unique_ptr<AIEBinaryData::BinaryDataWriter> binaryWriter;
+    std::mutex streamLock;
+    size_t streamConfigIndex = 0;
+
     // Helper function for making sure the database has enough information
     //  to print out all of the information it will need.
     void initialize() ;
     bool traceEventsExist() ;
 
+    // Helper functions for assigning rows of the STRUCTURE section to
+    //  the monitors of each loaded xclbin without writing the section
+    void updateBucketIds() ;
+    void addXclbinBucketIds(XclbinInfo* xclbin, uint32_t& rowCount) ;
+
+    // Helper functions for writing individual events
+    bool getBucket(VTFDeviceEvent* event, XclbinInfo* xclbin, uint32_t& bucket) ;
+    std::vector<uint64_t> getToolTips(XclbinInfo* xclbin, int32_t cuId) ;
+    void streamEventsBefore(double timestamp) ;
+
     // Helper functions for individual parts of the STRUCTURE section
     void writeDeviceStructure() ;
     void writeLoadedXclbinsStructure() ;
@@ -73,6 +104,11 @@ namespace xdp {
 
     virtual bool write(bool openNewFile) ;
     virtual bool isDevice() { return true ; } 
+
+    // Write the device events that happened before the timestamp to
+    //  the binary file.  No-op unless the binary format is used.
+    void streamEvents(double timestamp) ;
+    inline bool isStreaming() { return binaryWriter != nullptr ; }
   } ;
 
 } // end namespace xdp
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc.
+
+// Launch overhead of replaying a captured graph compared with eager
+// stream launches.  Each frame copies an input to the device, launches
+// the nop kernel from vadd-stream a number of times, and copies the
+// output back.  The eager loop enqueues every operation of every
+// frame, the graph loop captures one frame and replays it with
+// hipGraphLaunch.
+//
+// % graph-launch [<kernels per frame>]   (run where nop.co is found)
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr char const *nop_kernel_filename = "nop.co";
+static constexpr char const *nop_kernel_name = "mynop";
+
+static constexpr int vector_length = 0x1000;
+static constexpr int vector_size = vector_length * sizeof(float);
+static constexpr int frames = 1000;
+
+struct frame
+{
+  hipFunction_t function;
+  int kernels;
+  float* host_in;
+  float* host_out;
+  std::array<void*, 3> args;
+
+  void
+  enqueue(hipStream_t stream)
+  {
+    auto dev_a = *static_cast<float**>(args[0]);
+    auto dev_b = *static_cast<float**>(args[1]);
+    xrt_hip_test_common::test_hip_check(hipMemcpyAsync(dev_b, host_in, vector_size, hipMemcpyHostToDevice, stream));
+    for (int k = 0; k < kernels; k++)
+      xrt_hip_test_common::test_hip_check(hipModuleLaunchKernel(function, 1, 1, 1, 1, 1, 1, 0, stream, args.data(), nullptr),
+                                          nop_kernel_name);
+    xrt_hip_test_common::test_hip_check(hipMemcpyAsync(host_out, dev_a, vector_size, hipMemcpyDeviceToHost, stream));
+  }
+};
+
+void
+report(const char* label, long long enqueue_us, long long total_us)
+{
+  const auto msmulti = static_cast<double>(xrt_hip_test_common::hip_test_timer::unit());
+  std::cout << label << " (" << frames << " frames, " << total_us << " us, "
+            << (frames * msmulti) / static_cast<double>(total_us) << " frames/s, "
+            << static_cast<double>(enqueue_us) / frames << " us average launch overhead per frame)" << std::endl;
+}
+
+int
+mainworker(int kernels)
+{
+  xrt_hip_test_common::hip_test_device hdevice;
+  hdevice.show_info(std::cout);
+
+  hipFunction_t function = hdevice.get_function(nop_kernel_filename, nop_kernel_name);
+
+  hipStream_t stream = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+
+  std::vector<float> host_in(vector_length, 1.0f);
+  std::vector<float> host_out(vector_length, 0.0f);
+  xrt_hip_test_common::hip_test_device_bo<float> device_a(vector_length);
+  xrt_hip_test_common::hip_test_device_bo<float> device_b(vector_length);
+  xrt_hip_test_common::hip_test_device_bo<float> device_c(vector_length);
+
+  frame f{function, kernels, host_in.data(), host_out.data(), {&device_a.get(), &device_b.get(), &device_c.get()}};
+
+  std::cout << "---------------------------------------------------------------------------------\n";
+  std::cout << "Frame of 2 copies and " << kernels << " kernel launches" << std::endl;
+
+  // Eager, every operation of every frame is enqueued
+  xrt_hip_test_common::hip_test_timer timer;
+  long long enqueue_us = 0;
+  for (int i = 0; i < frames; i++) {
+    xrt_hip_test_common::hip_test_timer enqueue;
+    f.enqueue(stream);
+    enqueue_us += enqueue.stop();
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  }
+  report("eager ", enqueue_us, timer.stop());
+
+  // Graph, one frame is captured and replayed
+  hipGraph_t graph = nullptr;
+  hipGraphExec_t graph_exec = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamBeginCapture(stream, hipStreamCaptureModeGlobal));
+  f.enqueue(stream);
+  xrt_hip_test_common::test_hip_check(hipStreamEndCapture(stream, &graph));
+  xrt_hip_test_common::test_hip_check(hipGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0));
+
+  timer.reset();
+  enqueue_us = 0;
+  for (int i = 0; i < frames; i++) {
+    xrt_hip_test_common::hip_test_timer enqueue;
+    xrt_hip_test_common::test_hip_check(hipGraphLaunch(graph_exec, stream));
+    enqueue_us += enqueue.stop();
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  }
+  report("graph ", enqueue_us, timer.stop());
+
+  xrt_hip_test_common::test_hip_check(hipGraphExecDestroy(graph_exec));
+  xrt_hip_test_common::test_hip_check(hipGraphDestroy(graph));
+  xrt_hip_test_common::test_hip_check(hipStreamDestroy(stream));
+
+  std::cout << "PASSED TEST" << std::endl;
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return mainworker(argc > 1 ? std::stoi(argv[1]) : 8);
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc.
+
+// Stress of the stream ordered memory pool.  Allocations of random
+// sizes are made with hipMallocAsync and freed in random order with
+// hipFreeAsync across several streams, such that the pool sees a mix
+// of small and large, short and long lived allocations.  Reports the
+// allocation rate and the high watermarks of the default memory pool,
+// the ratio of reserved to peak live memory shows the overhead of
+// fragmentation.
+//
+// % mempool-stress [<iterations>]
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr int streams = 4;
+static constexpr size_t max_live = 64;            // allocations per stream
+static constexpr int sync_interval = 256;         // iterations between synchronizations
+static constexpr size_t page_size = 0x1000;
+
+struct allocation
+{
+  void* ptr;
+  size_t size;
+};
+
+// Mostly small allocations with a tail of large ones
+size_t
+random_size(std::mt19937& gen)
+{
+  std::uniform_int_distribution<int> pick(0, 99);
+  auto p = pick(gen);
+  if (p < 70)
+    return std::uniform_int_distribution<size_t>(1, 16 * page_size)(gen);
+  if (p < 95)
+    return std::uniform_int_distribution<size_t>(16 * page_size, 256 * page_size)(gen);
+  return std::uniform_int_distribution<size_t>(256 * page_size, 4 * xrt_hip_test_common::mega_byte)(gen);
+}
+
+uint64_t
+get_attribute(hipMemPool_t pool, hipMemPoolAttr attr)
+{
+  uint64_t value = 0;
+  xrt_hip_test_common::test_hip_check(hipMemPoolGetAttribute(pool, attr, &value), "hipMemPoolGetAttribute");
+  return value;
+}
+
+int
+mainworker(int iterations)
+{
+  xrt_hip_test_common::hip_test_device hdevice;
+  hdevice.show_info(std::cout);
+
+  hipMemPool_t pool = nullptr;
+  xrt_hip_test_common::test_hip_check(hipDeviceGetDefaultMemPool(&pool, 0), "hipDeviceGetDefaultMemPool");
+
+  std::array<hipStream_t, streams> stream;
+  for (auto& s : stream)
+    xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&s, hipStreamNonBlocking));
+
+  std::mt19937 gen(42);
+  std::array<std::vector<allocation>, streams> live;
+  size_t live_bytes = 0;
+  size_t peak_live_bytes = 0;
+  long long ops = 0;
+
+  xrt_hip_test_common::hip_test_timer timer;
+  for (int i = 0; i < iterations; i++) {
+    auto sidx = static_cast<size_t>(i) % streams;
+    auto& allocs = live[sidx];
+
+    // keep the number of live allocations around half of max_live
+    bool do_alloc = allocs.empty() || (allocs.size() < max_live && std::bernoulli_distribution(0.5)(gen));
+    if (do_alloc) {
+      allocation a{nullptr, random_size(gen)};
+      xrt_hip_test_common::test_hip_check(hipMallocAsync(&a.ptr, a.size, stream[sidx]), "hipMallocAsync");
+      allocs.push_back(a);
+      live_bytes += a.size;
+      peak_live_bytes = std::max(peak_live_bytes, live_bytes);
+    }
+    else {
+      auto idx = std::uniform_int_distribution<size_t>(0, allocs.size() - 1)(gen);
+      xrt_hip_test_common::test_hip_check(hipFreeAsync(allocs[idx].ptr, stream[sidx]), "hipFreeAsync");
+      live_bytes -= allocs[idx].size;
+      allocs[idx] = allocs.back();
+      allocs.pop_back();
+    }
+    ops++;
+
+    if ((i + 1) % sync_interval == 0)
+      xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream[sidx]), "hipStreamSynchronize");
+  }
+
+  for (size_t sidx = 0; sidx < streams; sidx++) {
+    for (auto& a : live[sidx]) {
+      xrt_hip_test_common::test_hip_check(hipFreeAsync(a.ptr, stream[sidx]), "hipFreeAsync");
+      ops++;
+    }
+    live[sidx].clear();
+  }
+  for (auto& s : stream)
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(s), "hipStreamSynchronize");
+  auto us = timer.stop();
+
+  const auto msmulti = static_cast<double>(xrt_hip_test_common::hip_test_timer::unit());
+  auto used_high = get_attribute(pool, hipMemPoolAttrUsedMemHigh);
+  auto reserved_high = get_attribute(pool, hipMemPoolAttrReservedMemHigh);
+  auto used_current = get_attribute(pool, hipMemPoolAttrUsedMemCurrent);
+
+  std::cout << "---------------------------------------------------------------------------------\n";
+  std::cout << "hipMallocAsync/hipFreeAsync on " << streams << " streams (" << ops << " ops, " << us << " us, "
+            << (ops * msmulti) / static_cast<double>(std::max(us, 1LL)) << " ops/s)" << std::endl;
+  std::cout << "peak live bytes    " << peak_live_bytes << std::endl;
+  std::cout << "used mem high      " << used_high << std::endl;
+  std::cout << "reserved mem high  " << reserved_high << " ("
+            << static_cast<double>(reserved_high) / static_cast<double>(std::max<size_t>(peak_live_bytes, 1))
+            << " x peak live)" << std::endl;
+
+  for (auto& s : stream)
+    xrt_hip_test_common::test_hip_check(hipStreamDestroy(s));
+
+  // everything was freed, the high watermark covers at least the peak
+  bool failed = used_current != 0 || used_high < peak_live_bytes;
+  if (failed)
+    std::cout << "FAILED TEST" << std::endl;
+  else
+    std::cout << "PASSED TEST" << std::endl;
+
+  return failed ? 1 : 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return mainworker(argc > 1 ? std::stoi(argv[1]) : 100000);
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Functional test of the experimental run and buffer APIs that have
+// a performance test of their own, checking results rather than
+// measuring time:
+//
+//  - xrt::arg_plan sets the buffer argument written by the kernel
+//  - xrt::bo::async transfers buffer content and validates its range
+//  - xrt::sync of a list of ranges transfers each range
+//  - xrt::start starts and completes a batch of run objects
+//  - xrt::set_wait_policy does not change the result of a wait
+//
+// The noop shim neither executes kernels nor moves data, with the noop
+// shim only run object states and argument validation are checked.
+//
+// % experimental_api -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_bo.h"
+#include "experimental/xrt_kernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: experimental_api [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-b <buffers>] buffers and run objects per test (default: 8)\n";
+}
+
+static constexpr size_t buffer_size = 1024;
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+check(bool cond, const std::string& msg)
+{
+  if (!cond)
+    throw std::runtime_error(msg);
+}
+
+template <typename Function>
+static void
+check_throws(Function&& function, const std::string& msg)
+{
+  try {
+    function();
+  }
+  catch (const std::exception&) {
+    return;
+  }
+  throw std::runtime_error(msg);
+}
+
+static void
+fill(xrt::bo& bo, unsigned int seed)
+{
+  auto data = bo.map<unsigned char*>();
+  for (size_t i = 0; i < bo.size(); ++i)
+    data[i] = static_cast<unsigned char>(i * 13 + seed);
+}
+
+static bool
+is_filled(xrt::bo& bo, size_t offset, size_t size, unsigned int seed)
+{
+  auto data = bo.map<unsigned char*>();
+  for (size_t i = offset; i < offset + size; ++i)
+    if (data[i] != static_cast<unsigned char>(i * 13 + seed))
+      return false;
+  return true;
+}
+
+static void
+clear(xrt::bo& bo)
+{
+  auto data = bo.map<char*>();
+  std::fill(data, data + bo.size(), 0);
+  bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+}
+
+static bool
+is_cleared(xrt::bo& bo)
+{
+  bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  auto data = bo.map<char*>();
+  return std::all_of(data, data + bo.size(), [](char c) { return c == 0; });
+}
+
+static bool
+has_output(xrt::bo& bo)
+{
+  bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  auto data = bo.map<char*>();
+  return std::equal(std::begin(gold), std::end(gold), data);
+}
+
+static void
+wait_completed(xrt::run& run, const std::string& test)
+{
+  check(run.wait() == ERT_CMD_STATE_COMPLETED, test + ": run object did not complete");
+}
+
+// Rebind the output buffer of one run object through an argument
+// plan, only the buffer bound at the time of the start is written
+static void
+test_arg_plan(const xrt::kernel& kernel, std::vector<xrt::bo>& bos)
+{
+  xrt::run run{kernel};
+  run.set_arg(0, bos[0]);
+  xrt::arg_plan plan{run};
+
+  for (size_t i = 0; i < bos.size(); ++i) {
+    for (auto& bo : bos)
+      clear(bo);
+
+    plan.set_arg(0, bos[i]);
+    run.start();
+    wait_completed(run, "arg_plan");
+
+    if (is_noop())
+      continue;
+
+    for (size_t j = 0; j < bos.size(); ++j) {
+      if (j == i)
+        check(has_output(bos[j]), "arg_plan: no kernel output in bound buffer " + std::to_string(j));
+      else
+        check(is_cleared(bos[j]), "arg_plan: kernel output in unbound buffer " + std::to_string(j));
+    }
+  }
+}
+
+// Round trip buffer content with overlapping async operations and
+// check that bad ranges are rejected before anything is queued
+static void
+test_bo_async(std::vector<xrt::bo>& bos)
+{
+  auto& bo = bos[0];
+  check_throws([&bo] { bo.async(XCL_BO_SYNC_BO_TO_DEVICE, bo.size() + 1, 0); },
+               "bo_async: out of range async did not throw");
+  check_throws([&bo] { bo.async(static_cast<xclBOSyncDirection>(42), bo.size(), 0); },
+               "bo_async: async with bad direction did not throw");
+
+  std::vector<xrt::bo::async_handle> handles;
+  for (unsigned int i = 0; i < bos.size(); ++i) {
+    fill(bos[i], i);
+    handles.push_back(bos[i].async(XCL_BO_SYNC_BO_TO_DEVICE));
+  }
+  for (auto& handle : handles)
+    handle.wait();
+  handles.clear();
+
+  for (auto& bo : bos) {
+    auto data = bo.map<char*>();
+    std::fill(data, data + bo.size(), 0);
+  }
+
+  // two halves of the same buffer, completing in order
+  for (auto& bo : bos) {
+    handles.push_back(bo.async(XCL_BO_SYNC_BO_FROM_DEVICE, bo.size() / 2, 0));
+    handles.push_back(bo.async(XCL_BO_SYNC_BO_FROM_DEVICE, bo.size() / 2, bo.size() / 2));
+  }
+  for (auto& handle : handles)
+    handle.wait();
+
+  if (is_noop())
+    return;
+
+  for (unsigned int i = 0; i < bos.size(); ++i)
+    check(is_filled(bos[i], 0, bos[i].size(), i), "bo_async: data mismatch in buffer " + std::to_string(i));
+}
+
+// Sync sub-buffer ranges of one parent buffer as one list, the ranges
+// not in the list must not be transferred
+static void
+test_bo_sync_ranges(xrt::bo& parent, size_t count)
+{
+  auto sub_size = parent.size() / count;
+  std::vector<xrt::bo> subs;
+  for (size_t i = 0; i < count; ++i)
+    subs.emplace_back(parent, sub_size, i * sub_size);
+
+  auto data = parent.map<unsigned char*>();
+  std::fill(data, data + parent.size(), 0);
+  parent.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  fill(parent, 1);
+  std::vector<xrt::bo_sync_range> ranges;
+  for (size_t i = 0; i < count; i += 2)
+    ranges.push_back({subs[i], XCL_BO_SYNC_BO_TO_DEVICE, sub_size, 0});
+  xrt::sync(ranges);
+
+  std::fill(data, data + parent.size(), 0xff);
+  ranges.clear();
+  for (auto& sub : subs)
+    ranges.push_back({sub, XCL_BO_SYNC_BO_FROM_DEVICE, sub_size, 0});
+  xrt::sync(ranges);
+
+  check_throws([&subs, sub_size] { xrt::sync({{subs[0], XCL_BO_SYNC_BO_TO_DEVICE, sub_size + 1, 0}}); },
+               "bo_sync_ranges: out of range sync did not throw");
+
+  if (is_noop())
+    return;
+
+  for (size_t i = 0; i < count; ++i) {
+    auto offset = i * sub_size;
+    if (i % 2 == 0)
+      check(is_filled(parent, offset, sub_size, 1), "bo_sync_ranges: data mismatch in range " + std::to_string(i));
+    else
+      check(std::all_of(data + offset, data + offset + sub_size, [](unsigned char c) { return c == 0; }),
+            "bo_sync_ranges: unsynced range " + std::to_string(i) + " was transferred");
+  }
+}
+
+// Start a batch of run objects, each writing its own buffer
+static void
+test_batch_start(const xrt::kernel& kernel, std::vector<xrt::bo>& bos)
+{
+  std::vector<xrt::run> runs;
+  for (auto& bo : bos) {
+    clear(bo);
+    auto& run = runs.emplace_back(kernel);
+    run.set_arg(0, bo);
+  }
+
+  xrt::start(runs);
+  for (auto& run : runs)
+    wait_completed(run, "batch_start");
+
+  if (is_noop())
+    return;
+
+  for (size_t i = 0; i < bos.size(); ++i)
+    check(has_output(bos[i]), "batch_start: no kernel output in buffer " + std::to_string(i));
+}
+
+// Wait with spinning and yielding policies, the run objects must
+// complete exactly as with the default blocking wait
+static void
+test_wait_policy(const xrt::kernel& kernel, std::vector<xrt::bo>& bos)
+{
+  std::vector<xrt::wait_policy> policies {
+    {std::chrono::microseconds{0}, std::chrono::microseconds{0}},
+    {std::chrono::microseconds{100}, std::chrono::microseconds{0}},
+    {std::chrono::microseconds{0}, std::chrono::microseconds{100}},
+    {std::chrono::microseconds{50}, std::chrono::microseconds{50}}
+  };
+
+  for (auto& policy : policies) {
+    for (auto& bo : bos) {
+      clear(bo);
+      xrt::run run{kernel};
+      run.set_arg(0, bo);
+      xrt::set_wait_policy(run, policy);
+      run.start();
+      wait_completed(run, "wait_policy");
+      check(run.state() == ERT_CMD_STATE_COMPLETED, "wait_policy: bad run state after wait");
+      if (!is_noop())
+        check(has_output(bo), "wait_policy: no kernel output");
+    }
+  }
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int count = 8;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-b")
+      count = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  if (count < 2)
+    throw std::runtime_error("FAILED_TEST\nAt least two buffers are required");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  std::vector<xrt::bo> bos;
+  for (unsigned int i = 0; i < count; ++i)
+    bos.emplace_back(device, buffer_size, kernel.group_id(0));
+
+  test_arg_plan(kernel, bos);
+  test_bo_async(bos);
+  xrt::bo parent(device, buffer_size * count, kernel.group_id(0));
+  test_bo_sync_ranges(parent, count);
+  test_batch_start(kernel, bos);
+  test_wait_policy(kernel, bos);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure ns per set_arg and per set_arg + start + wait for a run
+// object with and without a precompiled argument plan.  Verify that
+// every run completes and, except with the noop shim which does not
+// execute kernels, that the kernel writes the buffer bound last.
+//
+// % XCL_EMULATION_MODE=noop perf_arg_plan -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_kernel.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_arg_plan [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <iterations>] (default: 100000)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+wait_completed(xrt::run& run)
+{
+  if (run.wait() != ERT_CMD_STATE_COMPLETED)
+    throw std::runtime_error("run object did not complete");
+}
+
+// Clear both buffers, bind one with the set_arg function, and check
+// that only the bound buffer is written by the kernel
+template <typename BufferArray, typename Function>
+static void
+verify(xrt::run& run, BufferArray& bos, Function&& set_arg)
+{
+  for (size_t idx = 0; idx < bos.size(); ++idx) {
+    for (auto& bo : bos) {
+      auto data = bo.template map<char*>();
+      std::fill(data, data + bo.size(), 0);
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    }
+
+    set_arg(idx);
+    run.start();
+    wait_completed(run);
+    if (is_noop())
+      continue;
+
+    for (size_t i = 0; i < bos.size(); ++i) {
+      bos[i].sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+      auto data = bos[i].template map<char*>();
+      if (std::equal(std::begin(gold), std::end(gold), data) != (i == idx))
+        throw std::runtime_error("kernel output in wrong buffer");
+    }
+  }
+}
+
+template <typename Function>
+static void
+measure(const std::string& label, unsigned int iterations, Function&& fcn)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    fcn(i);
+  auto end = std::chrono::high_resolution_clock::now();
+  auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << std::setw(24) << label << ": " << std::fixed << std::setprecision(1)
+            << (ns / iterations) << "ns" << std::endl;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 100000;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+  xrt::run run{kernel};
+
+  std::array<xrt::bo, 2> bos = {
+    xrt::bo(device, 20, kernel.group_id(0)),
+    xrt::bo(device, 20, kernel.group_id(0))
+  };
+  run.set_arg(0, bos[0]);
+  xrt::arg_plan plan{run};
+
+  measure("run::set_arg", iterations, [&](unsigned int i) {
+    run.set_arg(0, bos[i % 2]);
+  });
+
+  measure("arg_plan::set_arg", iterations, [&](unsigned int i) {
+    plan.set_arg(0, bos[i % 2]);
+  });
+
+  measure("run::set_arg+start", iterations, [&](unsigned int i) {
+    run.set_arg(0, bos[i % 2]);
+    run.start();
+    wait_completed(run);
+  });
+  verify(run, bos, [&](size_t idx) { run.set_arg(0, bos[idx]); });
+
+  measure("arg_plan::set_arg+start", iterations, [&](unsigned int i) {
+    plan.set_arg(0, bos[i % 2]);
+    run.start();
+    wait_completed(run);
+  });
+  verify(run, bos, [&](size_t idx) { plan.set_arg(0, bos[idx]); });
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Compare launch rate of run objects started one by one with
+// run objects started as a batch using xrt::start().  Verify that
+// all run objects complete and, except with the noop shim which does
+// not execute kernels, that each kernel wrote its output buffer.
+// Also verify that a batch that fails to start leaves no run object
+// started and can be started again.
+//
+// % XCL_EMULATION_MODE=noop perf_batch_start -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_kernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_batch_start [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-b <batch size>] run objects per batch (default: 64)\n"
+            << "  [-n <iterations>] number of batches (default: 10000)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static void
+wait_all(std::vector<xrt::run>& runs)
+{
+  for (auto& run : runs)
+    if (run.wait() != ERT_CMD_STATE_COMPLETED)
+      throw std::runtime_error("run object did not complete");
+}
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+clear_output(std::vector<xrt::bo>& bos)
+{
+  for (auto& bo : bos) {
+    auto data = bo.map<char*>();
+    std::fill(data, data + bo.size(), 0);
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  }
+}
+
+static void
+check_output(std::vector<xrt::bo>& bos)
+{
+  if (is_noop())
+    return;
+
+  for (auto& bo : bos) {
+    bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    auto data = bo.map<char*>();
+    if (!std::equal(std::begin(gold), std::end(gold), data))
+      throw std::runtime_error("bad kernel output");
+  }
+}
+
+// Start a batch in which one run object is already running.  The
+// batch must fail without starting any run object, and it must be
+// possible to start the batch once the running object is done.
+static void
+run_failed_batch(std::vector<xrt::run>& runs, std::vector<xrt::bo>& bos)
+{
+  if (runs.size() < 2)
+    return;
+
+  clear_output(bos);
+  auto& running = runs[runs.size() / 2];
+  running.start();
+  try {
+    xrt::start(runs);
+    throw std::runtime_error("batch with running run object started");
+  }
+  catch (const std::runtime_error&) {
+  }
+
+  if (running.wait() != ERT_CMD_STATE_COMPLETED)
+    throw std::runtime_error("running run object did not complete");
+  for (auto& run : runs) {
+    auto state = run.state();
+    if (state == ERT_CMD_STATE_QUEUED || state == ERT_CMD_STATE_RUNNING)
+      throw std::runtime_error("run object in failed batch was started");
+  }
+
+  clear_output(bos);
+  xrt::start(runs);
+  wait_all(runs);
+  check_output(bos);
+}
+
+static double
+run_single(std::vector<xrt::run>& runs, std::vector<xrt::bo>& bos, unsigned int iterations)
+{
+  clear_output(bos);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i) {
+    for (auto& run : runs)
+      run.start();
+    wait_all(runs);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  check_output(bos);
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static double
+run_batch(std::vector<xrt::run>& runs, std::vector<xrt::bo>& bos, unsigned int iterations)
+{
+  clear_output(bos);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i) {
+    xrt::start(runs);
+    wait_all(runs);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  check_output(bos);
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static void
+report(const std::string& label, double duration, size_t launches)
+{
+  std::cout << std::setw(8) << label
+            << " launches: " << std::setw(9) << launches
+            << " launches/s: " << std::fixed << std::setprecision(0)
+            << (launches * 1000000.0 / duration)
+            << std::endl;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int batch_size = 64;
+  unsigned int iterations = 10000;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-b")
+      batch_size = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  std::vector<xrt::run> runs;
+  std::vector<xrt::bo> bos;
+  for (unsigned int i = 0; i < batch_size; ++i) {
+    auto& run = runs.emplace_back(kernel);
+    auto& bo = bos.emplace_back(device, 1024, kernel.group_id(0));
+    run.set_arg(0, bo);
+  }
+
+  size_t launches = static_cast<size_t>(batch_size) * iterations;
+  report("single", run_single(runs, bos, iterations), launches);
+  report("batch", run_batch(runs, bos, iterations), launches);
+  run_failed_batch(runs, bos);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
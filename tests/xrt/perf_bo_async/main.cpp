@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure overlap of host to device buffer transfers with kernel
+// execution using xrt::bo::async() compared to blocking sync.  Verify
+// that every run completes and, except with the noop shim which does
+// not execute kernels, that each buffer holds the kernel output
+// followed by the zeroed content transferred from the host.
+//
+// % XCL_EMULATION_MODE=noop perf_bo_async -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static void
+usage()
+{
+  std::cout << "usage: perf_bo_async [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <batches>] (default: 1000)\n"
+            << "  [-s <buffer size>] bytes (default: 4194304)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+wait_completed(xrt::run& run)
+{
+  if (run.wait() != ERT_CMD_STATE_COMPLETED)
+    throw std::runtime_error("run object did not complete");
+}
+
+// Clear the buffers on host side only, they are transferred by the
+// measured loop before each run
+static void
+clear_output(std::array<xrt::bo, 2>& bos)
+{
+  for (auto& bo : bos)
+    std::memset(bo.map(), 0, bo.size());
+}
+
+static void
+check_output(std::array<xrt::bo, 2>& bos, unsigned int batches)
+{
+  if (is_noop())
+    return;
+
+  for (unsigned int i = 0; i < std::min<unsigned int>(batches, 2); ++i) {
+    auto& bo = bos[i];
+    bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    auto data = bo.map<char*>();
+    if (!std::equal(std::begin(gold), std::end(gold), data))
+      throw std::runtime_error("bad kernel output");
+    if (!std::all_of(data + sizeof(gold), data + bo.size(), [](char c) { return c == 0; }))
+      throw std::runtime_error("bad buffer content");
+  }
+}
+
+static void
+report(const std::string& label, unsigned int batches, std::chrono::high_resolution_clock::duration elapsed)
+{
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  std::cout << std::setw(10) << label << ": " << batches << " batches in "
+            << us << "us (" << std::fixed << std::setprecision(1)
+            << (batches * 1000000.0 / us) << " batches/s)" << std::endl;
+}
+
+// Each batch syncs its input and then runs the kernel
+static void
+serial(xrt::run& run, std::array<xrt::bo, 2>& bos, unsigned int batches)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < batches; ++i) {
+    auto& bo = bos[i % 2];
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    run.set_arg(0, bo);
+    run.start();
+    wait_completed(run);
+  }
+  report("serial", batches, std::chrono::high_resolution_clock::now() - start);
+}
+
+// The input for batch N+1 is transferred while batch N executes
+static void
+pipelined(xrt::run& run, std::array<xrt::bo, 2>& bos, unsigned int batches)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  auto next = bos[0].async(XCL_BO_SYNC_BO_TO_DEVICE);
+  for (unsigned int i = 0; i < batches; ++i) {
+    if (next.wait(1000ms) == std::cv_status::timeout)
+      throw std::runtime_error("async transfer timed out");
+
+    run.set_arg(0, bos[i % 2]);
+    run.start();
+    if (i + 1 < batches)
+      next = bos[(i + 1) % 2].async(XCL_BO_SYNC_BO_TO_DEVICE);
+    wait_completed(run);
+  }
+  report("pipelined", batches, std::chrono::high_resolution_clock::now() - start);
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int batches = 1000;
+  size_t size = 4194304;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      batches = std::stoi(arg);
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+  xrt::run run{kernel};
+
+  std::array<xrt::bo, 2> bos = {
+    xrt::bo(device, size, kernel.group_id(0)),
+    xrt::bo(device, size, kernel.group_id(0))
+  };
+  if (size < sizeof(gold))
+    throw std::runtime_error("FAILED_TEST\nBuffer size must be at least " + std::to_string(sizeof(gold)));
+
+  clear_output(bos);
+  serial(run, bos, batches);
+  check_output(bos, batches);
+
+  clear_output(bos);
+  pipelined(run, bos, batches);
+  check_output(bos, batches);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure sync of many small sub-buffers one at a time compared to
+// one batched sync of all sub-buffer ranges.
+//
+// Before measuring, verify buffer contents after batched sync of
+// adjacent and overlapping ranges in both directions.  The noop shim
+// does not move data, so the check is skipped with noop.
+//
+// % XCL_EMULATION_MODE=noop perf_bo_sync_batch -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_bo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_bo_sync_batch [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <iterations>] (default: 10000)\n"
+            << "  [-b <sub-buffers>] (default: 40)\n"
+            << "  [-s <sub-buffer size>] bytes (default: 4096)\n";
+}
+
+static void
+report(const std::string& label, unsigned int iterations, std::chrono::high_resolution_clock::duration elapsed)
+{
+  auto us = std::chrono::duration<double, std::micro>(elapsed).count();
+  std::cout << std::setw(10) << label << ": " << std::fixed << std::setprecision(2)
+            << (us / iterations) << "us per request" << std::endl;
+}
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static unsigned char
+pattern(size_t idx, unsigned char seed)
+{
+  return static_cast<unsigned char>(idx * 31 + seed);
+}
+
+static void
+fill(xrt::bo& bo, unsigned char seed)
+{
+  auto data = bo.map<unsigned char*>();
+  for (size_t i = 0; i < bo.size(); ++i)
+    data[i] = pattern(i, seed);
+}
+
+static void
+check(xrt::bo& bo, const std::vector<bool>& covered, unsigned char in, unsigned char out, bool out_zero)
+{
+  auto data = bo.map<unsigned char*>();
+  for (size_t i = 0; i < bo.size(); ++i) {
+    auto expect = covered[i] ? pattern(i, in) : (out_zero ? 0 : pattern(i, out));
+    if (data[i] != expect)
+      throw std::runtime_error("FAILED_TEST\nData mismatch at offset " + std::to_string(i));
+  }
+}
+
+// Sync adjacent and overlapping ranges of sub-buffers and of the
+// parent buffer, then check that exactly the covered bytes moved.
+static void
+verify(xrt::bo& parent, std::vector<xrt::bo>& bos, size_t sub_size)
+{
+  if (is_noop() || bos.size() < 4 || sub_size < 16)
+    return;
+
+  auto s = sub_size;
+  struct range { xrt::bo* bo; size_t base; size_t size; size_t offset; };
+  std::vector<range> spec {
+    {&bos[0], 0, s, 0},                 // sub-buffers 0 and 1 are adjacent
+    {&bos[1], s, s, 0},
+    {&bos[2], 2 * s, s / 2, s / 2},     // overlaps next parent range
+    {&parent, 0, s / 2, 2 * s + s / 4},
+    {&bos[3], 3 * s, s / 4, 0},         // adjacent within sub-buffer 3
+    {&bos[3], 3 * s, s / 4, s / 4},
+    {&bos[3], 3 * s, s / 4, s / 8},     // contained in the two above
+  };
+
+  std::vector<bool> covered(parent.size(), false);
+  for (const auto& r : spec)
+    std::fill_n(covered.begin() + r.base + r.offset, r.size, true);
+
+  auto ranges = [&spec](xclBOSyncDirection dir) {
+    std::vector<xrt::bo_sync_range> v;
+    for (const auto& r : spec)
+      v.push_back({*r.bo, dir, r.size, r.offset});
+    return v;
+  };
+
+  // Device holds pattern 1, then covered ranges are updated to pattern 2
+  fill(parent, 1);
+  parent.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  fill(parent, 2);
+  xrt::sync(ranges(XCL_BO_SYNC_BO_TO_DEVICE));
+
+  // Read back everything to check the batched sync to device
+  std::fill_n(parent.map<unsigned char*>(), parent.size(), 0);
+  parent.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  check(parent, covered, 2, 1, false);
+
+  // Read back only the covered ranges to check the batched sync
+  // from device
+  std::fill_n(parent.map<unsigned char*>(), parent.size(), 0);
+  xrt::sync(ranges(XCL_BO_SYNC_BO_FROM_DEVICE));
+  check(parent, covered, 2, 0, true);
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 10000;
+  size_t subs = 40;
+  size_t sub_size = 4096;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else if (cur == "-b")
+      subs = std::stoul(arg);
+    else if (cur == "-s")
+      sub_size = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  xrt::bo parent(device, subs * sub_size, kernel.group_id(0));
+  std::vector<xrt::bo> bos;
+  std::vector<xrt::bo_sync_range> ranges;
+  for (size_t i = 0; i < subs; ++i) {
+    bos.emplace_back(parent, sub_size, i * sub_size);
+    ranges.push_back({bos.back(), XCL_BO_SYNC_BO_TO_DEVICE, sub_size, 0});
+  }
+
+  verify(parent, bos, sub_size);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    for (auto& bo : bos)
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  report("individual", iterations, std::chrono::high_resolution_clock::now() - start);
+
+  start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    xrt::sync(ranges);
+  report("batched", iterations, std::chrono::high_resolution_clock::now() - start);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
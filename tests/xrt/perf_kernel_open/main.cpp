@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure time to construct an xclbin, a hardware context, and all
+// kernels in the xclbin.  The first iteration parses the xclbin meta
+// data, subsequent iterations are served from the parsed meta data.
+// Verify that every iteration opens all kernels with the same argument
+// layout as the xclbin meta data.
+//
+// % XCL_EMULATION_MODE=noop perf_kernel_open -k verify.xclbin
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_hw_context.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_xclbin.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_kernel_open [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <iterations>] (default: 100)\n";
+}
+
+static void
+report(const std::string& label, unsigned int iterations, std::chrono::high_resolution_clock::duration elapsed)
+{
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  std::cout << std::setw(6) << label << ": " << iterations << " iterations, "
+            << std::fixed << std::setprecision(1)
+            << (iterations ? static_cast<double>(us) / iterations : 0.0) << "us/iteration" << std::endl;
+}
+
+// Construct xclbin, hardware context, and all kernels.  Returns the
+// name and argument offsets of each kernel as seen by xrt::kernel.
+static std::vector<std::string>
+open_kernels(xrt::device& device, const std::string& xclbin_fnm)
+{
+  xrt::xclbin xclbin{xclbin_fnm};
+  auto uuid = device.register_xclbin(xclbin);
+  xrt::hw_context hwctx{device, uuid};
+
+  std::vector<xrt::kernel> kernels;
+  std::vector<std::string> signatures;
+  for (const auto& xkernel : xclbin.get_kernels()) {
+    auto& kernel = kernels.emplace_back(hwctx, xkernel.get_name());
+    if (kernel.get_name() != xkernel.get_name())
+      throw std::runtime_error("kernel name mismatch for '" + xkernel.get_name() + "'");
+
+    auto signature = kernel.get_name();
+    for (int argno = 0; argno < static_cast<int>(xkernel.get_num_args()); ++argno)
+      signature.append(":").append(std::to_string(kernel.offset(argno)));
+    signatures.push_back(std::move(signature));
+  }
+
+  return signatures;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 100;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  if (iterations < 2)
+    throw std::runtime_error("FAILED_TEST\nAt least 2 iterations required");
+
+  xrt::device device{device_index};
+
+  auto start = std::chrono::high_resolution_clock::now();
+  auto cold = open_kernels(device, xclbin_fnm);
+  report("cold", 1, std::chrono::high_resolution_clock::now() - start);
+
+  if (cold.empty())
+    throw std::runtime_error("no kernels in xclbin");
+
+  size_t mismatches = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 1; i < iterations; ++i)
+    mismatches += (open_kernels(device, xclbin_fnm) != cold);
+  report("warm", iterations - 1, std::chrono::high_resolution_clock::now() - start);
+
+  if (mismatches)
+    throw std::runtime_error("kernel meta data differs in " + std::to_string(mismatches) + " warm iterations");
+
+  std::cout << "kernels per iteration: " << cold.size() << std::endl;
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
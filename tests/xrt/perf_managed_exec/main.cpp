@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure managed command execution throughput (commands with
+// completion callbacks) as a function of the number of threads
+// submitting commands concurrently.  Verify that every command
+// completes exactly once and, except with the noop shim which does not
+// execute kernels, that each kernel wrote its output buffer.
+//
+// % XCL_EMULATION_MODE=noop perf_managed_exec -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_managed_exec [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-t <threads>] max number of submitting threads (default: 16)\n"
+            << "  [-n <cmds>] commands per thread (default: 100000)\n"
+            << "  [-q <depth>] runs in flight per thread (default: 32)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+// Per thread command slots.  Each slot is restarted from the
+// submitting thread when the completion callback has fired.
+struct worker
+{
+  std::vector<xrt::run> runs;
+  std::vector<xrt::bo> bos;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::vector<xrt::run*> done;
+  std::atomic<unsigned int> completed {0};
+  std::atomic<unsigned int> failed {0};
+
+  static void
+  on_complete(const void*, ert_cmd_state state, void* data)
+  {
+    auto slot = static_cast<std::pair<worker*, xrt::run*>*>(data);
+    auto self = slot->first;
+    {
+      std::lock_guard lk(self->mutex);
+      self->done.push_back(slot->second);
+      ++self->completed;
+      if (state != ERT_CMD_STATE_COMPLETED)
+        ++self->failed;
+    }
+    self->cond.notify_one();
+  }
+
+  worker(const xrt::device& device, const xrt::kernel& kernel, unsigned int depth)
+    : slots(depth)
+  {
+    runs.reserve(depth);
+    bos.reserve(depth);
+    for (unsigned int i = 0; i < depth; ++i) {
+      auto& run = runs.emplace_back(kernel);
+      run.set_arg(0, bos.emplace_back(device, 1024, kernel.group_id(0)));
+      slots[i] = {this, &run};
+      run.add_callback(ERT_CMD_STATE_COMPLETED, on_complete, &slots[i]);
+    }
+  }
+
+  void
+  execute(unsigned int total)
+  {
+    unsigned int issued = 0;
+    completed = 0;
+    failed = 0;
+    done.clear();
+    for (auto& run : runs) {
+      if (issued == total)
+        break;
+      run.start();
+      ++issued;
+    }
+
+    std::vector<xrt::run*> restart;
+    while (completed < total) {
+      {
+        std::unique_lock lk(mutex);
+        cond.wait(lk, [this] { return !done.empty(); });
+        restart.swap(done);
+      }
+      for (auto run : restart) {
+        if (issued < total) {
+          run->start();
+          ++issued;
+        }
+      }
+      restart.clear();
+    }
+  }
+
+  void
+  clear_output()
+  {
+    for (auto& bo : bos) {
+      auto data = bo.map<char*>();
+      std::fill(data, data + bo.size(), 0);
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    }
+  }
+
+  // Check the outcome of execute(total) once all threads are joined
+  void
+  check(unsigned int total)
+  {
+    if (completed != total)
+      throw std::runtime_error("completed " + std::to_string(completed) + " of " + std::to_string(total) + " commands");
+    if (failed)
+      throw std::runtime_error(std::to_string(failed) + " commands did not complete successfully");
+    for (auto& run : runs)
+      if (run.state() != ERT_CMD_STATE_COMPLETED && run.state() != ERT_CMD_STATE_NEW)
+        throw std::runtime_error("run object in unexpected state");
+
+    if (is_noop())
+      return;
+
+    // runs beyond total were never started
+    for (size_t i = 0; i < std::min<size_t>(bos.size(), total); ++i) {
+      bos[i].sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+      auto data = bos[i].map<char*>();
+      if (!std::equal(std::begin(gold), std::end(gold), data))
+        throw std::runtime_error("bad kernel output");
+    }
+  }
+
+private:
+  std::vector<std::pair<worker*, xrt::run*>> slots;
+};
+
+static double
+run_test(std::vector<std::unique_ptr<worker>>& workers, unsigned int threads, unsigned int cmds)
+{
+  for (unsigned int t = 0; t < threads; ++t)
+    workers[t]->clear_output();
+
+  std::vector<std::thread> pool;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int t = 0; t < threads; ++t)
+    pool.emplace_back([&workers, t, cmds] { workers[t]->execute(cmds); });
+  for (auto& t : pool)
+    t.join();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  for (unsigned int t = 0; t < threads; ++t)
+    workers[t]->check(cmds);
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int max_threads = 16;
+  unsigned int cmds = 100000;
+  unsigned int depth = 32;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-t")
+      max_threads = std::stoi(arg);
+    else if (cur == "-n")
+      cmds = std::stoi(arg);
+    else if (cur == "-q")
+      depth = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  std::vector<std::unique_ptr<worker>> workers;
+  for (unsigned int t = 0; t < max_threads; ++t)
+    workers.emplace_back(std::make_unique<worker>(device, kernel, depth));
+
+  for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+    auto duration = run_test(workers, threads, cmds);
+    auto total = static_cast<double>(threads) * cmds;
+    std::cout << "threads: " << std::setw(3) << threads
+              << " commands: " << std::setw(9) << static_cast<uint64_t>(total)
+              << " cmds/s: " << std::fixed << std::setprecision(0)
+              << (total * 1000000.0 / duration)
+              << std::endl;
+  }
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
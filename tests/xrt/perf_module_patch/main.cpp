@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure throughput of patching buffer arguments into the control
+// code of an ELF module.  Each set_arg() of a run constructed from a
+// module patches every relocation of the argument in the control code.
+// Verify that the run completes with the control code patched by the
+// first set_arg() and again with the control code patched last.
+//
+// % perf_module_patch -k design.xclbin -e design.elf -a 3
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_hw_context.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_elf.h"
+#include "experimental/xrt_ext.h"
+#include "experimental/xrt_module.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_module_patch [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  -e <elf>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <kernel name>] (default: DPU)\n"
+            << "  [-a <buffer arguments>] (default: 3)\n"
+            << "  [-i <iterations>] (default: 10000)\n"
+            << "  [-s <buffer size>] bytes (default: 4096)\n";
+}
+
+static void
+start_and_wait(xrt::run& run, const std::string& label)
+{
+  run.start();
+  if (run.wait() != ERT_CMD_STATE_COMPLETED)
+    throw std::runtime_error("run with " + label + " patched arguments did not complete");
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  std::string elf_fnm;
+  std::string kernel_name = "DPU";
+  unsigned int device_index = 0;
+  unsigned int nargs = 3;
+  unsigned int iterations = 10000;
+  size_t size = 4096;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-e")
+      elf_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      kernel_name = arg;
+    else if (cur == "-a")
+      nargs = std::stoi(arg);
+    else if (cur == "-i")
+      iterations = std::stoi(arg);
+    else if (cur == "-s")
+      size = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty() || elf_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin or elf specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.register_xclbin(xrt::xclbin{xclbin_fnm});
+  xrt::hw_context hwctx{device, uuid};
+
+  xrt::elf elf{elf_fnm};
+  xrt::module mod{elf};
+  xrt::ext::kernel kernel{hwctx, mod, kernel_name};
+  xrt::run run{kernel};
+
+  // Two buffers per argument, alternated such that every set_arg
+  // changes the patched address.
+  std::vector<xrt::bo> bos;
+  for (unsigned int i = 0; i < 2 * nargs; ++i)
+    bos.emplace_back(xrt::ext::bo{hwctx, size});
+
+  // First patch of each argument resolves its patchers
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int arg = 0; arg < nargs; ++arg)
+    run.set_arg(arg, bos[arg]);
+  auto first = std::chrono::high_resolution_clock::now() - start;
+  start_and_wait(run, "first");
+
+  start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    for (unsigned int arg = 0; arg < nargs; ++arg)
+      run.set_arg(arg, bos[(i % 2) * nargs + arg]);
+  auto elapsed = std::chrono::high_resolution_clock::now() - start;
+  start_and_wait(run, "repeatedly");
+
+  auto first_us = std::chrono::duration_cast<std::chrono::microseconds>(first).count();
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  auto patches = static_cast<double>(iterations) * nargs;
+  std::cout << std::fixed << std::setprecision(1)
+            << "first patch of " << nargs << " arguments: " << first_us << "us\n"
+            << "patched " << patches << " arguments in " << us << "us ("
+            << (us ? patches * 1000000.0 / us : 0.0) << " patches/s)" << std::endl;
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
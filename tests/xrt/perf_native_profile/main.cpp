@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure per call overhead of native API profiling.  Compare runs
+// with and without Debug.native_xrt_trace in xrt.ini.  With tracing
+// each call records two host events, the test reports the event
+// ingest rate and the resident memory growth per event.  Verify that
+// profiling does not change the result of the profiled call.
+//
+// % XCL_EMULATION_MODE=noop perf_native_profile -k verify.xclbin
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_native_profile [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <calls>] per thread (default: 1000000)\n"
+            << "  [-t <threads>] (default: 1)\n";
+}
+
+#ifdef __linux__
+# include <unistd.h>
+#endif
+
+// Resident set size in bytes, 0 if not available
+static size_t
+resident_bytes()
+{
+#ifdef __linux__
+  std::ifstream statm{"/proc/self/statm"};
+  size_t size = 0, resident = 0;
+  if (statm >> size >> resident)
+    return resident * sysconf(_SC_PAGESIZE);
+#endif
+  return 0;
+}
+
+// Count the calls that do not return the expected group id
+static void
+calls(const xrt::kernel& kernel, unsigned int num, int expected, unsigned int& mismatches)
+{
+  unsigned int count = 0;
+  for (unsigned int i = 0; i < num; ++i)
+    count += (kernel.group_id(0) != expected);
+  mismatches = count;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int num = 1000000;
+  unsigned int num_threads = 1;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      num = std::stoi(arg);
+    else if (cur == "-t")
+      num_threads = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  auto expected = kernel.group_id(0);
+  if (expected < 0)
+    throw std::runtime_error("unexpected group id");
+
+  auto rss = resident_bytes();
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  std::vector<unsigned int> mismatches(num_threads, 0);
+  for (unsigned int t = 0; t < num_threads; ++t)
+    threads.emplace_back(calls, std::cref(kernel), num, expected, std::ref(mismatches[t]));
+  for (auto& t : threads)
+    t.join();
+  auto elapsed = std::chrono::high_resolution_clock::now() - start;
+
+  for (auto count : mismatches)
+    if (count)
+      throw std::runtime_error(std::to_string(count) + " calls returned a wrong group id");
+
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  auto total = static_cast<double>(num) * num_threads;
+  std::cout << num_threads << " threads, " << total << " calls in "
+            << (ns / 1000) << "us (" << std::fixed << std::setprecision(1)
+            << (ns * num_threads / total) << "ns/call)" << std::endl;
+
+  // Each traced call records a start and an end event
+  auto events = total * 2;
+  auto growth = static_cast<double>(resident_bytes()) - static_cast<double>(rss);
+  std::cout << "events: " << (events * 1e9 / ns) << " events/s, "
+            << (growth / events) << " bytes/event" << std::endl;
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure runlist iterations per second for serial and pipelined
+// re-execution of a runlist.  Every iteration must complete, which
+// xrt::runlist::wait() verifies, and except with the noop shim which
+// does not execute kernels, each run object must write its buffer.
+//
+// % XCL_EMULATION_MODE=noop perf_runlist -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_hw_context.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_kernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_runlist [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <iterations>] (default: 1000)\n"
+            << "  [-r <runs>] run objects in runlist (default: 300)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+clear_output(std::vector<xrt::bo>& bos)
+{
+  for (auto& bo : bos) {
+    auto data = bo.map<char*>();
+    std::fill(data, data + bo.size(), 0);
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  }
+}
+
+static void
+check_output(std::vector<xrt::bo>& bos)
+{
+  if (is_noop())
+    return;
+
+  for (auto& bo : bos) {
+    bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    auto data = bo.map<char*>();
+    if (!std::equal(std::begin(gold), std::end(gold), data))
+      throw std::runtime_error("bad kernel output");
+  }
+}
+
+static void
+report(const std::string& label, unsigned int iterations, std::chrono::high_resolution_clock::duration elapsed)
+{
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  std::cout << std::setw(10) << label << ": " << iterations << " iterations in "
+            << us << "us (" << std::fixed << std::setprecision(1)
+            << (iterations * 1000000.0 / us) << " iterations/s)" << std::endl;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 1000;
+  unsigned int runs = 300;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else if (cur == "-r")
+      runs = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.register_xclbin(xrt::xclbin{xclbin_fnm});
+  xrt::hw_context hwctx{device, uuid};
+  xrt::kernel kernel{hwctx, "hello"};
+
+  std::vector<xrt::bo> bos;
+  xrt::runlist runlist{hwctx};
+  for (unsigned int i = 0; i < runs; ++i) {
+    xrt::run run{kernel};
+    run.set_arg(0, bos.emplace_back(device, 1024, kernel.group_id(0)));
+    runlist.add(run);
+  }
+
+  clear_output(bos);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i) {
+    runlist.execute();
+    runlist.wait();
+  }
+  report("serial", iterations, std::chrono::high_resolution_clock::now() - start);
+  check_output(bos);
+
+  clear_output(bos);
+  start = std::chrono::high_resolution_clock::now();
+  runlist.execute(iterations);
+  runlist.wait();
+  report("pipelined", iterations, std::chrono::high_resolution_clock::now() - start);
+  check_output(bos);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure xrt::bo::sync() bandwidth in software emulation.  Compare
+// runs with and without Emulation.shared_device_memory=true in
+// xrt.ini.
+//
+// % XCL_EMULATION_MODE=sw_emu perf_swemu_sync -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_swemu_sync [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <iterations>] (default: 10)\n"
+            << "  [-s <max buffer size>] bytes (default: 1GB)\n";
+}
+
+static double
+bandwidth_mbps(size_t bytes, unsigned int iterations, std::chrono::high_resolution_clock::duration elapsed)
+{
+  auto sec = std::chrono::duration<double>(elapsed).count();
+  return (static_cast<double>(bytes) * iterations) / (sec * 1024 * 1024);
+}
+
+static void
+report(size_t size, double to_device, double from_device)
+{
+  std::cout << std::setw(12) << size << " bytes: " << std::fixed << std::setprecision(2)
+            << std::setw(10) << to_device << " MB/s to device, "
+            << std::setw(10) << from_device << " MB/s from device" << std::endl;
+}
+
+static bool
+verify(xrt::bo& bo, size_t size)
+{
+  auto data = bo.map<unsigned char*>();
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<unsigned char>(i * 13);
+  bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, size, 0);
+
+  std::fill(data, data + size, 0);
+  bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE, size, 0);
+  for (size_t i = 0; i < size; ++i)
+    if (data[i] != static_cast<unsigned char>(i * 13))
+      return false;
+  return true;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 10;
+  size_t max_size = 1ull << 30;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else if (cur == "-s")
+      max_size = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  for (size_t size = 4096; size <= max_size; size *= 16) {
+    xrt::bo bo(device, size, kernel.group_id(0));
+    if (!verify(bo, size))
+      throw std::runtime_error("FAILED_TEST\nData mismatch for " + std::to_string(size) + " bytes");
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < iterations; ++i)
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    auto to_device = bandwidth_mbps(size, iterations, std::chrono::high_resolution_clock::now() - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < iterations; ++i)
+      bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    auto from_device = bandwidth_mbps(size, iterations, std::chrono::high_resolution_clock::now() - start);
+
+    report(size, to_device, from_device);
+  }
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure p50/p99 start-to-wait-return latency of a run object for
+// blocking and spinning wait policies.  Verify that wait() returns
+// only when the run has completed and, except with the noop shim which
+// does not execute kernels, that the kernel wrote its output buffer.
+//
+// % XCL_EMULATION_MODE=noop perf_wait_latency -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_kernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static void
+usage()
+{
+  std::cout << "usage: perf_wait_latency [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-n <iterations>] (default: 10000)\n"
+            << "  [-s <spin us>] spin period (default: 50)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+measure(const std::string& label, xrt::run& run, xrt::bo& bo, const xrt::wait_policy& policy, unsigned int iterations)
+{
+  xrt::set_wait_policy(run, policy);
+
+  auto data = bo.map<char*>();
+  std::fill(data, data + bo.size(), 0);
+  bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  std::vector<double> latency;
+  latency.reserve(iterations);
+  for (unsigned int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::high_resolution_clock::now();
+    run.start();
+    auto state = run.wait();
+    auto end = std::chrono::high_resolution_clock::now();
+    if (state != ERT_CMD_STATE_COMPLETED || run.state() != ERT_CMD_STATE_COMPLETED)
+      throw std::runtime_error(label + ": wait returned before run completed");
+    latency.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+
+  if (!is_noop()) {
+    bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    if (!std::equal(std::begin(gold), std::end(gold), data))
+      throw std::runtime_error(label + ": bad kernel output");
+  }
+
+  std::sort(latency.begin(), latency.end());
+  auto p50 = latency[latency.size() / 2];
+  auto p99 = latency[latency.size() * 99 / 100];
+  std::cout << std::setw(16) << label << std::fixed << std::setprecision(1)
+            << " p50: " << std::setw(8) << p50 << "us"
+            << " p99: " << std::setw(8) << p99 << "us"
+            << std::endl;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 10000;
+  unsigned int spin_us = 50;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else if (cur == "-s")
+      spin_us = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+  xrt::run run{kernel};
+  xrt::bo bo(device, 1024, kernel.group_id(0));
+  run.set_arg(0, bo);
+
+  std::chrono::microseconds spin{spin_us};
+  measure("block", run, bo, {0us, 0us}, iterations);
+  measure("spin", run, bo, {spin, 0us}, iterations);
+  measure("spin+yield", run, bo, {spin / 2, spin / 2}, iterations);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure CPU time per completion as the number of threads, each
+// waiting on its own run object, grows.  Verify that every wait
+// returns a completed run and, except with the noop shim which does
+// not execute kernels, that each kernel wrote its output buffer.
+//
+// % XCL_EMULATION_MODE=noop perf_wait_scaling -k verify.xclbin
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void
+usage()
+{
+  std::cout << "usage: perf_wait_scaling [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-d <device>] (default: 0)\n"
+            << "  [-t <threads>] max number of waiting threads (default: 64)\n"
+            << "  [-n <runs>] runs per thread (default: 2000)\n";
+}
+
+static constexpr char gold[] = "Hello World\n";
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::strcmp(mode, "noop") == 0;
+}
+
+static void
+run_test(std::vector<xrt::run>& runs, std::vector<xrt::bo>& bos, unsigned int threads, unsigned int iterations)
+{
+  for (unsigned int t = 0; t < threads; ++t) {
+    auto data = bos[t].map<char*>();
+    std::fill(data, data + bos[t].size(), 0);
+    bos[t].sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  }
+
+  // Count waits per thread that did not return a completed run
+  std::vector<unsigned int> failures(threads, 0);
+  std::vector<std::thread> pool;
+  auto wall_start = std::chrono::high_resolution_clock::now();
+  auto cpu_start = std::clock();
+
+  for (unsigned int t = 0; t < threads; ++t)
+    pool.emplace_back([&run = runs[t], &failed = failures[t], iterations] {
+      for (unsigned int i = 0; i < iterations; ++i) {
+        run.start();
+        failed += (run.wait() != ERT_CMD_STATE_COMPLETED);
+      }
+    });
+  for (auto& t : pool)
+    t.join();
+
+  auto cpu_end = std::clock();
+  auto wall_end = std::chrono::high_resolution_clock::now();
+
+  for (unsigned int t = 0; t < threads; ++t) {
+    if (failures[t])
+      throw std::runtime_error(std::to_string(failures[t]) + " runs did not complete");
+    if (is_noop())
+      continue;
+    bos[t].sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    if (!std::equal(std::begin(gold), std::end(gold), bos[t].map<char*>()))
+      throw std::runtime_error("bad kernel output");
+  }
+
+  auto completions = static_cast<double>(threads) * iterations;
+  auto wall_us = std::chrono::duration<double, std::micro>(wall_end - wall_start).count();
+  auto cpu_us = (cpu_end - cpu_start) * 1000000.0 / CLOCKS_PER_SEC;
+  std::cout << "waiters: " << std::setw(3) << threads << std::fixed << std::setprecision(1)
+            << " completions/s: " << std::setw(10) << (completions * 1000000.0 / wall_us)
+            << " cpu us/completion: " << std::setw(6) << (cpu_us / completions)
+            << std::endl;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int max_threads = 64;
+  unsigned int iterations = 2000;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-t")
+      max_threads = std::stoi(arg);
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel kernel{device, uuid, "hello"};
+
+  std::vector<xrt::run> runs;
+  std::vector<xrt::bo> bos;
+  for (unsigned int t = 0; t < max_threads; ++t) {
+    auto& run = runs.emplace_back(kernel);
+    run.set_arg(0, bos.emplace_back(device, 1024, kernel.group_id(0)));
+  }
+
+  for (unsigned int threads = 1; threads <= max_threads; threads *= 2)
+    run_test(runs, bos, threads, iterations);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure construction time and resident memory of xrt::xclbin from
+// a file.  Compare runs with and without Runtime.xclbin_mmap=true
+// in xrt.ini.  Verify that the constructed xclbin matches the file
+// content and meta data of an xclbin constructed from the raw bytes.
+//
+// % perf_xclbin_load -k verify.xclbin
+#include "experimental/xrt_xclbin.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+# include <unistd.h>
+#endif
+
+static void
+usage()
+{
+  std::cout << "usage: perf_xclbin_load [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-n <iterations>] (default: 100)\n";
+}
+
+// Resident set size in bytes, 0 if not available
+static size_t
+resident_bytes()
+{
+#ifdef __linux__
+  std::ifstream statm{"/proc/self/statm"};
+  size_t size = 0, resident = 0;
+  if (statm >> size >> resident)
+    return resident * sysconf(_SC_PAGESIZE);
+#endif
+  return 0;
+}
+
+static std::vector<char>
+read_file(const std::string& fnm)
+{
+  std::ifstream stream{fnm, std::ios::binary};
+  if (!stream)
+    throw std::runtime_error("Failed to open '" + fnm + "'");
+  return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+// Compare an xclbin constructed from file with the raw file content
+// and with an xclbin constructed from the raw file content
+static void
+verify(const xrt::xclbin& xclbin, const std::vector<char>& data)
+{
+  auto top = xclbin.get_axlf();
+  if (top->m_header.m_length != data.size()
+      || std::memcmp(top, data.data(), data.size()) != 0)
+    throw std::runtime_error("xclbin content does not match file");
+
+  xrt::xclbin reference{data};
+  if (xclbin.get_uuid() != reference.get_uuid()
+      || xclbin.get_kernels().size() != reference.get_kernels().size()
+      || xclbin.get_mems().size() != reference.get_mems().size()
+      || xclbin.get_ips().size() != reference.get_ips().size())
+    throw std::runtime_error("xclbin meta data does not match file");
+}
+
+static double
+elapsed_us(std::chrono::high_resolution_clock::time_point start)
+{
+  auto elapsed = std::chrono::high_resolution_clock::now() - start;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / 1000.0;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int iterations = 100;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-n")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  if (iterations == 0)
+    throw std::runtime_error("FAILED_TEST\nNo iterations");
+
+  // Resident memory of one live xclbin object
+  auto rss_before = resident_bytes();
+  auto start = std::chrono::high_resolution_clock::now();
+  xrt::xclbin xclbin{xclbin_fnm};
+  auto first_us = elapsed_us(start);
+  auto rss_after = resident_bytes();
+
+  // Accessing the metadata touches the sections
+  start = std::chrono::high_resolution_clock::now();
+  auto num_kernels = xclbin.get_kernels().size();
+  auto num_mems = xclbin.get_mems().size();
+  auto num_ips = xclbin.get_ips().size();
+  auto access_us = elapsed_us(start);
+  auto rss_access = resident_bytes();
+
+  size_t mismatches = 0;
+  auto uuid = xclbin.get_uuid();
+  start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    mismatches += (xrt::xclbin{xclbin_fnm}.get_uuid() != uuid);
+  auto avg_us = elapsed_us(start) / iterations;
+
+  if (mismatches)
+    throw std::runtime_error("xclbin uuid differs in " + std::to_string(mismatches) + " iterations");
+  verify(xclbin, read_file(xclbin_fnm));
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "xclbin: " << xclbin_fnm << " (" << xclbin.get_axlf()->m_header.m_length << " bytes, "
+            << num_kernels << " kernels, " << num_mems << " mems, " << num_ips << " ips)\n"
+            << "first construction: " << first_us << "us\n"
+            << "average construction: " << avg_us << "us over " << iterations << " iterations\n"
+            << "metadata access: " << access_us << "us\n"
+            << "resident growth: " << (static_cast<double>(rss_after) - static_cast<double>(rss_before)) / 1024
+            << "KB after construction, "
+            << (static_cast<double>(rss_access) - static_cast<double>(rss_before)) / 1024
+            << "KB after metadata access\n";
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}
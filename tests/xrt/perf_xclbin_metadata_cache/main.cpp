@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure process startup cost of extracting xclbin meta data with
+// the persistent meta data cache.  The test clears the cache and then
+// runs itself in child processes.  The first child populates the cache
+// (cold), remaining children read from the cache (warm).  Each child
+// writes the kernel meta data it extracted to a file, the meta data
+// read from the cache must match the meta data parsed by the first
+// child.
+//
+// % perf_xclbin_metadata_cache -k verify.xclbin
+#include "experimental/xrt_xclbin.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Must match Runtime.xclbin_metadata_cache_dir in xrt.ini
+static const char* cache_dir = "xrt_metadata_cache";
+
+static void
+usage()
+{
+  std::cout << "usage: perf_xclbin_metadata_cache [options]\n\n"
+            << "  -k <xclbin>\n"
+            << "  [-n <processes>] (default: 5)\n";
+}
+
+// File with the kernel meta data extracted by child process
+static std::string
+metadata_file(unsigned int idx)
+{
+  return "perf_xclbin_metadata_cache." + std::to_string(idx) + ".txt";
+}
+
+static std::string
+read_file(const std::string& fnm)
+{
+  std::ifstream stream{fnm};
+  if (!stream)
+    throw std::runtime_error("FAILED_TEST\nNo meta data from child process: " + fnm);
+  return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+// Kernel, argument, and compute unit meta data in text form
+static void
+write_metadata(const xrt::xclbin& xclbin, const std::string& fnm)
+{
+  std::ofstream ostr{fnm};
+  for (const auto& kernel : xclbin.get_kernels()) {
+    ostr << "kernel " << kernel.get_name() << ' ' << kernel.get_num_args() << '\n';
+    for (const auto& arg : kernel.get_args())
+      ostr << "  arg " << arg.get_index() << ' ' << arg.get_name() << ' '
+           << arg.get_offset() << ' ' << arg.get_size() << ' ' << arg.get_host_type() << '\n';
+    for (const auto& cu : kernel.get_cus())
+      ostr << "  cu " << cu.get_name() << ' ' << cu.get_base_address() << '\n';
+  }
+}
+
+// Time construction of xclbin and first access of kernel meta data
+static void
+child(const std::string& xclbin_fnm, unsigned int idx)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  xrt::xclbin xclbin{xclbin_fnm};
+  auto num_kernels = xclbin.get_kernels().size();
+  auto elapsed = std::chrono::high_resolution_clock::now() - start;
+  auto us = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / 1000.0;
+  std::cout << std::setw(4) << (idx ? "warm" : "cold") << ": " << num_kernels << " kernels in "
+            << std::fixed << std::setprecision(1) << us << "us" << std::endl;
+  write_metadata(xclbin, metadata_file(idx));
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  int child_idx = -1;
+  unsigned int processes = 5;
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-n")
+      processes = std::stoi(arg);
+    else if (cur == "--child")
+      child_idx = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  if (child_idx >= 0) {
+    child(xclbin_fnm, child_idx);
+    return 1; // child does not report test status
+  }
+
+  if (processes < 2)
+    throw std::runtime_error("FAILED_TEST\nAt least 2 processes required");
+
+  std::filesystem::remove_all(cache_dir);
+  for (unsigned int i = 0; i < processes; ++i) {
+    std::filesystem::remove(metadata_file(i));
+    auto cmd = std::string(argv[0]) + " -k \"" + xclbin_fnm + "\" --child " + std::to_string(i);
+    if (std::system(cmd.c_str()))
+      throw std::runtime_error("FAILED_TEST\nChild process failed: " + cmd);
+  }
+
+  if (!std::filesystem::exists(cache_dir))
+    throw std::runtime_error("FAILED_TEST\nNo cache directory, is xrt.ini in working directory?");
+
+  auto cold = read_file(metadata_file(0));
+  if (cold.empty())
+    throw std::runtime_error("FAILED_TEST\nNo kernel meta data in xclbin");
+  for (unsigned int i = 1; i < processes; ++i)
+    if (read_file(metadata_file(i)) != cold)
+      throw std::runtime_error("FAILED_TEST\nCached meta data differs from parsed meta data in child " + std::to_string(i));
+  for (unsigned int i = 0; i < processes; ++i)
+    std::filesystem::remove(metadata_file(i));
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    if (!run(argc, argv))
+      std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED for unknown reason\n";
+    return EXIT_FAILURE;
+  }
+}